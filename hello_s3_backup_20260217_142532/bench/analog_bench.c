@@ -0,0 +1,172 @@
+// Analog face cost per tick: bytes and windows sent to the panel and CPU time,
+// for the first full draw, plain second ticks, minute rollovers (hour and
+// minute hands move too), a sync-state change and a touch-style invalidation.
+// A 12 h sweep keeps a host copy of the panel and compares it against a full
+// redraw every few hundred ticks, so incremental updates must be pixel-exact.
+// Bytes and mismatches are gated against analog_baseline.txt; CPU time is
+// printed only.
+#include <stdio.h>
+#include <string.h>
+
+#include "analog_face.h"
+#include "bench_baseline.h"
+#include "bench_panel.h"
+#include "dma_arena.h"
+#include "panel_config.h"
+
+#define SWEEP_TICKS        (12 * 3600)
+#define SWEEP_CHECK_EVERY  613
+
+static uint16_t s_panel[LCD_H_RES * LCD_V_RES];
+static uint16_t s_reference[LCD_H_RES * LCD_V_RES];
+static uint16_t *s_target = s_panel;
+static uint16_t s_block[DMA_DRAW_BLOCK_BYTES / 2];
+
+static uint16_t *sink_acquire(void *ctx, size_t *capacity)
+{
+    (void)ctx;
+    *capacity = sizeof(s_block) / sizeof(s_block[0]);
+    return s_block;
+}
+
+// One window, sent in one chunk: the face sizes every band to fit a block.
+static void sink_submit(void *ctx, int x, int y, int w, int h, uint16_t *buf)
+{
+    (void)ctx;
+    for (int r = 0; r < h; r++) {
+        memcpy(&s_target[(size_t)(y + r) * LCD_H_RES + x], &buf[(size_t)r * w], (size_t)w * sizeof(uint16_t));
+    }
+    bench_panel_window_chunked(x, y, w, h, h);
+}
+
+typedef struct {
+    uint64_t ticks;
+    uint64_t payload_sum;
+    uint64_t payload_max;
+    uint64_t bus_sum;
+    uint64_t windows_max;
+    uint64_t windows_sum;
+    uint64_t ns_sum;
+} tick_stats_t;
+
+static void tick(const struct tm *ti, bool synced, tick_stats_t *st)
+{
+    bench_panel_reset();
+    uint64_t t0 = bench_now_ns();
+    analog_face_draw(ti, synced);
+    uint64_t ns = bench_now_ns() - t0;
+    if (!st) {
+        return;
+    }
+    st->ticks++;
+    st->ns_sum += ns;
+    st->payload_sum += g_bench_panel.payload_bytes;
+    st->bus_sum += g_bench_panel.bus_bytes;
+    st->windows_sum += g_bench_panel.window_setups;
+    st->payload_max = g_bench_panel.payload_bytes > st->payload_max ? g_bench_panel.payload_bytes : st->payload_max;
+    st->windows_max = g_bench_panel.window_setups > st->windows_max ? g_bench_panel.window_setups : st->windows_max;
+}
+
+static void report(const char *name, const tick_stats_t *st)
+{
+    uint64_t n = st->ticks ? st->ticks : 1;
+    printf("%-12s %6llu ticks  payload avg %6llu B max %6llu B  bus avg %6llu B  windows avg %2llu max %2llu  "
+           "%6.1f us/tick\n",
+           name, (unsigned long long)st->ticks, (unsigned long long)(st->payload_sum / n),
+           (unsigned long long)st->payload_max, (unsigned long long)(st->bus_sum / n),
+           (unsigned long long)(st->windows_sum / n), (unsigned long long)st->windows_max,
+           (double)st->ns_sum / (double)n / 1000.0);
+}
+
+static void time_at(struct tm *ti, int seconds)
+{
+    memset(ti, 0, sizeof(*ti));
+    ti->tm_hour = (seconds / 3600) % 24;
+    ti->tm_min = (seconds / 60) % 60;
+    ti->tm_sec = seconds % 60;
+}
+
+// Full redraw of the same time into the reference buffer; returns differing pixels.
+static uint64_t check_against_full(const struct tm *ti, bool synced)
+{
+    s_target = s_reference;
+    analog_face_reset();
+    analog_face_draw(ti, synced);
+    s_target = s_panel;
+
+    uint64_t diff = 0;
+    for (size_t i = 0; i < sizeof(s_panel) / sizeof(s_panel[0]); i++) {
+        diff += s_panel[i] != s_reference[i];
+    }
+    return diff;
+}
+
+int main(int argc, char **argv)
+{
+    const char *baseline;
+    const char *write_to;
+    if (!bench_parse_args(argc, argv, &baseline, &write_to)) {
+        return 2;
+    }
+
+    const analog_face_sink_t sink = {.acquire = sink_acquire, .submit = sink_submit};
+    uint64_t t0 = bench_now_ns();
+    analog_face_init(&sink);
+    printf("dial cache build %.1f ms\n", (double)(bench_now_ns() - t0) / 1e6);
+
+    struct tm ti;
+    int start = 10 * 3600 + 8 * 60;
+    time_at(&ti, start);
+    tick_stats_t full = {0};
+    tick(&ti, true, &full);
+    report("full", &full);
+
+    tick_stats_t second = {0};
+    tick_stats_t minute = {0};
+    for (int s = 1; s <= 3600; s++) {
+        time_at(&ti, start + s);
+        tick(&ti, true, ti.tm_sec == 0 ? &minute : &second);
+    }
+    report("second", &second);
+    report("minute", &minute);
+    printf("             full frame for comparison: %d B\n", LCD_H_RES * LCD_V_RES * 2);
+
+    tick_stats_t sync = {0};
+    tick(&ti, false, &sync);
+    tick(&ti, true, &sync);
+    report("sync_toggle", &sync);
+
+    // A 12x12 overlay cleared away, as the touch dot does.
+    tick_stats_t inval = {0};
+    analog_face_invalidate_rect(200, 60, 12, 12);
+    tick(&ti, true, &inval);
+    report("invalidate", &inval);
+
+    // Sweep from a fresh full draw; every tick incremental, checked against full redraws.
+    uint64_t mismatch = 0;
+    tick_stats_t sweep = {0};
+    time_at(&ti, 0);
+    analog_face_reset();
+    tick(&ti, true, NULL);
+    for (int s = 1; s <= SWEEP_TICKS; s++) {
+        time_at(&ti, s);
+        tick(&ti, true, &sweep);
+        if (s % SWEEP_CHECK_EVERY == 0 || s == SWEEP_TICKS) {
+            mismatch += check_against_full(&ti, true);
+        }
+    }
+    report("sweep_12h", &sweep);
+    printf("sweep mismatched pixels vs. full redraw: %llu\n", (unsigned long long)mismatch);
+
+    bench_metric_add("full", "payload_bytes", full.payload_sum);
+    bench_metric_add("second", "payload_avg", second.payload_sum / second.ticks);
+    bench_metric_add("second", "payload_max", second.payload_max);
+    bench_metric_add("second", "windows_max", second.windows_max);
+    bench_metric_add("minute", "payload_max", minute.payload_max);
+    bench_metric_add("sync_toggle", "payload_max", sync.payload_max);
+    bench_metric_add("invalidate", "payload_bytes", inval.payload_sum);
+    bench_metric_add("sweep_12h", "payload_max", sweep.payload_max);
+    bench_metric_add("sweep_12h", "mismatch_pixels", mismatch);
+
+    return bench_baseline_finish("analog_bench", baseline, write_to);
+}
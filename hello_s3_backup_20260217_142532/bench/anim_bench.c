@@ -0,0 +1,221 @@
+// Digit transitions on a simulated clock. Time only moves when the model says
+// so: frame rendering costs cpu_ns_per_px per pixel and every window occupies
+// the bus for its bytes at bus_bytes_per_s, so budget decisions, drops and
+// fps are deterministic. Each scenario runs one scene per second (drawn a
+// little after the edge, as the clock task delivers it) and calls
+// clock_face_animate() whenever it asks to be woken, late by up to
+// wake_jitter_us. Every few seconds the panel after the scene draw is compared
+// with a full redraw of the new time; landings must be pixel-exact and on time.
+#include <stdio.h>
+#include <string.h>
+
+#include "bench_baseline.h"
+#include "bench_panel.h"
+#include "clock_face.h"
+#include "dma_arena.h"
+#include "panel_config.h"
+
+#define SCENE_DELAY_US 2000   // clock task guard after the edge
+#define CHECK_EVERY    97
+
+typedef struct {
+    const char *name;
+    clock_anim_style_t style;
+    int start;                  // second of the day
+    int seconds;
+    uint32_t bus_bytes_per_s;
+    uint32_t cpu_ns_per_px;
+    uint32_t wake_jitter_us;
+} scenario_t;
+
+static uint16_t s_panel[LCD_H_RES * LCD_V_RES];
+static uint16_t s_reference[LCD_H_RES * LCD_V_RES];
+static uint16_t *s_target = s_panel;
+static uint16_t s_block[DMA_DRAW_BLOCK_BYTES / 2];
+
+static int64_t s_now_us;
+static int64_t s_bus_free_us;
+static const scenario_t *s_sc;
+static uint32_t s_rng = 1;
+
+static void bus_send(int w, int h)
+{
+    int64_t start = s_bus_free_us > s_now_us ? s_bus_free_us : s_now_us;
+    s_bus_free_us = start + (int64_t)w * h * 2 * 1000000 / s_sc->bus_bytes_per_s;
+}
+
+static void fill(int x, int y, int w, int h, uint16_t color)
+{
+    for (int r = y; r < y + h; r++) {
+        for (int c = x; c < x + w; c++) {
+            s_target[r * LCD_H_RES + c] = color;
+        }
+    }
+    bench_panel_fill(x, y, w, h, color);
+    bus_send(w, h);
+}
+
+static uint16_t *sink_acquire(void *ctx, size_t *capacity)
+{
+    (void)ctx;
+    *capacity = sizeof(s_block) / sizeof(s_block[0]);
+    return s_block;
+}
+
+static void sink_submit(void *ctx, int x, int y, int w, int h, uint16_t *buf)
+{
+    (void)ctx;
+    for (int r = 0; r < h; r++) {
+        memcpy(&s_target[(y + r) * LCD_H_RES + x], &buf[r * w], (size_t)w * sizeof(uint16_t));
+    }
+    bench_panel_window_chunked(x, y, w, h, h);
+    s_now_us += (int64_t)w * h * s_sc->cpu_ns_per_px / 1000;
+    bus_send(w, h);
+}
+
+static bool sink_busy(void *ctx)
+{
+    (void)ctx;
+    return s_now_us < s_bus_free_us;
+}
+
+static int64_t sink_now_us(void *ctx)
+{
+    (void)ctx;
+    return s_now_us;
+}
+
+static struct tm time_at(int seconds)
+{
+    struct tm ti;
+    memset(&ti, 0, sizeof(ti));
+    seconds %= 86400;
+    ti.tm_hour = seconds / 3600;
+    ti.tm_min = (seconds / 60) % 60;
+    ti.tm_sec = seconds % 60;
+    return ti;
+}
+
+// Panel vs. a full redraw of ti; the face continues from that redraw.
+static uint64_t check_against_full(const struct tm *ti)
+{
+    s_target = s_reference;
+    clock_face_reset();
+    clock_face_draw(ti, true);
+    s_target = s_panel;
+
+    uint64_t diff = 0;
+    for (size_t i = 0; i < sizeof(s_panel) / sizeof(s_panel[0]); i++) {
+        diff += s_panel[i] != s_reference[i];
+    }
+    return diff;
+}
+
+static void run(const scenario_t *sc)
+{
+    s_sc = sc;
+    s_now_us = 0;
+    s_bus_free_us = 0;
+    s_rng = 1;
+
+    const clock_anim_sink_t sink = {
+        .acquire = sink_acquire,
+        .submit = sink_submit,
+        .busy = sink_busy,
+        .now_us = sink_now_us,
+    };
+    const clock_anim_config_t cfg = {
+        .style = sc->style,
+        .duration_ms = CLOCK_ANIM_DURATION_MS,
+        .fps = CLOCK_ANIM_FPS,
+        .frame_cpu_us = CLOCK_ANIM_FRAME_CPU_US,
+        .frame_bus_bytes = CLOCK_ANIM_FRAME_BUS_BYTES,
+    };
+    clock_face_set_anim(&sink, &cfg);
+
+    struct tm ti = time_at(sc->start);
+    clock_face_reset();
+    clock_face_draw(&ti, true);
+
+    uint64_t mismatch = 0;
+    uint64_t edge_draw_bytes = 0;
+    int64_t late_max_us = 0;
+    for (int s = 0; s < sc->seconds; s++) {
+        int64_t edge_us = (int64_t)(s + 1) * 1000000;
+        bench_panel_reset();
+        for (int64_t wake = clock_face_animate(&ti, s_now_us, edge_us); wake != 0;
+             wake = clock_face_animate(&ti, s_now_us, edge_us)) {
+            s_rng = s_rng * 1103515245u + 12345u;
+            int64_t at = wake + (sc->wake_jitter_us ? (s_rng >> 8) % sc->wake_jitter_us : 0);
+            if (at > s_now_us) {
+                s_now_us = at;
+            }
+        }
+        if (s_now_us - edge_us > late_max_us) {
+            late_max_us = s_now_us - edge_us;
+        }
+
+        ti = time_at(sc->start + s + 1);
+        if (s_now_us < edge_us + SCENE_DELAY_US) {
+            s_now_us = edge_us + SCENE_DELAY_US;
+        }
+        // After a landing the scene draw has nothing left to send; edges that were not animated
+        // go out here as segment updates.
+        bench_panel_reset();
+        clock_face_draw(&ti, true);
+        edge_draw_bytes += g_bench_panel.payload_bytes;
+        if (s % CHECK_EVERY == 0 || s == sc->seconds - 1) {
+            mismatch += check_against_full(&ti);
+        }
+    }
+
+    clock_anim_stats_t st;
+    clock_face_get_anim_stats(&st);
+    uint32_t n = st.transitions ? st.transitions : 1;
+    uint32_t fps10 = (uint32_t)((uint64_t)st.frames * 10000 / ((uint64_t)n * CLOCK_ANIM_DURATION_MS));
+    printf("%-12s %5u transitions %4u simplified  %5.1f fps  %5u dropped  %6llu B/transition  "
+           "cpu avg %4llu us max %5u us  landing late max %5lld us  mismatch %llu\n",
+           sc->name, (unsigned)st.transitions, (unsigned)st.simplified, fps10 / 10.0, (unsigned)st.dropped,
+           (unsigned long long)(st.bytes / n), (unsigned long long)(st.frames ? st.cpu_us / st.frames : 0),
+           (unsigned)st.cpu_us_max, (long long)late_max_us, (unsigned long long)mismatch);
+
+    bench_metric_add(sc->name, "bytes_per_transition", st.bytes / n);
+    bench_metric_add(sc->name, "dropped", st.dropped);
+    bench_metric_add(sc->name, "simplified", st.simplified);
+    bench_metric_add(sc->name, "landing_late_us", (uint64_t)late_max_us);
+    bench_metric_add(sc->name, "edge_draw_bytes", edge_draw_bytes);
+    bench_metric_add(sc->name, "mismatch_pixels", mismatch);
+}
+
+int main(int argc, char **argv)
+{
+    const char *baseline;
+    const char *write_to;
+    if (!bench_parse_args(argc, argv, &baseline, &write_to)) {
+        return 2;
+    }
+
+    clock_face_init(fill);
+
+    const int morning = 10 * 3600 + 8 * 60;
+    const scenario_t scenarios[] = {
+        // One hour per style on the nominal bus (20 MHz QSPI) and CPU.
+        {"fade", CLOCK_ANIM_FADE, morning, 3600, 10000000, 40, 0},
+        {"morph", CLOCK_ANIM_MORPH, morning, 3600, 10000000, 40, 0},
+        {"slide", CLOCK_ANIM_SLIDE, morning, 3600, 10000000, 40, 0},
+        // Wake-ups a tick late, as with a 100 Hz FreeRTOS tick.
+        {"jitter", CLOCK_ANIM_SLIDE, morning, 3600, 10000000, 40, 10000},
+        // Hour and day rollovers: every digit changes and slides no longer fit the bus budget.
+        {"rollover", CLOCK_ANIM_SLIDE, 9 * 3600 + 59 * 60 + 30, 60, 10000000, 40, 0},
+        {"midnight", CLOCK_ANIM_SLIDE, 23 * 3600 + 59 * 60 + 30, 60, 10000000, 40, 0},
+        // A bus at a twentieth of the speed: frames still on the bus when the next slot comes.
+        {"slow_bus", CLOCK_ANIM_SLIDE, morning, 600, 500000, 40, 0},
+        // Rendering 50x slower than expected: over the CPU budget until the estimate catches up.
+        {"slow_cpu", CLOCK_ANIM_SLIDE, morning, 600, 10000000, 2000, 0},
+    };
+    for (size_t i = 0; i < sizeof(scenarios) / sizeof(scenarios[0]); i++) {
+        run(&scenarios[i]);
+    }
+
+    return bench_baseline_finish("anim_bench", baseline, write_to);
+}
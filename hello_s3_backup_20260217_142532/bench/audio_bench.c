@@ -0,0 +1,479 @@
+// Clap/voice detector accuracy and cost. Built-in scenarios synthesize labelled
+// 16 kHz clips (claps, double claps, voiced speech, alert beeps with playback
+// flagged, thumps, hum and a fan switching on) and run them through
+// main/audio_detect.c frame by frame. Misses and false alarms are gated
+// against audio_baseline.txt; per-frame CPU time is printed only.
+//
+// Recordings can be checked the same way:
+//   audio_bench --wav clip.wav [--wav ...]
+// 16 kHz PCM16 (first channel is used). An optional clip.wav.labels next to it
+// lists expected events, one per line: "clap 1.20", "double_clap 3.5",
+// "voice 6.0", and speaker time as "playback 2.0 2.15" (seconds).
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "audio_detect.h"
+#include "bench_baseline.h"
+#include "bench_panel.h"
+
+#define FS            AUDIO_DETECT_RATE_HZ
+#define MAX_LABELS    64
+#define MAX_SPANS     32
+#define MAX_WAVS      16
+#define MATCH_EARLY_MS 50     // detection may land this much before the label
+#define MATCH_LATE_MS  1200   // single claps wait out the double-clap window
+
+typedef struct {
+    audio_event_t type;
+    int t_ms;
+} label_t;
+
+typedef struct {
+    int start_ms;
+    int end_ms;
+} span_t;
+
+typedef struct {
+    const char *name;
+    float *buf;
+    int16_t *pcm;
+    size_t n;
+    label_t labels[MAX_LABELS];
+    int label_count;
+    span_t playback[MAX_SPANS];
+    int playback_count;
+} clip_t;
+
+typedef struct {
+    int expected;
+    int hits;
+    int missed;
+    int false_alarms;
+    uint64_t frames;
+    uint64_t ns;
+} score_t;
+
+static uint32_t s_rng = 0x2545F491u;
+
+static float frand(void)
+{
+    s_rng = s_rng * 1664525u + 1013904223u;
+    return (float)(s_rng >> 8) / 16777216.0f * 2.0f - 1.0f;
+}
+
+static float gauss(void)
+{
+    return (frand() + frand() + frand() + frand()) * 0.866f;   // unit variance, roughly
+}
+
+static void clip_init(clip_t *c, const char *name, int duration_ms)
+{
+    memset(c, 0, sizeof(*c));
+    c->name = name;
+    c->n = (size_t)duration_ms * FS / 1000;
+    c->buf = calloc(c->n, sizeof(float));
+    c->pcm = calloc(c->n, sizeof(int16_t));
+}
+
+static void clip_free(clip_t *c)
+{
+    free(c->buf);
+    free(c->pcm);
+}
+
+static void clip_label(clip_t *c, audio_event_t type, int t_ms)
+{
+    if (c->label_count < MAX_LABELS) {
+        c->labels[c->label_count++] = (label_t){type, t_ms};
+    }
+}
+
+static size_t at(int t_ms)
+{
+    return (size_t)t_ms * FS / 1000;
+}
+
+static void add_noise(clip_t *c, int from_ms, float rms)
+{
+    for (size_t i = at(from_ms); i < c->n; i++) {
+        c->buf[i] += gauss() * rms;
+    }
+}
+
+static void add_hum(clip_t *c, float amp)
+{
+    for (size_t i = 0; i < c->n; i++) {
+        c->buf[i] += amp * sinf(2.0f * (float)M_PI * 50.0f * (float)i / FS);
+    }
+}
+
+// Decaying noise burst; lowpass softens it the way a cupped-hand clap sounds.
+static void add_clap(clip_t *c, int t_ms, float peak, bool lowpass)
+{
+    float lp = 0.0f;
+    size_t start = at(t_ms);
+    for (size_t k = 0; k < at(80) && start + k < c->n; k++) {
+        float t = (float)k / FS;
+        float env = expf(-t / 0.010f) * (k < 16 ? (float)k / 16.0f : 1.0f);
+        float s = frand();
+        lp += 0.45f * (s - lp);
+        c->buf[start + k] += peak * env * (lowpass ? lp * 2.0f : s);
+    }
+    clip_label(c, AUDIO_EV_CLAP, t_ms);
+}
+
+static void add_double_clap(clip_t *c, int t_ms, int gap_ms, float peak)
+{
+    add_clap(c, t_ms, peak, false);
+    add_clap(c, t_ms + gap_ms, peak * 0.8f, true);
+    c->label_count -= 2;
+    clip_label(c, AUDIO_EV_DOUBLE_CLAP, t_ms);
+}
+
+static void add_thump(clip_t *c, int t_ms, float peak)
+{
+    size_t start = at(t_ms);
+    for (size_t k = 0; k < at(250) && start + k < c->n; k++) {
+        float t = (float)k / FS;
+        c->buf[start + k] += peak * expf(-t / 0.040f) * sinf(2.0f * (float)M_PI * 80.0f * t);
+    }
+}
+
+static float resonate(float x, float *y1, float *y2, float f, float bw)
+{
+    float r = expf(-(float)M_PI * bw / FS);
+    float y = x + 2.0f * r * cosf(2.0f * (float)M_PI * f / FS) * *y1 - r * r * *y2;
+    *y2 = *y1;
+    *y1 = y;
+    return y;
+}
+
+// Voiced syllables: glottal pulse train through two formant resonators under a
+// sin^2 envelope, separated by short gaps.
+static void add_voice(clip_t *c, int t_ms, int syllables, float f0, float rms)
+{
+    static const float formants[][2] = {{730, 1090}, {530, 1840}, {300, 2290}, {570, 840}, {660, 1720}};
+    int t = t_ms;
+    for (int s = 0; s < syllables; s++) {
+        int dur_ms = 160 + (s * 37) % 90;
+        size_t len = at(dur_ms);
+        float *tmp = calloc(len, sizeof(float));
+        float a1 = 0, a2 = 0, b1 = 0, b2 = 0, phase = 0, sum = 0;
+        const float *fm = formants[(s + syllables) % 5];
+        for (size_t k = 0; k < len; k++) {
+            float pitch = f0 * (1.0f + 0.08f * sinf((float)k / (float)len * 3.0f));
+            phase += pitch / FS;
+            float pulse = 0.0f;
+            if (phase >= 1.0f) {
+                phase -= 1.0f;
+                pulse = 1.0f;
+            }
+            float v = resonate(pulse, &a1, &a2, fm[0], 90) + 0.5f * resonate(pulse, &b1, &b2, fm[1], 120);
+            float env = sinf((float)M_PI * (float)k / (float)len);
+            tmp[k] = v * env * env;
+            sum += tmp[k] * tmp[k];
+        }
+        float scale = rms / sqrtf(sum / (float)len + 1e-9f) * 0.75f;
+        for (size_t k = 0; k < len && at(t) + k < c->n; k++) {
+            c->buf[at(t) + k] += tmp[k] * scale;
+        }
+        free(tmp);
+        t += dur_ms + 60;
+    }
+    clip_label(c, AUDIO_EV_VOICE, t_ms);
+}
+
+// Alert chirp picked up from the speaker, flagged as playback the way the firmware does.
+static void add_beep(clip_t *c, int t_ms, int dur_ms, float amp)
+{
+    uint32_t period = FS / 1040;
+    for (size_t k = 0; k < at(dur_ms) && at(t_ms) + k < c->n; k++) {
+        c->buf[at(t_ms) + k] += ((k % period) < period / 2) ? amp : -amp;
+    }
+    if (c->playback_count < MAX_SPANS) {
+        c->playback[c->playback_count++] = (span_t){t_ms, t_ms + dur_ms};
+    }
+}
+
+static void clip_quantize(clip_t *c)
+{
+    for (size_t i = 0; i < c->n; i++) {
+        float v = c->buf[i];
+        c->pcm[i] = (int16_t)(v > 32767.0f ? 32767 : (v < -32768.0f ? -32768 : lrintf(v)));
+    }
+}
+
+static bool in_playback(const clip_t *c, int t_ms)
+{
+    for (int i = 0; i < c->playback_count; i++) {
+        if (t_ms >= c->playback[i].start_ms && t_ms < c->playback[i].end_ms) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void run_clip(const clip_t *c, score_t *sc, bool verbose)
+{
+    audio_detect_t d;
+    audio_detect_init(&d);
+    bool matched[MAX_LABELS] = {false};
+    memset(sc, 0, sizeof(*sc));
+    sc->expected = c->label_count;
+
+    for (size_t off = 0; off + AUDIO_DETECT_FRAME <= c->n; off += AUDIO_DETECT_FRAME) {
+        int t_ms = (int)((off + AUDIO_DETECT_FRAME) * 1000 / FS);
+        audio_detect_set_playback(&d, in_playback(c, (int)(off * 1000 / FS)));
+        uint64_t t0 = bench_now_ns();
+        audio_event_t ev = audio_detect_frame(&d, &c->pcm[off]);
+        sc->ns += bench_now_ns() - t0;
+        sc->frames++;
+        if (ev == AUDIO_EV_NONE) {
+            continue;
+        }
+
+        bool hit = false;
+        for (int i = 0; i < c->label_count && !hit; i++) {
+            const label_t *l = &c->labels[i];
+            if (!matched[i] && l->type == ev && t_ms >= l->t_ms - MATCH_EARLY_MS && t_ms <= l->t_ms + MATCH_LATE_MS) {
+                matched[i] = hit = true;
+            }
+        }
+        sc->hits += hit;
+        sc->false_alarms += !hit;
+        if (verbose || !hit) {
+            printf("    %6.2f s  %-11s%s\n", t_ms / 1000.0, audio_event_name(ev), hit ? "" : "  (false alarm)");
+        }
+    }
+    for (int i = 0; i < c->label_count; i++) {
+        if (!matched[i]) {
+            sc->missed++;
+            printf("    %6.2f s  %-11s  (missed)\n", c->labels[i].t_ms / 1000.0, audio_event_name(c->labels[i].type));
+        }
+    }
+}
+
+static void print_score(const char *name, const score_t *sc)
+{
+    printf("%-14s %2d expected  %2d hit  %2d missed  %2d false   %5.0f ns/frame (%.3f%% of a frame)\n",
+           name, sc->expected, sc->hits, sc->missed, sc->false_alarms,
+           (double)sc->ns / (double)(sc->frames ? sc->frames : 1),
+           (double)sc->ns / (double)(sc->frames ? sc->frames : 1) / (AUDIO_DETECT_FRAME * 1e9 / FS) * 100.0);
+}
+
+static void scenario_claps(clip_t *c)
+{
+    clip_init(c, "claps", 14000);
+    add_noise(c, 0, 60);
+    const float peaks[] = {9000, 24000, 14000, 30000, 11000, 20000};
+    for (int i = 0; i < 6; i++) {
+        add_clap(c, 1000 + i * 2000, peaks[i], i & 1);
+    }
+}
+
+static void scenario_double(clip_t *c)
+{
+    clip_init(c, "double_claps", 13000);
+    add_noise(c, 0, 60);
+    const int gaps[] = {250, 300, 200, 380};
+    for (int i = 0; i < 4; i++) {
+        add_double_clap(c, 1000 + i * 3000, gaps[i], 14000.0f + 4000.0f * (float)i);
+    }
+}
+
+static void scenario_voice(clip_t *c)
+{
+    clip_init(c, "voice", 14000);
+    add_noise(c, 0, 60);
+    add_hum(c, 300);
+    add_voice(c, 1000, 4, 120, 2500);
+    add_voice(c, 5000, 3, 210, 900);
+    add_voice(c, 9000, 5, 160, 4000);
+}
+
+static void scenario_playback(clip_t *c)
+{
+    clip_init(c, "playback", 13000);
+    add_noise(c, 0, 60);
+    for (int t = 500; t < 12000; t += 2000) {
+        add_beep(c, t, 150, 1000);
+    }
+    add_clap(c, 1500, 16000, false);
+    add_clap(c, 4550, 26000, false);
+    add_clap(c, 8600, 22000, true);
+    add_clap(c, 11300, 12000, true);
+}
+
+static void scenario_distractors(clip_t *c)
+{
+    clip_init(c, "distractors", 14000);
+    add_noise(c, 0, 60);
+    add_hum(c, 400);
+    add_thump(c, 1000, 20000);
+    add_thump(c, 3000, 28000);
+    add_noise(c, 5000, 400);          // fan switches on and stays on
+    add_thump(c, 9000, 25000);
+}
+
+static void scenario_mixed(clip_t *c)
+{
+    clip_init(c, "mixed", 14000);
+    add_noise(c, 0, 100);
+    add_voice(c, 1000, 3, 140, 2000);
+    add_clap(c, 4200, 18000, true);
+    add_voice(c, 6000, 4, 190, 3000);
+    add_double_clap(c, 9500, 280, 20000);
+    add_beep(c, 12000, 150, 1000);
+}
+
+static bool wav_load(const char *path, clip_t *c)
+{
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        perror(path);
+        return false;
+    }
+    uint8_t hdr[12];
+    uint16_t channels = 0;
+    uint16_t bits = 0;
+    uint32_t rate = 0;
+    bool ok = fread(hdr, 1, 12, f) == 12 && memcmp(hdr, "RIFF", 4) == 0 && memcmp(hdr + 8, "WAVE", 4) == 0;
+    while (ok) {
+        uint8_t ch[8];
+        if (fread(ch, 1, 8, f) != 8) {
+            ok = false;
+            break;
+        }
+        uint32_t size = (uint32_t)ch[4] | (uint32_t)ch[5] << 8 | (uint32_t)ch[6] << 16 | (uint32_t)ch[7] << 24;
+        if (memcmp(ch, "fmt ", 4) == 0 && size >= 16) {
+            uint8_t fmt[16];
+            ok = fread(fmt, 1, 16, f) == 16 && fseek(f, (long)(size - 16 + (size & 1)), SEEK_CUR) == 0;
+            channels = (uint16_t)(fmt[2] | fmt[3] << 8);
+            rate = (uint32_t)fmt[4] | (uint32_t)fmt[5] << 8 | (uint32_t)fmt[6] << 16 | (uint32_t)fmt[7] << 24;
+            bits = (uint16_t)(fmt[14] | fmt[15] << 8);
+            ok = ok && fmt[0] == 1 && fmt[1] == 0;    // PCM
+        } else if (memcmp(ch, "data", 4) == 0) {
+            if (channels == 0 || bits != 16 || rate != FS) {
+                fprintf(stderr, "%s: need 16-bit PCM at %d Hz (got %u-bit, %u Hz)\n", path, FS, bits, (unsigned)rate);
+                ok = false;
+                break;
+            }
+            size_t frames = size / (2U * channels);
+            c->name = path;
+            c->n = frames;
+            c->pcm = malloc(frames * sizeof(int16_t));
+            int16_t *raw = malloc(size);
+            ok = c->pcm && raw && fread(raw, 1, size, f) == size;
+            for (size_t i = 0; ok && i < frames; i++) {
+                c->pcm[i] = raw[i * channels];
+            }
+            free(raw);
+            break;
+        } else {
+            ok = fseek(f, (long)(size + (size & 1)), SEEK_CUR) == 0;
+        }
+    }
+    fclose(f);
+    if (!ok) {
+        fprintf(stderr, "%s: not a usable WAV file\n", path);
+    }
+    return ok;
+}
+
+// Returns false when there is no labels file.
+static bool wav_labels(const char *path, clip_t *c)
+{
+    char name[512];
+    snprintf(name, sizeof(name), "%s.labels", path);
+    FILE *f = fopen(name, "r");
+    if (!f) {
+        return false;
+    }
+    char line[128];
+    while (fgets(line, sizeof(line), f)) {
+        char kind[32];
+        double a = 0;
+        double b = 0;
+        int n = sscanf(line, "%31s %lf %lf", kind, &a, &b);
+        if (n >= 2 && strcmp(kind, "playback") == 0 && n == 3 && c->playback_count < MAX_SPANS) {
+            c->playback[c->playback_count++] = (span_t){(int)(a * 1000), (int)(b * 1000)};
+        } else if (n >= 2) {
+            for (audio_event_t ev = AUDIO_EV_CLAP; ev <= AUDIO_EV_VOICE; ev++) {
+                if (strcmp(kind, audio_event_name(ev)) == 0) {
+                    clip_label(c, ev, (int)(a * 1000));
+                }
+            }
+        }
+    }
+    fclose(f);
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    // --wav FILE is ours; everything else goes to bench_parse_args.
+    const char *wavs[MAX_WAVS];
+    int wav_count = 0;
+    char *rest[64];
+    int rest_count = 0;
+    for (int i = 0; i < argc && rest_count < 64; i++) {
+        if (i > 0 && strcmp(argv[i], "--wav") == 0 && i + 1 < argc && wav_count < MAX_WAVS) {
+            wavs[wav_count++] = argv[++i];
+        } else {
+            rest[rest_count++] = argv[i];
+        }
+    }
+    const char *baseline;
+    const char *write_to;
+    if (!bench_parse_args(rest_count, rest, &baseline, &write_to)) {
+        fprintf(stderr, "       [--wav FILE]...\n");
+        return 2;
+    }
+
+    if (wav_count > 0) {
+        for (int i = 0; i < wav_count; i++) {
+            clip_t c;
+            memset(&c, 0, sizeof(c));
+            if (!wav_load(wavs[i], &c)) {
+                return 2;
+            }
+            bool labelled = wav_labels(wavs[i], &c);
+            printf("%s (%.1f s%s)\n", wavs[i], (double)c.n / FS, labelled ? "" : ", no labels");
+            score_t sc;
+            run_clip(&c, &sc, true);
+            print_score(labelled ? "  result" : "  unlabelled", &sc);
+            clip_free(&c);
+        }
+        return 0;
+    }
+
+    void (*const scenarios[])(clip_t *) = {
+        scenario_claps, scenario_double, scenario_voice, scenario_playback, scenario_distractors, scenario_mixed,
+    };
+    score_t total = {0};
+    for (size_t i = 0; i < sizeof(scenarios) / sizeof(scenarios[0]); i++) {
+        clip_t c;
+        scenarios[i](&c);
+        clip_quantize(&c);
+        score_t sc;
+        run_clip(&c, &sc, false);
+        print_score(c.name, &sc);
+        bench_metric_add(c.name, "missed", (uint64_t)sc.missed);
+        bench_metric_add(c.name, "false_alarms", (uint64_t)sc.false_alarms);
+        total.expected += sc.expected;
+        total.hits += sc.hits;
+        total.missed += sc.missed;
+        total.false_alarms += sc.false_alarms;
+        total.frames += sc.frames;
+        total.ns += sc.ns;
+        clip_free(&c);
+    }
+    print_score("total", &total);
+    printf("detector state %zu B\n", sizeof(audio_detect_t));
+    bench_metric_add("detector", "state_bytes", sizeof(audio_detect_t));
+
+    return bench_baseline_finish("audio_bench", baseline, write_to);
+}
@@ -0,0 +1,119 @@
+#include "bench_baseline.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define BENCH_MAX_METRICS 128
+#define BENCH_KEY_LEN     96
+
+typedef struct {
+    char key[BENCH_KEY_LEN];
+    uint64_t value;
+    bool matched;   // a baseline line named it
+} bench_metric_t;
+
+static bench_metric_t s_metrics[BENCH_MAX_METRICS];
+static int s_metric_count = 0;
+
+void bench_metric_add(const char *scenario, const char *metric, uint64_t value)
+{
+    if (s_metric_count >= BENCH_MAX_METRICS) {
+        fprintf(stderr, "too many metrics, raise BENCH_MAX_METRICS\n");
+        return;
+    }
+    bench_metric_t *m = &s_metrics[s_metric_count++];
+    snprintf(m->key, sizeof(m->key), "%s.%s", scenario, metric);
+    m->value = value;
+    m->matched = false;
+}
+
+bool bench_parse_args(int argc, char **argv, const char **baseline, const char **write_to)
+{
+    *baseline = NULL;
+    *write_to = NULL;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--baseline") == 0 && i + 1 < argc) {
+            *baseline = argv[++i];
+        } else if (strcmp(argv[i], "--write-baseline") == 0 && i + 1 < argc) {
+            *write_to = argv[++i];
+        } else {
+            fprintf(stderr, "usage: %s [--baseline FILE] [--write-baseline FILE]\n", argv[0]);
+            return false;
+        }
+    }
+    return true;
+}
+
+static int write_baseline(const char *tool, const char *path)
+{
+    FILE *f = fopen(path, "w");
+    if (!f) {
+        perror(path);
+        return 2;
+    }
+    fprintf(f, "# Generated by %s --write-baseline; lower is better.\n", tool);
+    for (int i = 0; i < s_metric_count; i++) {
+        fprintf(f, "%s %llu\n", s_metrics[i].key, (unsigned long long)s_metrics[i].value);
+    }
+    fclose(f);
+    return 0;
+}
+
+static int check_baseline(const char *path)
+{
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        perror(path);
+        return 2;
+    }
+
+    int failures = 0;
+    char line[256];
+    while (fgets(line, sizeof(line), f)) {
+        char key[BENCH_KEY_LEN];
+        unsigned long long expected = 0;
+        if (line[0] == '#' || sscanf(line, "%95s %llu", key, &expected) != 2) {
+            continue;
+        }
+        bool found = false;
+        for (int i = 0; i < s_metric_count; i++) {
+            if (strcmp(s_metrics[i].key, key) != 0) {
+                continue;
+            }
+            found = true;
+            s_metrics[i].matched = true;
+            uint64_t actual = s_metrics[i].value;
+            if (actual > expected) {
+                fprintf(stderr, "REGRESSION %s: %llu > baseline %llu\n",
+                        key, (unsigned long long)actual, expected);
+                failures++;
+            } else if (actual < expected) {
+                printf("improved %s: %llu < baseline %llu (refresh with --write-baseline)\n",
+                       key, (unsigned long long)actual, expected);
+            }
+        }
+        if (!found) {
+            fprintf(stderr, "MISSING %s: in the baseline but no longer measured\n", key);
+            failures++;
+        }
+    }
+    fclose(f);
+
+    // A renamed or new metric would otherwise go unchecked.
+    for (int i = 0; i < s_metric_count; i++) {
+        if (!s_metrics[i].matched) {
+            fprintf(stderr, "UNBASELINED %s: %llu has no baseline entry (refresh with --write-baseline)\n",
+                    s_metrics[i].key, (unsigned long long)s_metrics[i].value);
+            failures++;
+        }
+    }
+    return failures ? 1 : 0;
+}
+
+int bench_baseline_finish(const char *tool, const char *baseline, const char *write_to)
+{
+    if (write_to) {
+        return write_baseline(tool, write_to);
+    }
+    return baseline ? check_baseline(baseline) : 0;
+}
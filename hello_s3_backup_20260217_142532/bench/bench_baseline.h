@@ -0,0 +1,17 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Deterministic "scenario.metric value" results shared by the host benches.
+// --baseline FILE fails (exit 1) when any recorded metric exceeds the stored
+// value, or when a metric and the file's entries do not match up one to one;
+// --write-baseline FILE refreshes it. Lower is always better.
+
+void bench_metric_add(const char *scenario, const char *metric, uint64_t value);
+
+// Parses --baseline / --write-baseline; prints usage and returns false on anything else.
+bool bench_parse_args(int argc, char **argv, const char **baseline, const char **write_to);
+
+// Writes or checks the recorded metrics; returns the process exit code.
+int bench_baseline_finish(const char *tool, const char *baseline, const char *write_to);
@@ -0,0 +1,71 @@
+#define _POSIX_C_SOURCE 199309L
+
+#include "bench_panel.h"
+
+#include <string.h>
+#include <time.h>
+
+#include "dma_arena.h"
+#include "panel_config.h"
+
+bench_panel_counters_t g_bench_panel;
+
+void bench_panel_reset(void)
+{
+    memset(&g_bench_panel, 0, sizeof(g_bench_panel));
+}
+
+void bench_panel_window(int x, int y, int w, int h)
+{
+    bench_panel_window_chunked(x, y, w, h, DRAW_CHUNK_ROWS);
+}
+
+void bench_panel_window_chunked(int x, int y, int w, int h, int chunk_rows)
+{
+    if (x < 0) {
+        w += x;
+        x = 0;
+    }
+    if (y < 0) {
+        h += y;
+        y = 0;
+    }
+    if (x + w > LCD_H_RES) {
+        w = LCD_H_RES - x;
+    }
+    if (y + h > LCD_V_RES) {
+        h = LCD_V_RES - y;
+    }
+    if (w <= 0 || h <= 0) {
+        return;
+    }
+
+    int remain = h;
+    while (remain > 0) {
+        int rows = (remain > chunk_rows) ? chunk_rows : remain;
+        uint64_t payload = (uint64_t)w * (uint64_t)rows * 2U;
+        g_bench_panel.transactions += 3;
+        g_bench_panel.window_setups += 1;
+        g_bench_panel.payload_bytes += payload;
+        g_bench_panel.bus_bytes += payload + BENCH_WINDOW_PARAM_BYTES + 3U * BENCH_QSPI_HEADER_BYTES;
+        remain -= rows;
+    }
+}
+
+void bench_panel_fill(int x, int y, int w, int h, uint16_t color)
+{
+    (void)color;
+    bench_panel_window(x, y, w, h);
+}
+
+void bench_panel_blit(int x, int y, int w, int h)
+{
+    bench_panel_window_chunked(x, y, w, h, dma_draw_band_rows(w < LCD_H_RES ? w : LCD_H_RES));
+}
+
+uint64_t bench_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <stdint.h>
+
+// Counting stand-in for the ST77916 QSPI panel. It mirrors how main.c turns a
+// fill into DMA chunks (DRAW_CHUNK_ROWS rows each) and how the panel driver
+// sends every chunk: CASET and RASET parameter writes, then RAMWR with pixels.
+typedef struct {
+    uint64_t transactions;
+    uint64_t window_setups;
+    uint64_t payload_bytes;
+    uint64_t bus_bytes;
+} bench_panel_counters_t;
+
+#define BENCH_QSPI_HEADER_BYTES 4   // 8-bit opcode + 24-bit command address per transaction
+#define BENCH_WINDOW_PARAM_BYTES 8  // CASET + RASET, 4 bytes each
+
+extern bench_panel_counters_t g_bench_panel;
+
+void bench_panel_reset(void);
+
+// Accounts one window of w*h pixels split into DMA chunks like lcd_fill_rect().
+void bench_panel_window(int x, int y, int w, int h);
+
+// Same, with chunk_rows rows per DMA chunk.
+void bench_panel_window_chunked(int x, int y, int w, int h, int chunk_rows);
+
+// Accounts an image blit like lcd_blit(): one chunk per arena-block-sized row band.
+void bench_panel_blit(int x, int y, int w, int h);
+
+// Drop-in for the firmware's lcd_fill_rect() (clipped, colour ignored).
+void bench_panel_fill(int x, int y, int w, int h, uint16_t color);
+
+uint64_t bench_now_ns(void);
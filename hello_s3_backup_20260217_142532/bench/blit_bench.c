@@ -0,0 +1,176 @@
+// Compares drawing pre-swapped images the way the firmware does (lcd_blit():
+// row bands copied from mapped flash into arena blocks) against drawing the
+// same area with fills: one solid fill, and the per-run fills needed to
+// reproduce the actual content without assets. Bus metrics come from the
+// counting panel and are gated against blit_baseline.txt; host copy/fill
+// throughput and the estimated panel throughput are printed only.
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bench_baseline.h"
+#include "bench_panel.h"
+#include "dma_arena.h"
+#include "panel_config.h"
+
+// Panel link model for the estimate: 20 MHz QSPI moves a byte every 2 clocks,
+// plus a fixed software/CS cost per transaction measured on the target.
+#define BENCH_QSPI_HZ          20000000.0
+#define BENCH_TXN_OVERHEAD_US  6.0
+#define BENCH_CPU_REPS         200
+
+typedef struct {
+    const char *name;
+    int w;
+    int h;
+    uint16_t *pixels;   // stands in for the mapped asset
+} image_t;
+
+typedef enum {
+    METHOD_BLIT,
+    METHOD_SOLID,
+    METHOD_RUNS,
+    METHOD_COUNT,
+} method_t;
+
+static const char *k_method_names[METHOD_COUNT] = {"blit", "solid_fill", "run_fills"};
+
+static uint16_t s_block[DMA_DRAW_BLOCK_BYTES / sizeof(uint16_t)];
+static volatile uint16_t s_sink;
+
+static image_t make_image(const char *name, int w, int h, int kind)
+{
+    image_t img = {name, w, h, malloc((size_t)w * h * sizeof(uint16_t))};
+    if (!img.pixels) {
+        fprintf(stderr, "out of memory\n");
+        exit(2);
+    }
+    for (int y = 0; y < h; y++) {
+        for (int x = 0; x < w; x++) {
+            int dx = x - w / 2;
+            int dy = y - h / 2;
+            int r2 = dx * dx + dy * dy;
+            uint16_t c;
+            if (kind == 0) {
+                // Dial: radial gradient with 60 tick marks near the rim.
+                int shade = 16 + (r2 * 48) / ((w / 2) * (w / 2) + 1);
+                bool tick = r2 > (w * w) / 5 && r2 < (w * w) / 4 && ((x * 7 + y * 13) % 37) < 3;
+                c = tick ? rgb565_be(230, 230, 230) : rgb565_be((uint8_t)shade, (uint8_t)shade, (uint8_t)(shade + 24));
+            } else if (kind == 1) {
+                // Icon: flat ring, two colours.
+                bool ring = r2 > (w * w) / 9 && r2 < (w * w) / 5;
+                c = ring ? rgb565_be(40, 200, 120) : rgb565_be(0, 0, 0);
+            } else {
+                // Banner: horizontal gradient, new colour every few pixels.
+                c = rgb565_be((uint8_t)(x * 255 / w), (uint8_t)(y * 255 / h), 96);
+            }
+            img.pixels[(size_t)y * w + x] = c;
+        }
+    }
+    return img;
+}
+
+// Bus accounting for one draw of the image with the given method.
+static void draw_counted(const image_t *img, method_t method)
+{
+    bench_panel_reset();
+    if (method == METHOD_BLIT) {
+        bench_panel_blit(0, 0, img->w, img->h);
+    } else if (method == METHOD_SOLID) {
+        bench_panel_window(0, 0, img->w, img->h);
+    } else {
+        for (int y = 0; y < img->h; y++) {
+            const uint16_t *row = img->pixels + (size_t)y * img->w;
+            int start = 0;
+            for (int x = 1; x <= img->w; x++) {
+                if (x == img->w || row[x] != row[start]) {
+                    bench_panel_window(start, y, x - start, 1);
+                    start = x;
+                }
+            }
+        }
+    }
+}
+
+// Host CPU work the firmware does per draw: band memcpy for blits, chunk fill loops for fills.
+static void draw_cpu(const image_t *img, method_t method)
+{
+    if (method == METHOD_BLIT) {
+        int band = dma_draw_band_rows(img->w);
+        for (int y = 0; y < img->h; y += band) {
+            int rows = (img->h - y > band) ? band : img->h - y;
+            memcpy(s_block, img->pixels + (size_t)y * img->w, (size_t)rows * img->w * sizeof(uint16_t));
+            s_sink = s_block[0];
+        }
+    } else if (method == METHOD_SOLID) {
+        size_t n = (size_t)img->w * DRAW_CHUNK_ROWS;
+        for (size_t i = 0; i < n; i++) {
+            s_block[i] = img->pixels[0];
+        }
+        s_sink = s_block[n - 1];
+    } else {
+        for (int y = 0; y < img->h; y++) {
+            const uint16_t *row = img->pixels + (size_t)y * img->w;
+            int start = 0;
+            for (int x = 1; x <= img->w; x++) {
+                if (x == img->w || row[x] != row[start]) {
+                    size_t n = (size_t)(x - start) * DRAW_CHUNK_ROWS;
+                    for (size_t i = 0; i < n; i++) {
+                        s_block[i] = row[start];
+                    }
+                    s_sink = s_block[0];
+                    start = x;
+                }
+            }
+        }
+    }
+}
+
+static void bench_image(const image_t *img)
+{
+    uint64_t image_bytes = (uint64_t)img->w * img->h * sizeof(uint16_t);
+    printf("%s %dx%d (%llu B)\n", img->name, img->w, img->h, (unsigned long long)image_bytes);
+
+    for (int m = 0; m < METHOD_COUNT; m++) {
+        draw_counted(img, (method_t)m);
+        bench_panel_counters_t c = g_bench_panel;
+
+        uint64_t start = bench_now_ns();
+        for (int r = 0; r < BENCH_CPU_REPS; r++) {
+            draw_cpu(img, (method_t)m);
+        }
+        double cpu_ns = (double)(bench_now_ns() - start) / BENCH_CPU_REPS;
+
+        double bus_us = (double)c.bus_bytes * 2.0 / BENCH_QSPI_HZ * 1e6 + c.transactions * BENCH_TXN_OVERHEAD_US;
+        printf("  %-10s trans=%-7llu bus=%-8llu host_cpu=%8.0f ns (%7.1f MB/s)  est_panel=%6.2f MB/s\n",
+               k_method_names[m], (unsigned long long)c.transactions, (unsigned long long)c.bus_bytes,
+               cpu_ns, cpu_ns > 0 ? (double)image_bytes * 1e3 / cpu_ns : 0.0,
+               bus_us > 0 ? (double)image_bytes / bus_us : 0.0);
+
+        char scenario[64];
+        snprintf(scenario, sizeof(scenario), "%s.%s", img->name, k_method_names[m]);
+        bench_metric_add(scenario, "transactions", c.transactions);
+        bench_metric_add(scenario, "bus_bytes", c.bus_bytes);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    const char *baseline;
+    const char *write_to;
+    if (!bench_parse_args(argc, argv, &baseline, &write_to)) {
+        return 2;
+    }
+
+    image_t images[] = {
+        make_image("dial", LCD_H_RES, LCD_V_RES, 0),
+        make_image("icon", 48, 48, 1),
+        make_image("banner", LCD_H_RES, 64, 2),
+    };
+    for (size_t i = 0; i < sizeof(images) / sizeof(images[0]); i++) {
+        bench_image(&images[i]);
+        free(images[i].pixels);
+    }
+    return bench_baseline_finish("blit_bench", baseline, write_to);
+}
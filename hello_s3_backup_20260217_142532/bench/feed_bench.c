@@ -0,0 +1,368 @@
+// Reminder feed parser benchmark. A large generated feed is pushed through
+// reminder_feed in random chunk sizes and every record must arrive intact; a
+// corpus of malformed documents must all be rejected, and a set of awkward but
+// valid ones accepted. Parser state size and error counts are gated against
+// feed_baseline.txt; throughput is printed only.
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bench_baseline.h"
+#include "bench_panel.h"
+#include "reminder_feed.h"
+
+#define LARGE_RECORDS   20000
+#define LARGE_DELETES   2000
+#define LARGE_MAX_CHUNK 1460   // one TCP segment
+#define TRUNCATE_CUTS   200
+
+typedef struct {
+    char *data;
+    size_t len;
+    size_t cap;
+} buf_t;
+
+typedef struct {
+    uint32_t upserts;
+    uint32_t removes;
+    uint64_t hash;
+} sink_state_t;
+
+static uint32_t s_rng = 0x2545F491u;
+
+static uint32_t rnd(void)
+{
+    s_rng = s_rng * 1664525u + 1013904223u;
+    return s_rng >> 8;
+}
+
+static void buf_put(buf_t *b, const char *s, size_t n)
+{
+    if (b->len + n + 1 > b->cap) {
+        b->cap = (b->len + n + 1) * 2;
+        b->data = realloc(b->data, b->cap);
+        if (!b->data) {
+            fprintf(stderr, "out of memory\n");
+            exit(2);
+        }
+    }
+    memcpy(b->data + b->len, s, n);
+    b->len += n;
+    b->data[b->len] = '\0';
+}
+
+static void buf_printf(buf_t *b, const char *fmt, ...)
+{
+    char tmp[256];
+    va_list ap;
+    va_start(ap, fmt);
+    int n = vsnprintf(tmp, sizeof(tmp), fmt, ap);
+    va_end(ap);
+    buf_put(b, tmp, (size_t)n);
+}
+
+static uint64_t fnv(uint64_t h, const void *data, size_t len)
+{
+    const uint8_t *p = (const uint8_t *)data;
+    for (size_t i = 0; i < len; i++) {
+        h = (h ^ p[i]) * 0x100000001B3ull;
+    }
+    return h;
+}
+
+static uint64_t record_hash(uint64_t h, const reminder_t *r)
+{
+    h = fnv(h, &r->id, sizeof(r->id));
+    h = fnv(h, &r->hour, 1);
+    h = fnv(h, &r->minute, 1);
+    h = fnv(h, &r->days, 1);
+    return fnv(h, r->text, strlen(r->text));
+}
+
+static bool sink_upsert(void *ctx, const reminder_t *r)
+{
+    sink_state_t *st = (sink_state_t *)ctx;
+    st->upserts++;
+    st->hash = record_hash(st->hash, r);
+    return true;
+}
+
+static void sink_remove(void *ctx, uint32_t id)
+{
+    sink_state_t *st = (sink_state_t *)ctx;
+    st->removes++;
+    st->hash = fnv(st->hash, &id, sizeof(id));
+}
+
+// Writes text as a JSON string, escaping the way a server might (and sometimes more than needed).
+static void put_json_string(buf_t *b, const char *text)
+{
+    buf_put(b, "\"", 1);
+    for (const char *s = text; *s; s++) {
+        unsigned char c = (unsigned char)*s;
+        if (c == '"' || c == '\\') {
+            char esc[2] = {'\\', (char)c};
+            buf_put(b, esc, 2);
+        } else if (c == 0xC3 && (unsigned char)s[1] == 0xA9 && (rnd() & 1)) {
+            buf_put(b, "\\u00e9", 6);  // same é, escaped
+            s++;
+        } else if (c == '/' && (rnd() & 1)) {
+            buf_put(b, "\\/", 2);
+        } else {
+            buf_put(b, s, 1);
+        }
+    }
+    buf_put(b, "\"", 1);
+}
+
+// Builds the large feed and the hash the sink must end up with.
+static void make_large_feed(buf_t *b, sink_state_t *expect)
+{
+    static const char *words[] = {"Stand-up", "Pills", "Call \"mum\"", "Café", "Bins out", "Gym/run",
+                                  "Water plants", "C:\\backup", "Pick up kids", "Rent"};
+    buf_printf(b, "{\"cursor\":\"c-%u\",\"server\":{\"name\":\"stand-in\",\"tags\":[1,2,{\"x\":null}]},"
+                  "\"full\":false,\"reminders\":[\n", (unsigned)rnd());
+    memset(expect, 0, sizeof(*expect));
+    expect->hash = 0xCBF29CE484222325ull;
+
+    for (uint32_t i = 0; i < LARGE_RECORDS + LARGE_DELETES; i++) {
+        if (i) {
+            buf_put(b, ",\n", 2);
+        }
+        uint32_t id = i + 1;
+        if (i >= LARGE_RECORDS) {
+            buf_printf(b, "{\"id\":%u,\"deleted\":true}", (unsigned)(id - LARGE_RECORDS));
+            expect->removes++;
+            uint32_t del = id - LARGE_RECORDS;
+            expect->hash = fnv(expect->hash, &del, sizeof(del));
+            continue;
+        }
+        reminder_t r = {.id = id, .hour = (uint8_t)(rnd() % 24), .minute = (uint8_t)(rnd() % 60)};
+        r.days = (uint8_t)(1 + rnd() % REMINDER_DAYS_ALL);
+        snprintf(r.text, sizeof(r.text), "%s #%u", words[rnd() % 10], (unsigned)id);
+
+        buf_printf(b, "{\"id\":%u,\"at\":\"%02u:%02u\",", (unsigned)r.id, r.hour, r.minute);
+        if (r.days != REMINDER_DAYS_ALL || (rnd() & 1)) {
+            buf_printf(b, "\"days\":%u,", r.days);
+        }
+        buf_put(b, "\"text\":", 7);
+        put_json_string(b, r.text);
+        if (rnd() % 8 == 0) {
+            buf_printf(b, ",\"meta\":{\"rev\":%u,\"h\":[%u.5e-3,true,\"x\"]}", (unsigned)rnd(), (unsigned)rnd());
+        }
+        buf_printf(b, ",\"deleted\":false}");
+        expect->upserts++;
+        expect->hash = record_hash(expect->hash, &r);
+    }
+    buf_put(b, "\n]}\n", 4);
+}
+
+static bool run_feed(const char *data, size_t len, size_t max_chunk, sink_state_t *st, reminder_feed_t *f)
+{
+    memset(st, 0, sizeof(*st));
+    st->hash = 0xCBF29CE484222325ull;
+    reminder_feed_sink_t sink = {.upsert = sink_upsert, .remove = sink_remove, .ctx = st};
+    reminder_feed_init(f, &sink);
+    size_t off = 0;
+    while (off < len) {
+        size_t n = (max_chunk <= 1) ? 1 : 1 + rnd() % max_chunk;
+        if (n > len - off) {
+            n = len - off;
+        }
+        if (!reminder_feed_write(f, data + off, n)) {
+            return false;
+        }
+        off += n;
+    }
+    return reminder_feed_finish(f);
+}
+
+static const char *s_malformed[] = {
+    "",
+    "   ",
+    "[]",                                            // top level must be an object
+    "\"reminders\"",
+    "{",
+    "{\"reminders\":[{\"id\":1}",
+    "{\"a\":1}}",
+    "{\"a\":1} x",
+    "{\"a\" 1}",
+    "{\"a\":1,}",
+    "{\"a\":[1,]}",
+    "{,\"a\":1}",
+    "{'a':1}",
+    "{\"a\":01}",
+    "{\"a\":1.}",
+    "{\"a\":-}",
+    "{\"a\":1e}",
+    "{\"a\":.5}",
+    "{\"a\":+1}",
+    "{\"a\":tru}",
+    "{\"a\":nulls}",
+    "{\"a\":True}",
+    "{\"a\":\"\\x41\"}",
+    "{\"a\":\"\\u12G4\"}",
+    "{\"a\":\"\\ud800\"}",                            // lone high surrogate
+    "{\"a\":\"\\udc00\"}",                            // lone low surrogate
+    "{\"a\":\"\\ud800\\u0041\"}",
+    "{\"a\":\"\\u0000\"}",
+    "{\"a\":\"tab\there\"}",
+    "{\"a\":\"line\nbreak\"}",
+    "{\"a\":\"unterminated}",
+    "{\"a\":[[[[[[[[[[[[[[[[[[[[1]]]]]]]]]]]]]]]]]]]}",  // deeper than JSON_SAX_MAX_DEPTH
+    "{\"a\":123456789012345678901234567890123456789012345678901234567890123456789012345678901234567890123456789}",
+    "{\"reminders\":[{\"id\":1,\"at\":\"07:00\"}]}garbage",
+    "<html><body>502 Bad Gateway</body></html>",
+};
+
+// Valid JSON that must parse; the expected upsert/remove/rejected counts follow each document.
+typedef struct {
+    const char *doc;
+    uint32_t upserts;
+    uint32_t removes;
+    uint32_t rejected;
+} valid_case_t;
+
+static const valid_case_t s_valid[] = {
+    {"{}", 0, 0, 0},
+    {" {\"reminders\":[]} \n", 0, 0, 0},
+    {"{\"reminders\":[{\"id\":1,\"at\":\"07:30\",\"text\":\"a\"}]}", 1, 0, 0},
+    {"{\"reminders\":[{\"id\":1,\"deleted\":true},{\"id\":0,\"deleted\":true}]}", 0, 1, 1},
+    {"{\"reminders\":[{\"id\":1,\"at\":\"24:00\"},{\"id\":2,\"at\":\"7:30\"},{\"id\":3}]}", 0, 0, 3},
+    {"{\"reminders\":[{\"id\":-1,\"at\":\"07:00\"},{\"id\":1.5,\"at\":\"07:00\"},{\"id\":\"4\",\"at\":\"07:00\"}]}", 0, 0, 3},
+    {"{\"reminders\":[{\"id\":4294967296,\"at\":\"07:00\"},{\"id\":4294967295,\"at\":\"07:00\"}]}", 1, 0, 1},
+    {"{\"reminders\":[{\"id\":5,\"at\":\"07:00\",\"days\":128},{\"id\":6,\"at\":\"07:00\",\"days\":0}]}", 0, 0, 2},
+    {"{\"reminders\":[1,\"x\",null,[],{\"id\":7,\"at\":\"07:00\"}]}", 1, 0, 4},
+    {"{\"reminders\":[{\"id\":8,\"at\":{\"h\":7}},{\"id\":9,\"at\":\"07:00\",\"x\":{\"id\":99}}]}", 1, 0, 1},
+    {"{\"other\":{\"reminders\":[{\"id\":1,\"at\":\"07:00\"}]},\"reminders\":{\"id\":1}}", 0, 0, 0},
+    {"{\"reminders\":[{\"id\":10,\"at\":\"07:00\",\"text\":\"\\ud83d\\ude00 \\u00e9\\u4e2d \\\"q\\\" \\\\ \\/\"}]}", 1, 0, 0},
+    {"{\"reminders\":[{\"id\":11,\"at\":\"07:00\",\"text\":\"0123456789012345678901234567890123456789012345\\u4e2d\\u4e2d\"}]}", 1, 0, 0},
+    {"{\"reminders\":[{\"id\":12,\"at\":\"07:00\",\"text\":\"0123456789012345678901234567890123456789012345678901234567890123456789012345678901234567890123456789xyz\"}]}", 1, 0, 0},
+    {"{\"a\":[[[[[[[[[[[[[[1]]]]]]]]]]]]]]}", 0, 0, 0},
+    {"{\"a\":-0.0e+0,\"b\":1E-7,\"c\":0,\"d\":true,\"e\":false,\"f\":null}", 0, 0, 0},
+};
+
+// Checks one record decoded from the awkward-text cases.
+static bool s_text_ok = true;
+
+static bool text_sink_upsert(void *ctx, const reminder_t *r)
+{
+    (void)ctx;
+    size_t len = strlen(r->text);
+    // Must fit, stay valid UTF-8 at the end, and keep the decoded escapes.
+    if (len >= REMINDER_TEXT_MAX) {
+        s_text_ok = false;
+    }
+    if (len > 0 && ((unsigned char)r->text[len - 1] & 0xC0) == 0xC0) {
+        s_text_ok = false;
+    }
+    if (r->id == 10 && strcmp(r->text, "\xF0\x9F\x98\x80 \xC3\xA9\xE4\xB8\xAD \"q\" \\ /") != 0) {
+        s_text_ok = false;
+    }
+    if (r->id == 11 && strcmp(r->text, "0123456789012345678901234567890123456789012345") != 0) {
+        s_text_ok = false;
+    }
+    return true;
+}
+
+static void text_sink_remove(void *ctx, uint32_t id)
+{
+    (void)ctx;
+    (void)id;
+}
+
+int main(int argc, char **argv)
+{
+    const char *baseline;
+    const char *write_to;
+    if (!bench_parse_args(argc, argv, &baseline, &write_to)) {
+        return 2;
+    }
+
+    static reminder_feed_t feed;
+    sink_state_t got;
+    sink_state_t expect;
+    buf_t large = {0};
+    make_large_feed(&large, &expect);
+
+    // Large feed in TCP-sized chunks, timed.
+    uint64_t start = bench_now_ns();
+    bool ok = run_feed(large.data, large.len, LARGE_MAX_CHUNK, &got, &feed);
+    uint64_t ns = bench_now_ns() - start;
+    uint32_t lost = (expect.upserts + expect.removes) - (got.upserts + got.removes);
+    uint32_t mismatch = (!ok || got.hash != expect.hash || got.upserts != expect.upserts ||
+                         got.removes != expect.removes) ? 1 : 0;
+    printf("large      %zu B, %u records, %s, %.1f MB/s, %llu ns/record, state %zu B (sax %zu B)\n",
+           large.len, (unsigned)(got.upserts + got.removes), ok ? "ok" : json_sax_error_name(feed.sax.error),
+           (double)large.len * 1000.0 / (double)(ns ? ns : 1),
+           (unsigned long long)(ns / (LARGE_RECORDS + LARGE_DELETES)), sizeof(reminder_feed_t), sizeof(json_sax_t));
+    bench_metric_add("large", "mismatch", mismatch);
+    bench_metric_add("large", "lost_records", lost);
+    bench_metric_add("large", "rejected", feed.result.rejected);
+    bench_metric_add("parser", "state_bytes", sizeof(reminder_feed_t));
+
+    // Byte-at-a-time must give the same result as big chunks.
+    size_t prefix = 64 * 1024;
+    while (prefix < large.len && large.data[prefix] != '\n') {
+        prefix++;
+    }
+    buf_t small = {0};
+    buf_put(&small, large.data, prefix - 1);  // drop the separating comma
+    buf_put(&small, "]}", 2);
+    sink_state_t whole;
+    sink_state_t bytes;
+    bool whole_ok = run_feed(small.data, small.len, small.len, &whole, &feed);
+    bool bytes_ok = run_feed(small.data, small.len, 1, &bytes, &feed);
+    uint32_t chunk_mismatch = (!whole_ok || !bytes_ok || whole.hash != bytes.hash) ? 1 : 0;
+    printf("chunking   %zu B whole vs. 1 B chunks: %s\n", small.len, chunk_mismatch ? "MISMATCH" : "identical");
+    bench_metric_add("chunking", "mismatch", chunk_mismatch);
+
+    // A connection that drops anywhere mid-body must never parse as complete.
+    uint32_t truncated_accepted = 0;
+    for (int i = 0; i < TRUNCATE_CUTS; i++) {
+        size_t cut = 1 + (size_t)rnd() % (large.len - 2);  // always short of the closing brace
+        if (run_feed(large.data, cut, LARGE_MAX_CHUNK, &got, &feed)) {
+            truncated_accepted++;
+        }
+    }
+    printf("truncated  %d random cuts: %u accepted\n", TRUNCATE_CUTS, (unsigned)truncated_accepted);
+    bench_metric_add("truncated", "accepted", truncated_accepted);
+
+    uint32_t malformed_accepted = 0;
+    int malformed_count = (int)(sizeof(s_malformed) / sizeof(s_malformed[0]));
+    for (int i = 0; i < malformed_count; i++) {
+        if (run_feed(s_malformed[i], strlen(s_malformed[i]), 7, &got, &feed)) {
+            printf("  accepted malformed #%d: %s\n", i, s_malformed[i]);
+            malformed_accepted++;
+        }
+    }
+    printf("malformed  %d documents: %u accepted\n", malformed_count, (unsigned)malformed_accepted);
+    bench_metric_add("malformed", "accepted", malformed_accepted);
+
+    uint32_t valid_wrong = 0;
+    int valid_count = (int)(sizeof(s_valid) / sizeof(s_valid[0]));
+    for (int i = 0; i < valid_count; i++) {
+        const valid_case_t *vc = &s_valid[i];
+        sink_state_t st = {0};
+        reminder_feed_sink_t sink = {.upsert = text_sink_upsert, .remove = text_sink_remove, .ctx = &st};
+        reminder_feed_init(&feed, &sink);
+        bool vok = reminder_feed_write(&feed, vc->doc, strlen(vc->doc)) && reminder_feed_finish(&feed);
+        const reminder_feed_result_t *res = &feed.result;
+        if (!vok || res->upserts != vc->upserts || res->deletes != vc->removes || res->rejected != vc->rejected) {
+            printf("  wrong result for valid #%d (%s, +%u -%u rejected %u): %s\n", i,
+                   vok ? "ok" : json_sax_error_name(feed.sax.error), (unsigned)res->upserts,
+                   (unsigned)res->deletes, (unsigned)res->rejected, vc->doc);
+            valid_wrong++;
+        }
+    }
+    valid_wrong += s_text_ok ? 0 : 1;
+    printf("valid      %d documents: %u wrong%s\n", valid_count, (unsigned)valid_wrong,
+           s_text_ok ? "" : " (text decoding)");
+    bench_metric_add("valid", "wrong", valid_wrong);
+
+    free(large.data);
+    free(small.data);
+    return bench_baseline_finish("feed_bench", baseline, write_to);
+}
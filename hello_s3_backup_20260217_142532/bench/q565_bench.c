@@ -0,0 +1,239 @@
+// Q565 corpus benchmark: compression ratio, band decode speed and modelled
+// time-to-full-screen for synthetic 360x360 images with the round-panel
+// corners dropped. Every image is round-tripped and must decode bit-exact.
+// Encoded sizes are gated against q565_baseline.txt; timings are printed only.
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bench_baseline.h"
+#include "bench_panel.h"
+#include "dma_arena.h"
+#include "panel_config.h"
+#include "q565.h"
+#include "q565_encode.h"
+
+// Same link model as blit_bench.c.
+#define BENCH_QSPI_HZ          20000000.0
+#define BENCH_TXN_OVERHEAD_US  6.0
+#define BENCH_DECODE_REPS      50
+
+#define IMG_W LCD_H_RES
+#define IMG_H LCD_V_RES
+#define MAX_BANDS ((IMG_H + DRAW_CHUNK_ROWS - 1) / DRAW_CHUNK_ROWS)
+
+static uint16_t s_image[IMG_W * IMG_H];
+static uint16_t s_band[DMA_DRAW_BLOCK_BYTES / sizeof(uint16_t)];
+static uint32_t s_rng = 0x12345678u;
+
+static uint32_t rnd(void)
+{
+    s_rng = s_rng * 1664525u + 1013904223u;
+    return s_rng >> 8;
+}
+
+static uint16_t rgb565(int r, int g, int b)
+{
+    r = r < 0 ? 0 : (r > 255 ? 255 : r);
+    g = g < 0 ? 0 : (g > 255 ? 255 : g);
+    b = b < 0 ? 0 : (b > 255 ? 255 : b);
+    return (uint16_t)(((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3));
+}
+
+static void make_image(int kind)
+{
+    static int grid[10][10][3];
+    for (int j = 0; j < 10; j++) {
+        for (int i = 0; i < 10; i++) {
+            for (int c = 0; c < 3; c++) {
+                grid[j][i][c] = (int)(rnd() % 256);
+            }
+        }
+    }
+
+    for (int y = 0; y < IMG_H; y++) {
+        for (int x = 0; x < IMG_W; x++) {
+            int dx = x - IMG_W / 2;
+            int dy = y - IMG_H / 2;
+            int r2 = dx * dx + dy * dy;
+            uint16_t c;
+            switch (kind) {
+            case 0: {  // dial: radial shading with tick marks
+                int shade = 16 + (r2 * 48) / (180 * 180);
+                bool tick = r2 > 150 * 150 && r2 < 170 * 170 && ((x * 7 + y * 13) % 37) < 3;
+                c = tick ? rgb565(230, 230, 230) : rgb565(shade, shade, shade + 24);
+                break;
+            }
+            case 1: {  // photo: bilinear value noise plus sensor-like grain
+                int gx = x * 9 / IMG_W;
+                int gy = y * 9 / IMG_H;
+                int fx = (x * 9 % IMG_W) * 256 / IMG_W;
+                int fy = (y * 9 % IMG_H) * 256 / IMG_H;
+                int ch[3];
+                for (int k = 0; k < 3; k++) {
+                    int top = grid[gy][gx][k] * (256 - fx) + grid[gy][gx + 1][k] * fx;
+                    int bot = grid[gy + 1][gx][k] * (256 - fx) + grid[gy + 1][gx + 1][k] * fx;
+                    ch[k] = ((top >> 8) * (256 - fy) + (bot >> 8) * fy) >> 8;
+                    ch[k] += (int)(rnd() % 7) - 3;
+                }
+                c = rgb565(ch[0], ch[1], ch[2]);
+                break;
+            }
+            case 2: {  // ui: flat cards and glyph-like blocks on a dark background
+                c = rgb565(12, 14, 20);
+                if (y > 60 && y < 150 && x > 50 && x < 310) {
+                    c = rgb565(40, 44, 60);
+                    if (y > 80 && y < 130 && (x / 6) % 3 != 0 && ((x / 18 + y / 10) % 4) != 0) {
+                        c = rgb565(220, 220, 230);
+                    }
+                }
+                if (y > 190 && y < 300 && x > 70 && x < 290) {
+                    c = (x / 20 + y / 20) % 2 ? rgb565(255, 140, 0) : rgb565(30, 120, 220);
+                }
+                break;
+            }
+            case 3:  // gradient: smooth full-screen radial gradient
+                c = rgb565(255 - r2 / 130, 80 + (x * 100) / IMG_W, 60 + (y * 180) / IMG_H);
+                break;
+            default:  // noise: incompressible worst case
+                c = (uint16_t)rnd();
+                break;
+            }
+            s_image[y * IMG_W + x] = c;
+        }
+    }
+}
+
+static bool verify(const uint8_t *stream, size_t len, uint16_t outside)
+{
+    q565_decoder_t dec;
+    if (!q565_decoder_init(&dec, stream, len)) {
+        return false;
+    }
+    int band = dma_draw_band_rows(IMG_W);
+    int y = 0;
+    int rows;
+    while ((rows = q565_decode_rows(&dec, s_band, band)) > 0) {
+        for (int r = 0; r < rows; r++, y++) {
+            int x0;
+            int x1;
+            q565_row_span(IMG_W, IMG_H, true, y, &x0, &x1);
+            for (int x = 0; x < IMG_W; x++) {
+                uint16_t want = (x >= x0 && x < x1) ? s_image[y * IMG_W + x] : outside;
+                uint16_t got = s_band[r * IMG_W + x];
+                if ((uint16_t)((got << 8) | (got >> 8)) != want) {
+                    fprintf(stderr, "mismatch at %d,%d\n", x, y);
+                    return false;
+                }
+            }
+        }
+    }
+    return rows == 0 && y == IMG_H;
+}
+
+static size_t stored_pixels(void)
+{
+    size_t n = 0;
+    for (int y = 0; y < IMG_H; y++) {
+        int x0;
+        int x1;
+        q565_row_span(IMG_W, IMG_H, true, y, &x0, &x1);
+        n += (x1 > x0) ? (size_t)(x1 - x0) : 0;
+    }
+    return n;
+}
+
+// Per-band decode times, then a 3-block pipeline against the bus model.
+static void time_to_full_screen(const uint8_t *stream, size_t len, double *decode_us, double *serial_us, double *pipelined_us)
+{
+    static double band_ns[MAX_BANDS];
+    int band_rows = dma_draw_band_rows(IMG_W);
+    int bands = 0;
+    memset(band_ns, 0, sizeof(band_ns));
+
+    for (int rep = 0; rep < BENCH_DECODE_REPS; rep++) {
+        q565_decoder_t dec;
+        q565_decoder_init(&dec, stream, len);
+        bands = 0;
+        for (;;) {
+            uint64_t t0 = bench_now_ns();
+            int rows = q565_decode_rows(&dec, s_band, band_rows);
+            uint64_t t1 = bench_now_ns();
+            if (rows <= 0) {
+                break;
+            }
+            band_ns[bands++] += (double)(t1 - t0);
+        }
+    }
+
+    double total_decode = 0;
+    double serial = 0;
+    double cpu = 0;
+    double bus_free = 0;
+    double done[MAX_BANDS];
+    for (int i = 0; i < bands; i++) {
+        int rows = (i == bands - 1 && IMG_H % band_rows) ? IMG_H % band_rows : band_rows;
+        bench_panel_reset();
+        bench_panel_window_chunked(0, 0, IMG_W, rows, rows);
+        double bus = (double)g_bench_panel.bus_bytes * 2.0 / BENCH_QSPI_HZ * 1e6 +
+                     g_bench_panel.transactions / 3.0 * BENCH_TXN_OVERHEAD_US;
+        double dec_us = band_ns[i] / BENCH_DECODE_REPS / 1000.0;
+
+        total_decode += dec_us;
+        serial += dec_us + bus;
+        if (i >= DMA_DRAW_BLOCKS && cpu < done[i - DMA_DRAW_BLOCKS]) {
+            cpu = done[i - DMA_DRAW_BLOCKS];   // wait for a free arena block
+        }
+        cpu += dec_us;
+        double start = (cpu > bus_free) ? cpu : bus_free;
+        bus_free = start + bus;
+        done[i] = bus_free;
+    }
+    *decode_us = total_decode;
+    *serial_us = serial;
+    *pipelined_us = bus_free;
+}
+
+int main(int argc, char **argv)
+{
+    static const char *names[] = {"dial", "photo", "ui", "gradient", "noise"};
+    const char *baseline;
+    const char *write_to;
+    if (!bench_parse_args(argc, argv, &baseline, &write_to)) {
+        return 2;
+    }
+
+    const size_t raw_bytes = (size_t)IMG_W * IMG_H * 2U;
+    const size_t round_bytes = stored_pixels() * 2U;
+    uint8_t *stream = malloc(q565_encode_bound(IMG_W, IMG_H));
+    if (!stream) {
+        return 2;
+    }
+
+    printf("raw %zu B, inside circle %zu B, decoder state %zu B, band %d B\n",
+           raw_bytes, round_bytes, sizeof(q565_decoder_t), DMA_DRAW_BLOCK_BYTES);
+    int failures = 0;
+    for (int k = 0; k < (int)(sizeof(names) / sizeof(names[0])); k++) {
+        make_image(k);
+        size_t len = q565_encode(s_image, IMG_W, IMG_H, true, 0, stream);
+        if (!verify(stream, len, 0)) {
+            fprintf(stderr, "%s: round trip FAILED\n", names[k]);
+            failures++;
+            continue;
+        }
+
+        double decode_us;
+        double serial_us;
+        double pipelined_us;
+        time_to_full_screen(stream, len, &decode_us, &serial_us, &pipelined_us);
+        printf("%-9s %7zu B  %5.1f%% of raw  decode %7.1f us (%6.1f MB/s)  full screen: serial %6.0f us, pipelined %6.0f us\n",
+               names[k], len, 100.0 * (double)len / (double)raw_bytes, decode_us,
+               (double)raw_bytes / decode_us, serial_us, pipelined_us);
+        bench_metric_add(names[k], "q565_bytes", len);
+    }
+    free(stream);
+
+    int rc = bench_baseline_finish("q565_bench", baseline, write_to);
+    return failures ? 1 : rc;
+}
@@ -0,0 +1,87 @@
+#include "q565_encode.h"
+
+#include <string.h>
+
+#include "q565.h"
+
+size_t q565_encode_bound(int width, int height)
+{
+    return Q565_HEADER_BYTES + (size_t)width * height * 3U;
+}
+
+static int wrap(int d, int bits)
+{
+    int m = 1 << bits;
+    d &= m - 1;
+    return (d >= m / 2) ? d - m : d;
+}
+
+size_t q565_encode(const uint16_t *pixels, int width, int height, bool round, uint16_t outside, uint8_t *out)
+{
+    uint16_t index[64];
+    memset(index, 0, sizeof(index));
+    uint8_t *p = out;
+
+    uint32_t magic = Q565_MAGIC;
+    for (int i = 0; i < 4; i++) {
+        *p++ = (uint8_t)(magic >> (8 * i));
+    }
+    *p++ = (uint8_t)width;
+    *p++ = (uint8_t)(width >> 8);
+    *p++ = (uint8_t)height;
+    *p++ = (uint8_t)(height >> 8);
+    *p++ = round ? Q565_FLAG_ROUND : 0;
+    *p++ = 0;
+    *p++ = (uint8_t)outside;
+    *p++ = (uint8_t)(outside >> 8);
+
+    uint16_t prev = 0;
+    int run = 0;
+    for (int y = 0; y < height; y++) {
+        int x0;
+        int x1;
+        q565_row_span((uint16_t)width, (uint16_t)height, round, y, &x0, &x1);
+        for (int x = x0; x < x1; x++) {
+            uint16_t px = pixels[(size_t)y * width + x];
+            if (px == prev) {
+                if (++run == Q565_RUN_MAX) {
+                    *p++ = (uint8_t)(Q565_OP_RUN | (run - 1));
+                    run = 0;
+                }
+                continue;
+            }
+            if (run > 0) {
+                *p++ = (uint8_t)(Q565_OP_RUN | (run - 1));
+                run = 0;
+            }
+
+            unsigned h = q565_hash(px);
+            if (index[h] == px) {
+                *p++ = (uint8_t)(Q565_OP_INDEX | h);
+            } else {
+                index[h] = px;
+                int dr = wrap((px >> 11) - (prev >> 11), 5);
+                int dg = wrap(((px >> 5) & 63) - ((prev >> 5) & 63), 6);
+                int db = wrap((px & 31) - (prev & 31), 5);
+                int half = q565_half(dg);
+                int drg = dr - half;
+                int dbg = db - half;
+                if (dr >= -2 && dr <= 1 && dg >= -2 && dg <= 1 && db >= -2 && db <= 1) {
+                    *p++ = (uint8_t)(Q565_OP_DIFF | ((dr + 2) << 4) | ((dg + 2) << 2) | (db + 2));
+                } else if (drg >= -8 && drg <= 7 && dbg >= -8 && dbg <= 7) {
+                    *p++ = (uint8_t)(Q565_OP_LUMA | (dg + 32));
+                    *p++ = (uint8_t)(((drg + 8) << 4) | (dbg + 8));
+                } else {
+                    *p++ = Q565_OP_RGB;
+                    *p++ = (uint8_t)(px >> 8);
+                    *p++ = (uint8_t)px;
+                }
+            }
+            prev = px;
+        }
+    }
+    if (run > 0) {
+        *p++ = (uint8_t)(Q565_OP_RUN | (run - 1));
+    }
+    return (size_t)(p - out);
+}
@@ -0,0 +1,11 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Host-side Q565 encoder mirroring tools/png_to_assets.py, so the bench can
+// build its corpus without Python. pixels are native RGB565, row-major.
+// Returns the stream length; out must hold q565_encode_bound() bytes.
+size_t q565_encode_bound(int width, int height);
+size_t q565_encode(const uint16_t *pixels, int width, int height, bool round, uint16_t outside, uint8_t *out);
@@ -0,0 +1,184 @@
+// Replays a full day of clock ticks through clock_face_draw() against the
+// counting panel and reports bus cost per tick. With --baseline it fails when
+// any bus metric of any scenario exceeds the checked-in value.
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "bench_baseline.h"
+#include "bench_panel.h"
+#include "clock_face.h"
+
+#define DAY_TICKS 86400
+#define MAX_SCENARIOS 8
+
+typedef struct {
+    const char *name;
+    uint32_t ticks;
+    bench_panel_counters_t total;
+    uint64_t tick_max[4];   // transactions, window setups, payload, bus bytes
+    uint32_t *payload_per_tick;
+    uint64_t *cpu_ns_per_tick;
+} scenario_t;
+
+static scenario_t s_scenarios[MAX_SCENARIOS];
+static int s_scenario_count = 0;
+
+static struct tm hms(int h, int m, int s)
+{
+    struct tm ti;
+    memset(&ti, 0, sizeof(ti));
+    ti.tm_hour = h;
+    ti.tm_min = m;
+    ti.tm_sec = s;
+    return ti;
+}
+
+static struct tm from_seconds(uint32_t sec_of_day)
+{
+    sec_of_day %= DAY_TICKS;
+    return hms((int)(sec_of_day / 3600), (int)((sec_of_day / 60) % 60), (int)(sec_of_day % 60));
+}
+
+static scenario_t *scenario_begin(const char *name, uint32_t ticks)
+{
+    scenario_t *sc = &s_scenarios[s_scenario_count++];
+    memset(sc, 0, sizeof(*sc));
+    sc->name = name;
+    sc->payload_per_tick = calloc(ticks, sizeof(uint32_t));
+    sc->cpu_ns_per_tick = calloc(ticks, sizeof(uint64_t));
+    if (!sc->payload_per_tick || !sc->cpu_ns_per_tick) {
+        fprintf(stderr, "out of memory\n");
+        exit(2);
+    }
+    return sc;
+}
+
+// Draws one measured frame and folds its counters into the scenario.
+static void scenario_tick(scenario_t *sc, const struct tm *ti, bool synced)
+{
+    bench_panel_reset();
+    uint64_t start = bench_now_ns();
+    clock_face_draw(ti, synced);
+    uint64_t cpu_ns = bench_now_ns() - start;
+
+    const bench_panel_counters_t *c = &g_bench_panel;
+    uint64_t values[4] = {c->transactions, c->window_setups, c->payload_bytes, c->bus_bytes};
+    for (int i = 0; i < 4; i++) {
+        if (values[i] > sc->tick_max[i]) {
+            sc->tick_max[i] = values[i];
+        }
+    }
+    sc->total.transactions += c->transactions;
+    sc->total.window_setups += c->window_setups;
+    sc->total.payload_bytes += c->payload_bytes;
+    sc->total.bus_bytes += c->bus_bytes;
+    sc->payload_per_tick[sc->ticks] = (uint32_t)c->payload_bytes;
+    sc->cpu_ns_per_tick[sc->ticks] = cpu_ns;
+    sc->ticks++;
+}
+
+static int cmp_u32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+static int cmp_u64(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+static size_t pct_index(uint32_t n, int pct)
+{
+    size_t idx = ((size_t)n * (size_t)pct + 99) / 100;
+    return idx == 0 ? 0 : idx - 1;
+}
+
+static void scenario_report(scenario_t *sc)
+{
+    qsort(sc->payload_per_tick, sc->ticks, sizeof(uint32_t), cmp_u32);
+    qsort(sc->cpu_ns_per_tick, sc->ticks, sizeof(uint64_t), cmp_u64);
+
+    printf("%-10s ticks=%-6u trans=%-9llu windows=%-8llu payload=%-11llu bus=%-11llu\n",
+           sc->name, sc->ticks,
+           (unsigned long long)sc->total.transactions, (unsigned long long)sc->total.window_setups,
+           (unsigned long long)sc->total.payload_bytes, (unsigned long long)sc->total.bus_bytes);
+    printf("           per tick: payload p50=%u p99=%u max=%u B, trans max=%llu, cpu p50=%llu p99=%llu max=%llu ns\n",
+           sc->payload_per_tick[pct_index(sc->ticks, 50)],
+           sc->payload_per_tick[pct_index(sc->ticks, 99)],
+           sc->payload_per_tick[sc->ticks - 1],
+           (unsigned long long)sc->tick_max[0],
+           (unsigned long long)sc->cpu_ns_per_tick[pct_index(sc->ticks, 50)],
+           (unsigned long long)sc->cpu_ns_per_tick[pct_index(sc->ticks, 99)],
+           (unsigned long long)sc->cpu_ns_per_tick[sc->ticks - 1]);
+}
+
+static void run_scenarios(void)
+{
+    clock_face_init(bench_panel_fill);
+
+    // Boot: first frame clears the whole panel, time not yet trusted.
+    clock_face_reset();
+    scenario_t *sc = scenario_begin("startup", 1);
+    struct tm ti = hms(0, 0, 0);
+    scenario_tick(sc, &ti, false);
+
+    // A full day of synced ticks, ending with the 23:59:59 -> 00:00:00 rollover.
+    sc = scenario_begin("day", DAY_TICKS);
+    clock_face_reset();
+    ti = hms(0, 0, 0);
+    clock_face_draw(&ti, true);
+    for (uint32_t s = 1; s <= DAY_TICKS; s++) {
+        ti = from_seconds(s);
+        scenario_tick(sc, &ti, true);
+    }
+
+    sc = scenario_begin("midnight", 1);
+    clock_face_reset();
+    ti = hms(23, 59, 59);
+    clock_face_draw(&ti, true);
+    ti = hms(0, 0, 0);
+    scenario_tick(sc, &ti, true);
+
+    // NTP lands while the uptime clock is showing: every digit and both colons change.
+    sc = scenario_begin("ntp_sync", 1);
+    clock_face_reset();
+    ti = hms(0, 0, 17);
+    clock_face_draw(&ti, false);
+    ti = hms(14, 37, 52);
+    scenario_tick(sc, &ti, true);
+
+    // NTP correction that steps the clock backwards.
+    sc = scenario_begin("step_back", 1);
+    clock_face_reset();
+    ti = hms(12, 0, 5);
+    clock_face_draw(&ti, true);
+    ti = hms(11, 59, 58);
+    scenario_tick(sc, &ti, true);
+}
+
+int main(int argc, char **argv)
+{
+    const char *baseline;
+    const char *write_to;
+    if (!bench_parse_args(argc, argv, &baseline, &write_to)) {
+        return 2;
+    }
+
+    run_scenarios();
+    for (int i = 0; i < s_scenario_count; i++) {
+        const scenario_t *sc = &s_scenarios[i];
+        scenario_report(&s_scenarios[i]);
+        bench_metric_add(sc->name, "transactions", sc->total.transactions);
+        bench_metric_add(sc->name, "window_setups", sc->total.window_setups);
+        bench_metric_add(sc->name, "payload_bytes", sc->total.payload_bytes);
+        bench_metric_add(sc->name, "bus_bytes", sc->total.bus_bytes);
+    }
+    return bench_baseline_finish("replay_bench", baseline, write_to);
+}
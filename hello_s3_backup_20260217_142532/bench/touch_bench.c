@@ -0,0 +1,262 @@
+// Touch driver check against a scripted fake CST816 on a fake I2C bus. A fixed
+// script covers press/move/release, lost lift reports, NAKs and glitched
+// frames; a long random swipe with injected faults checks the event-stream
+// invariants. Every read must be exactly one bus transaction. Counts are gated
+// against touch_baseline.txt; per-read CPU time is printed only.
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "bench_baseline.h"
+#include "bench_panel.h"
+#include "cst816.h"
+#include "panel_config.h"
+
+#define FUZZ_STEPS 100000
+
+typedef struct {
+    uint8_t regs[256];
+    bool nak_next;           // fail the next transaction
+    uint32_t transactions;
+    uint32_t naks;
+    uint8_t last_write[4];
+    size_t last_write_len;
+} fake_dev_t;
+
+static uint32_t s_rng = 0x9E3779B9u;
+
+static uint32_t rnd(void)
+{
+    s_rng = s_rng * 1664525u + 1013904223u;
+    return s_rng >> 8;
+}
+
+static bool fake_write_read(void *ctx, uint8_t addr, const uint8_t *wr, size_t wr_len, uint8_t *rd, size_t rd_len)
+{
+    fake_dev_t *dev = (fake_dev_t *)ctx;
+    dev->transactions++;
+    if (addr != CST816_ADDR || wr_len != 1 || dev->nak_next) {
+        dev->nak_next = false;
+        dev->naks++;
+        return false;
+    }
+    for (size_t i = 0; i < rd_len; i++) {
+        rd[i] = dev->regs[(uint8_t)(wr[0] + i)];
+    }
+    return true;
+}
+
+static bool fake_write(void *ctx, uint8_t addr, const uint8_t *data, size_t len)
+{
+    fake_dev_t *dev = (fake_dev_t *)ctx;
+    dev->transactions++;
+    if (addr != CST816_ADDR || dev->nak_next) {
+        dev->nak_next = false;
+        dev->naks++;
+        return false;
+    }
+    dev->last_write_len = len < sizeof(dev->last_write) ? len : sizeof(dev->last_write);
+    memcpy(dev->last_write, data, dev->last_write_len);
+    if (len >= 2) {
+        dev->regs[data[0]] = data[1];
+    }
+    return true;
+}
+
+// Loads the touch registers the way the controller presents them.
+static void fake_frame(fake_dev_t *dev, uint8_t event_code, uint8_t fingers, uint16_t x, uint16_t y)
+{
+    dev->regs[CST816_REG_GESTURE] = 0;
+    dev->regs[0x02] = fingers;
+    dev->regs[0x03] = (uint8_t)((event_code << 6) | ((x >> 8) & 0x0F));
+    dev->regs[0x04] = (uint8_t)x;
+    dev->regs[0x05] = (uint8_t)((y >> 8) & 0x0F);
+    dev->regs[0x06] = (uint8_t)y;
+}
+
+enum { CODE_DOWN = 0, CODE_UP = 1, CODE_CONTACT = 2 };
+
+typedef enum {
+    STEP_READ,       // INT fired: load frame, read
+    STEP_NAK,        // INT fired but the transaction fails
+    STEP_QUIET,      // INT silent past the release timeout
+} step_kind_t;
+
+typedef struct {
+    step_kind_t kind;
+    uint8_t code;
+    uint8_t fingers;
+    uint16_t x;
+    uint16_t y;
+    cst816_event_t expect;
+    uint16_t ex;
+    uint16_t ey;
+} step_t;
+
+static const step_t s_script[] = {
+    {STEP_READ, CODE_DOWN, 1, 100, 200, CST816_EV_PRESS, 100, 200},
+    {STEP_READ, CODE_CONTACT, 1, 100, 200, CST816_EV_NONE, 0, 0},        // periodic report, no motion
+    {STEP_READ, CODE_CONTACT, 1, 104, 203, CST816_EV_MOVE, 104, 203},
+    {STEP_NAK, 0, 0, 0, 0, CST816_EV_NONE, 0, 0},
+    {STEP_READ, CODE_CONTACT, 1, 4000, 203, CST816_EV_NONE, 0, 0},       // glitched X
+    {STEP_READ, CODE_CONTACT, 1, 110, 210, CST816_EV_MOVE, 110, 210},
+    {STEP_READ, CODE_UP, 1, 110, 210, CST816_EV_RELEASE, 110, 210},
+    {STEP_READ, CODE_UP, 0, 0, 0, CST816_EV_NONE, 0, 0},                 // duplicate lift
+    {STEP_QUIET, 0, 0, 0, 0, CST816_EV_NONE, 0, 0},                      // already up
+    {STEP_READ, CODE_DOWN, 1, 0, 0, CST816_EV_PRESS, 0, 0},              // corner
+    {STEP_READ, CODE_CONTACT, 1, LCD_H_RES - 1, LCD_V_RES - 1, CST816_EV_MOVE, LCD_H_RES - 1, LCD_V_RES - 1},
+    {STEP_QUIET, 0, 0, 0, 0, CST816_EV_RELEASE, LCD_H_RES - 1, LCD_V_RES - 1},  // lift report lost
+    {STEP_READ, CODE_CONTACT, 1, 50, 60, CST816_EV_PRESS, 50, 60},       // first frame already "contact"
+    {STEP_READ, CODE_CONTACT, 0, 50, 60, CST816_EV_RELEASE, 50, 60},     // finger count drops to 0
+    {STEP_READ, CODE_DOWN, 1, LCD_H_RES, 10, CST816_EV_NONE, 0, 0},      // X one past the edge
+};
+
+static bool run_step(cst816_t *t, fake_dev_t *dev, const step_t *st, cst816_report_t *rep)
+{
+    switch (st->kind) {
+    case STEP_QUIET:
+        *rep = cst816_force_release(t);
+        return true;
+    case STEP_NAK:
+        dev->nak_next = true;
+        return cst816_read(t, rep);
+    default:
+        fake_frame(dev, st->code, st->fingers, st->x, st->y);
+        return cst816_read(t, rep);
+    }
+}
+
+static uint32_t run_script(uint32_t *txn_extra)
+{
+    fake_dev_t dev;
+    memset(&dev, 0, sizeof(dev));
+    dev.regs[CST816_REG_CHIP_ID] = 0xB5;
+    dev.regs[CST816_REG_FW_VER] = 2;
+    cst816_bus_t bus = {.write_read = fake_write_read, .write = fake_write, .ctx = &dev};
+    cst816_t t;
+    uint32_t wrong = 0;
+
+    if (!cst816_init(&t, &bus, LCD_H_RES, LCD_V_RES) || t.chip_id != 0xB5 || t.fw_version != 2 ||
+        dev.regs[CST816_REG_IRQ_CTL] != (CST816_IRQ_EN_TOUCH | CST816_IRQ_EN_CHANGE)) {
+        printf("  init: chip/irq config wrong\n");
+        wrong++;
+    }
+
+    uint32_t reads = 0;
+    uint32_t before = dev.transactions;
+    int count = (int)(sizeof(s_script) / sizeof(s_script[0]));
+    for (int i = 0; i < count; i++) {
+        const step_t *st = &s_script[i];
+        cst816_report_t rep;
+        bool ok = run_step(&t, &dev, st, &rep);
+        reads += (st->kind != STEP_QUIET);
+        bool expect_ok = (st->kind != STEP_NAK);
+        if (ok != expect_ok || (ok && (rep.event != st->expect ||
+                                       (rep.event != CST816_EV_NONE && (rep.x != st->ex || rep.y != st->ey))))) {
+            printf("  step %d: got ok=%d ev=%d (%u,%u), want ev=%d (%u,%u)\n", i, ok, rep.event,
+                   rep.x, rep.y, st->expect, st->ex, st->ey);
+            wrong++;
+        }
+    }
+    if (t.bus_errors != 1 || t.out_of_range != 2) {
+        printf("  counters: bus_errors=%u out_of_range=%u\n", (unsigned)t.bus_errors, (unsigned)t.out_of_range);
+        wrong++;
+    }
+    *txn_extra = (dev.transactions - before) - reads;
+    return wrong;
+}
+
+// Random swipes with NAKs, glitches and lost lifts. Checks that the event
+// stream stays well formed and that positions are always on the panel.
+static uint32_t run_fuzz(uint64_t *ns_per_read)
+{
+    fake_dev_t dev;
+    memset(&dev, 0, sizeof(dev));
+    cst816_bus_t bus = {.write_read = fake_write_read, .write = fake_write, .ctx = &dev};
+    cst816_t t;
+    cst816_init(&t, &bus, LCD_H_RES, LCD_V_RES);
+
+    uint32_t violations = 0;
+    bool down = false;
+    int x = LCD_H_RES / 2;
+    int y = LCD_V_RES / 2;
+    uint16_t last_x = 0;
+    uint16_t last_y = 0;
+    bool finger = false;
+    uint32_t reads = 0;
+    uint64_t start = bench_now_ns();
+
+    for (int i = 0; i < FUZZ_STEPS; i++) {
+        uint32_t r = rnd() % 100;
+        cst816_report_t rep;
+        if (r < 2) {
+            rep = cst816_force_release(&t);
+        } else {
+            if (r < 6) {
+                finger = !finger;
+            }
+            x += (int)(rnd() % 9) - 4;
+            y += (int)(rnd() % 9) - 4;
+            x = x < 0 ? 0 : (x >= LCD_H_RES ? LCD_H_RES - 1 : x);
+            y = y < 0 ? 0 : (y >= LCD_V_RES ? LCD_V_RES - 1 : y);
+            uint16_t fx = (r < 8) ? (uint16_t)(LCD_H_RES + rnd() % 3000) : (uint16_t)x;  // glitch
+            fake_frame(&dev, finger ? CODE_CONTACT : CODE_UP, finger ? 1 : 0, fx, (uint16_t)y);
+            dev.nak_next = (r >= 97);
+            reads++;
+            if (!cst816_read(&t, &rep)) {
+                continue;
+            }
+        }
+
+        switch (rep.event) {
+        case CST816_EV_PRESS:
+            violations += down;
+            down = true;
+            break;
+        case CST816_EV_MOVE:
+            violations += !down || (rep.x == last_x && rep.y == last_y);
+            break;
+        case CST816_EV_RELEASE:
+            violations += !down || rep.x != last_x || rep.y != last_y;
+            down = false;
+            break;
+        default:
+            break;
+        }
+        if (rep.event != CST816_EV_NONE) {
+            violations += rep.x >= LCD_H_RES || rep.y >= LCD_V_RES;
+            last_x = rep.x;
+            last_y = rep.y;
+        }
+        violations += (down != t.down);
+    }
+    cst816_report_t rep = cst816_force_release(&t);
+    violations += (down && rep.event != CST816_EV_RELEASE) || t.down;
+
+    *ns_per_read = (bench_now_ns() - start) / (reads ? reads : 1);
+    return violations;
+}
+
+int main(int argc, char **argv)
+{
+    const char *baseline;
+    const char *write_to;
+    if (!bench_parse_args(argc, argv, &baseline, &write_to)) {
+        return 2;
+    }
+
+    uint32_t txn_extra = 0;
+    uint32_t wrong = run_script(&txn_extra);
+    printf("script     %d steps: %u wrong, %u extra bus transactions\n",
+           (int)(sizeof(s_script) / sizeof(s_script[0])), (unsigned)wrong, (unsigned)txn_extra);
+    bench_metric_add("script", "wrong_events", wrong);
+    bench_metric_add("script", "extra_transactions", txn_extra);
+
+    uint64_t ns_per_read = 0;
+    uint32_t violations = run_fuzz(&ns_per_read);
+    printf("fuzz       %d steps: %u invariant violations, %llu ns per read, state %zu B\n",
+           FUZZ_STEPS, (unsigned)violations, (unsigned long long)ns_per_read, sizeof(cst816_t));
+    bench_metric_add("fuzz", "violations", violations);
+
+    return bench_baseline_finish("touch_bench", baseline, write_to);
+}
@@ -0,0 +1,504 @@
+#include "analog_face.h"
+
+#include <math.h>
+#include <string.h>
+
+#include "panel_config.h"
+
+#define CENTER      (LCD_H_RES / 2)
+#define OCTANT_N    (LCD_H_RES / 2)
+#define ROW_SPANS   4      // dirty intervals kept per row; more are merged into the nearest
+#define SPAN_GAP    4      // intervals closer than this are joined
+#define HAND_COUNT  3
+#define DEG_TO_RAD  0.017453293f
+
+// Dial: 60 radial ticks, every fifth long and bright, and a thin ring.
+#define TICK_OUTER      172.0f
+#define TICK_HOUR_INNER 146.0f
+#define TICK_HOUR_HW    3.0f
+#define TICK_MIN_INNER  161.0f
+#define TICK_MIN_HW     1.0f
+#define TICK_MIN_INK    140
+#define RING_R          177.0f
+#define RING_HW         1.0f
+#define RING_INK        90
+#define CAP_R           6.0f
+
+typedef struct {
+    uint8_t r;
+    uint8_t g;
+    uint8_t b;
+} rgb_t;
+
+typedef struct {
+    float ax;        // tail end
+    float ay;
+    float bx;        // tip
+    float by;
+    float hw;        // half width
+    rgb_t color;
+    int16_t angle;   // tenths of a degree, for change detection
+} hand_t;
+
+typedef struct {
+    int x0;
+    int x1;
+    int y0;
+    int y1;
+    uint32_t covered;
+    bool extended;
+} rect_t;
+
+static const rgb_t s_bg = {0x00, 0x00, 0x00};
+static const rgb_t s_ink = {0xE8, 0xE8, 0xE8};
+static const rgb_t s_hand_color = {0xF0, 0xF0, 0xF0};
+static const rgb_t s_second_synced = {0xFF, 0x45, 0x3A};
+static const rgb_t s_second_unsynced = {0x70, 0x70, 0x70};
+
+static analog_face_sink_t s_sink;
+static uint8_t s_dial[OCTANT_N * (OCTANT_N + 1) / 2];
+static bool s_drawn = false;
+static hand_t s_shown[HAND_COUNT];   // hour, minute, second as on the panel
+static hand_t s_next[HAND_COUNT];
+
+static int16_t s_span_x0[LCD_V_RES][ROW_SPANS];
+static int16_t s_span_x1[LCD_V_RES][ROW_SPANS];
+static uint8_t s_span_n[LCD_V_RES];
+static int s_dirty_y0 = LCD_V_RES;
+static int s_dirty_y1 = -1;
+static analog_face_stats_t s_stats;
+
+static float clampf(float v, float lo, float hi)
+{
+    return v < lo ? lo : (v > hi ? hi : v);
+}
+
+// Distance from (px, py) to the segment a-b.
+static float seg_dist(float px, float py, float ax, float ay, float bx, float by)
+{
+    float dx = bx - ax;
+    float dy = by - ay;
+    float len2 = dx * dx + dy * dy;
+    float t = len2 > 0.0f ? clampf(((px - ax) * dx + (py - ay) * dy) / len2, 0.0f, 1.0f) : 0.0f;
+    float ex = px - (ax + t * dx);
+    float ey = py - (ay + t * dy);
+    return sqrtf(ex * ex + ey * ey);
+}
+
+// Pixel coverage of a stroke of half width hw at distance d from its centre line.
+static float coverage(float d, float hw)
+{
+    return clampf(hw + 0.5f - d, 0.0f, 1.0f);
+}
+
+static void blend(rgb_t *c, rgb_t fg, float a)
+{
+    int a8 = (int)(a * 256.0f);
+    c->r = (uint8_t)(c->r + (((fg.r - c->r) * a8) >> 8));
+    c->g = (uint8_t)(c->g + (((fg.g - c->g) * a8) >> 8));
+    c->b = (uint8_t)(c->b + (((fg.b - c->b) * a8) >> 8));
+}
+
+// The dial is symmetric under both axis flips and the diagonal swap, so one
+// octant (0 <= v <= u, in pixels from the centre) describes all of it.
+static void dial_build(void)
+{
+    for (int u = 0; u < OCTANT_N; u++) {
+        for (int v = 0; v <= u; v++) {
+            float px = (float)u + 0.5f;
+            float py = (float)v + 0.5f;
+            float r = sqrtf(px * px + py * py);
+            float ink = coverage(fabsf(r - RING_R), RING_HW) * RING_INK;
+            // Ticks at 0..48 degrees from the axis cover everything that reaches this octant.
+            for (int k = 0; k <= 8; k++) {
+                bool hour = (k % 5) == 0;
+                float s = sinf((float)(k * 6) * DEG_TO_RAD);
+                float c = cosf((float)(k * 6) * DEG_TO_RAD);
+                float inner = hour ? TICK_HOUR_INNER : TICK_MIN_INNER;
+                float d = seg_dist(px, py, c * inner, s * inner, c * TICK_OUTER, s * TICK_OUTER);
+                float a = coverage(d, hour ? TICK_HOUR_HW : TICK_MIN_HW) * (hour ? 255.0f : TICK_MIN_INK);
+                ink = a > ink ? a : ink;
+            }
+            s_dial[u * (u + 1) / 2 + v] = (uint8_t)(ink + 0.5f);
+        }
+    }
+}
+
+static uint8_t dial_ink(int x, int y)
+{
+    int u = x < CENTER ? CENTER - 1 - x : x - CENTER;
+    int v = y < CENTER ? CENTER - 1 - y : y - CENTER;
+    if (v > u) {
+        int t = u;
+        u = v;
+        v = t;
+    }
+    return s_dial[u * (u + 1) / 2 + v];
+}
+
+// angle_deg is clockwise from 12 o'clock; the hand runs from `tail` behind the centre to `len` in front.
+static void hand_pose(hand_t *h, float angle_deg, float len, float tail, float hw, rgb_t color)
+{
+    float s = sinf(angle_deg * DEG_TO_RAD);
+    float c = cosf(angle_deg * DEG_TO_RAD);
+    h->ax = CENTER - s * tail;
+    h->ay = CENTER + c * tail;
+    h->bx = CENTER + s * len;
+    h->by = CENTER - c * len;
+    h->hw = hw;
+    h->color = color;
+    h->angle = (int16_t)lrintf(angle_deg * 10.0f);
+}
+
+static bool hand_same(const hand_t *a, const hand_t *b)
+{
+    return a->angle == b->angle && a->hw == b->hw && memcmp(&a->color, &b->color, sizeof(rgb_t)) == 0;
+}
+
+// Narrows [*lo, *hi] to the x where lo_c <= k*x + m <= hi_c.
+static void clip_linear(float k, float m, float lo_c, float hi_c, float *lo, float *hi)
+{
+    if (fabsf(k) < 1e-6f) {
+        if (m < lo_c || m > hi_c) {
+            *lo = 1.0f;
+            *hi = 0.0f;
+        }
+        return;
+    }
+    float a = (lo_c - m) / k;
+    float b = (hi_c - m) / k;
+    if (a > b) {
+        float t = a;
+        a = b;
+        b = t;
+    }
+    *lo = a > *lo ? a : *lo;
+    *hi = b < *hi ? b : *hi;
+}
+
+static void span_union(float *lo, float *hi, float a, float b)
+{
+    if (a > b) {
+        return;
+    }
+    if (*lo > *hi) {
+        *lo = a;
+        *hi = b;
+        return;
+    }
+    *lo = a < *lo ? a : *lo;
+    *hi = b > *hi ? b : *hi;
+}
+
+static void disc_row(float cx, float cy, float r, float yc, float *lo, float *hi)
+{
+    float dy = yc - cy;
+    if (fabsf(dy) < r) {
+        float w = sqrtf(r * r - dy * dy);
+        span_union(lo, hi, cx - w, cx + w);
+    }
+}
+
+// Pixels of row y whose centres a stroke of half width hw around a-b reaches.
+// The stroke is convex, so its cut through the row is one interval: the two
+// end discs plus the band between them.
+static bool stroke_row_span(float ax, float ay, float bx, float by, float hw, int y, int *x0, int *x1)
+{
+    float yc = (float)y + 0.5f;
+    float r = hw + 0.5f;
+    float lo = 1.0f;
+    float hi = 0.0f;
+    disc_row(ax, ay, r, yc, &lo, &hi);
+    disc_row(bx, by, r, yc, &lo, &hi);
+
+    float dx = bx - ax;
+    float dy = by - ay;
+    float len = sqrtf(dx * dx + dy * dy);
+    if (len > 0.0f) {
+        dx /= len;
+        dy /= len;
+        float blo = -1e9f;
+        float bhi = 1e9f;
+        // Across the stroke: |-dy*(X-ax) + dx*(yc-ay)| < r; along it: 0 <= dx*(X-ax) + dy*(yc-ay) <= len.
+        clip_linear(-dy, dy * ax + dx * (yc - ay), -r, r, &blo, &bhi);
+        clip_linear(dx, -dx * ax + dy * (yc - ay), 0.0f, len, &blo, &bhi);
+        span_union(&lo, &hi, blo, bhi);
+    }
+    if (lo > hi) {
+        return false;
+    }
+    *x0 = (int)ceilf(lo - 0.5f);
+    *x1 = (int)floorf(hi - 0.5f);
+    if (*x0 < 0) {
+        *x0 = 0;
+    }
+    if (*x1 > LCD_H_RES - 1) {
+        *x1 = LCD_H_RES - 1;
+    }
+    return *x0 <= *x1;
+}
+
+static void span_add(int y, int x0, int x1)
+{
+    if (y < 0 || y >= LCD_V_RES) {
+        return;
+    }
+    x0 = x0 < 0 ? 0 : x0;
+    x1 = x1 > LCD_H_RES - 1 ? LCD_H_RES - 1 : x1;
+    if (x0 > x1) {
+        return;
+    }
+    s_dirty_y0 = y < s_dirty_y0 ? y : s_dirty_y0;
+    s_dirty_y1 = y > s_dirty_y1 ? y : s_dirty_y1;
+
+    int16_t *sx0 = s_span_x0[y];
+    int16_t *sx1 = s_span_x1[y];
+    int n = s_span_n[y];
+
+    // Swallow every interval that touches the new one.
+    for (int i = 0; i < n;) {
+        if (x0 <= sx1[i] + SPAN_GAP && x1 >= sx0[i] - SPAN_GAP) {
+            x0 = sx0[i] < x0 ? sx0[i] : x0;
+            x1 = sx1[i] > x1 ? sx1[i] : x1;
+            sx0[i] = sx0[n - 1];
+            sx1[i] = sx1[n - 1];
+            n--;
+        } else {
+            i++;
+        }
+    }
+    if (n == ROW_SPANS) {
+        // Full: widen the nearest interval instead.
+        int best = 0;
+        int best_gap = LCD_H_RES;
+        for (int i = 0; i < n; i++) {
+            int gap = x0 > sx1[i] ? x0 - sx1[i] : sx0[i] - x1;
+            if (gap < best_gap) {
+                best_gap = gap;
+                best = i;
+            }
+        }
+        sx0[best] = x0 < sx0[best] ? (int16_t)x0 : sx0[best];
+        sx1[best] = x1 > sx1[best] ? (int16_t)x1 : sx1[best];
+        s_span_n[y] = (uint8_t)n;
+        return;
+    }
+    // Keep the row sorted by x so windows can grow down the screen in order.
+    int pos = n;
+    while (pos > 0 && sx0[pos - 1] > x0) {
+        sx0[pos] = sx0[pos - 1];
+        sx1[pos] = sx1[pos - 1];
+        pos--;
+    }
+    sx0[pos] = (int16_t)x0;
+    sx1[pos] = (int16_t)x1;
+    s_span_n[y] = (uint8_t)(n + 1);
+}
+
+static void spans_add_stroke(float ax, float ay, float bx, float by, float hw)
+{
+    float r = hw + 1.0f;
+    int y0 = (int)floorf((ay < by ? ay : by) - r);
+    int y1 = (int)ceilf((ay > by ? ay : by) + r);
+    y0 = y0 < 0 ? 0 : y0;
+    y1 = y1 > LCD_V_RES - 1 ? LCD_V_RES - 1 : y1;
+    for (int y = y0; y <= y1; y++) {
+        int x0;
+        int x1;
+        if (stroke_row_span(ax, ay, bx, by, hw, y, &x0, &x1)) {
+            span_add(y, x0, x1);
+        }
+    }
+}
+
+static void spans_add_hand(const hand_t *h)
+{
+    spans_add_stroke(h->ax, h->ay, h->bx, h->by, h->hw);
+}
+
+// Composes pixels [x0, x0 + w) of row y from the dial and the hands in s_next.
+static void render_row(uint16_t *out, int x0, int w, int y)
+{
+    int hx0[HAND_COUNT + 1];
+    int hx1[HAND_COUNT + 1];
+    for (int i = 0; i < HAND_COUNT; i++) {
+        const hand_t *h = &s_next[i];
+        if (!stroke_row_span(h->ax, h->ay, h->bx, h->by, h->hw, y, &hx0[i], &hx1[i])) {
+            hx0[i] = 1;
+            hx1[i] = 0;
+        }
+    }
+    if (!stroke_row_span(CENTER, CENTER, CENTER, CENTER, CAP_R, y, &hx0[HAND_COUNT], &hx1[HAND_COUNT])) {
+        hx0[HAND_COUNT] = 1;
+        hx1[HAND_COUNT] = 0;
+    }
+
+    float py = (float)y + 0.5f;
+    for (int i = 0; i < w; i++) {
+        int x = x0 + i;
+        float px = (float)x + 0.5f;
+        rgb_t c = s_bg;
+        uint8_t ink = dial_ink(x, y);
+        if (ink) {
+            blend(&c, s_ink, (float)ink / 255.0f);
+        }
+        for (int k = 0; k < HAND_COUNT; k++) {
+            if (x >= hx0[k] && x <= hx1[k]) {
+                const hand_t *h = &s_next[k];
+                blend(&c, h->color, coverage(seg_dist(px, py, h->ax, h->ay, h->bx, h->by), h->hw));
+            }
+        }
+        if (x >= hx0[HAND_COUNT] && x <= hx1[HAND_COUNT]) {
+            float d = sqrtf((px - CENTER) * (px - CENTER) + (py - CENTER) * (py - CENTER));
+            blend(&c, s_next[HAND_COUNT - 1].color, coverage(d, CAP_R));
+        }
+        out[i] = rgb565_be(c.r, c.g, c.b);
+    }
+}
+
+static bool rect_flush(rect_t *r)
+{
+    int w = r->x1 - r->x0 + 1;
+    int y = r->y0;
+    while (y <= r->y1) {
+        size_t capacity = 0;
+        uint16_t *buf = s_sink.acquire(s_sink.ctx, &capacity);
+        if (!buf || capacity < (size_t)w) {
+            return false;
+        }
+        int rows = (int)(capacity / (size_t)w);
+        rows = rows > r->y1 - y + 1 ? r->y1 - y + 1 : rows;
+        for (int k = 0; k < rows; k++) {
+            render_row(buf + (size_t)k * w, r->x0, w, y + k);
+        }
+        s_sink.submit(s_sink.ctx, r->x0, y, w, rows, buf);
+        s_stats.windows++;
+        s_stats.pixels += (uint64_t)w * (uint64_t)rows;
+        y += rows;
+    }
+    s_stats.span_pixels += r->covered;
+    return true;
+}
+
+// Grows windows down the screen over the dirty spans. A span joins the window
+// above it as long as the window's total padding stays under the cost of a
+// window setup, which keeps a slanted hand to a staircase of short windows
+// instead of its bounding box.
+static bool spans_flush(void)
+{
+    rect_t open[ROW_SPANS * 2];
+    int n_open = 0;
+    bool ok = true;
+
+    for (int y = s_dirty_y0; y <= s_dirty_y1 + 1 && ok; y++) {
+        for (int i = 0; i < n_open; i++) {
+            open[i].extended = false;
+        }
+        int n = (y <= s_dirty_y1) ? s_span_n[y] : 0;
+        for (int s = 0; s < n && ok; s++) {
+            int x0 = s_span_x0[y][s];
+            int x1 = s_span_x1[y][s];
+            uint32_t len = (uint32_t)(x1 - x0 + 1);
+            rect_t *hit = NULL;
+            for (int i = 0; i < n_open; i++) {
+                rect_t *r = &open[i];
+                if (!r->extended && x0 <= r->x1 + SPAN_GAP && x1 >= r->x0 - SPAN_GAP) {
+                    hit = r;
+                    break;
+                }
+            }
+            if (hit) {
+                int nx0 = x0 < hit->x0 ? x0 : hit->x0;
+                int nx1 = x1 > hit->x1 ? x1 : hit->x1;
+                int64_t waste = (int64_t)(nx1 - nx0 + 1) * (y - hit->y0 + 1) - (hit->covered + len);
+                if (waste * 2 <= ANALOG_WINDOW_COST_BYTES) {
+                    hit->x0 = nx0;
+                    hit->x1 = nx1;
+                    hit->y1 = y;
+                    hit->covered += len;
+                    hit->extended = true;
+                    continue;
+                }
+                ok = rect_flush(hit);
+                *hit = open[--n_open];
+            }
+            if (n_open < (int)(sizeof(open) / sizeof(open[0]))) {
+                open[n_open++] = (rect_t){x0, x1, y, y, len, true};
+            } else {
+                ok = false;
+            }
+        }
+        // Windows that found nothing below them are complete.
+        for (int i = 0; i < n_open && ok;) {
+            if (!open[i].extended) {
+                ok = rect_flush(&open[i]);
+                open[i] = open[--n_open];
+            } else {
+                i++;
+            }
+        }
+    }
+
+    memset(s_span_n, 0, sizeof(s_span_n));
+    s_dirty_y0 = LCD_V_RES;
+    s_dirty_y1 = -1;
+    return ok;
+}
+
+void analog_face_init(const analog_face_sink_t *sink)
+{
+    s_sink = *sink;
+    dial_build();
+    analog_face_reset();
+}
+
+void analog_face_reset(void)
+{
+    s_drawn = false;
+}
+
+void analog_face_invalidate_rect(int x, int y, int w, int h)
+{
+    for (int row = y; row < y + h; row++) {
+        span_add(row, x, x + w - 1);
+    }
+}
+
+void analog_face_draw(const struct tm *ti, bool synced)
+{
+    int h12 = ti->tm_hour % 12;
+    hand_pose(&s_next[0], (float)h12 * 30.0f + (float)ti->tm_min * 0.5f, 95.0f, 16.0f, 5.0f, s_hand_color);
+    hand_pose(&s_next[1], (float)ti->tm_min * 6.0f, 140.0f, 16.0f, 3.5f, s_hand_color);
+    hand_pose(&s_next[2], (float)ti->tm_sec * 6.0f, 155.0f, 30.0f, 1.25f,
+              synced ? s_second_synced : s_second_unsynced);
+
+    if (!s_drawn) {
+        for (int y = 0; y < LCD_V_RES; y++) {
+            span_add(y, 0, LCD_H_RES - 1);
+        }
+    } else {
+        bool second_changed = !hand_same(&s_shown[2], &s_next[2]);
+        for (int i = 0; i < HAND_COUNT; i++) {
+            if (!hand_same(&s_shown[i], &s_next[i])) {
+                spans_add_hand(&s_shown[i]);
+                spans_add_hand(&s_next[i]);
+            }
+        }
+        if (second_changed) {
+            // The cap takes the second hand's colour.
+            spans_add_stroke(CENTER, CENTER, CENTER, CENTER, CAP_R);
+        }
+    }
+    if (s_dirty_y1 < 0) {
+        return;
+    }
+
+    s_stats.draws++;
+    s_drawn = spans_flush();
+    memcpy(s_shown, s_next, sizeof(s_shown));
+}
+
+void analog_face_get_stats(analog_face_stats_t *out)
+{
+    *out = s_stats;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+
+// Analog face for the round panel: a cached dial and anti-aliased hour, minute
+// and second hands. A draw collects, row by row, the pixel spans the old and
+// new pose of every moved hand cover, merges them into a few windows and
+// recomposes just those from the dial cache and the current hands. A second
+// tick sends a few KB instead of a frame.
+//
+// Pixels are rendered straight into buffers handed out by the sink (DMA arena
+// blocks on the device); no framebuffer. No IDF dependencies.
+
+// Merging two windows into one pays for up to this many padding bytes: roughly
+// what a window setup (CASET/RASET/RAMWR plus a DMA launch) costs on the bus.
+#ifndef ANALOG_WINDOW_COST_BYTES
+#define ANALOG_WINDOW_COST_BYTES 512
+#endif
+
+typedef struct {
+    // A draw buffer; *capacity receives its size in pixels. NULL aborts the draw.
+    uint16_t *(*acquire)(void *ctx, size_t *capacity);
+    // Queues the w*h pixels in buf for (x, y); buf belongs to the sink from here on.
+    void (*submit)(void *ctx, int x, int y, int w, int h, uint16_t *buf);
+    void *ctx;
+} analog_face_sink_t;
+
+typedef struct {
+    uint32_t draws;
+    uint32_t windows;
+    uint64_t pixels;         // sent, merge padding included
+    uint64_t span_pixels;    // actually dirty
+} analog_face_stats_t;
+
+// Builds the dial cache (one octant of 8-bit ink, ~16 KB).
+void analog_face_init(const analog_face_sink_t *sink);
+// Next draw repaints the whole panel.
+void analog_face_reset(void);
+// (x, y, w, h) was drawn over; it is recomposed on the next draw.
+void analog_face_invalidate_rect(int x, int y, int w, int h);
+// The second hand turns grey while the shown time is not known to be correct.
+void analog_face_draw(const struct tm *ti, bool synced);
+// Cumulative since boot.
+void analog_face_get_stats(analog_face_stats_t *out);
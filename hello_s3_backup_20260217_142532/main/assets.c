@@ -0,0 +1,130 @@
+#include "assets.h"
+
+#include <stdbool.h>
+#include <string.h>
+
+#include "esp_log.h"
+#include "esp_partition.h"
+
+#ifndef ASSETS_MAX
+#define ASSETS_MAX 32
+#endif
+
+typedef struct __attribute__((packed)) {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t count;
+    uint32_t image_bytes;
+} assets_header_t;
+
+typedef struct __attribute__((packed)) {
+    char name[ASSETS_NAME_LEN];
+    uint16_t width;
+    uint16_t height;
+    uint32_t offset;
+    uint32_t bytes;
+    uint8_t encoding;
+    uint8_t reserved[3];
+} assets_entry_t;
+
+static const char *TAG = "assets";
+
+static esp_partition_mmap_handle_t s_map_handle;
+static const uint8_t *s_image = NULL;
+static asset_t s_assets[ASSETS_MAX];
+static char s_names[ASSETS_MAX][ASSETS_NAME_LEN + 1];
+static int s_count = 0;
+
+bool assets_init(void)
+{
+    const esp_partition_t *part = esp_partition_find_first(
+        ESP_PARTITION_TYPE_DATA, (esp_partition_subtype_t)ASSETS_PARTITION_SUBTYPE, ASSETS_PARTITION);
+    if (!part) {
+        ESP_LOGW(TAG, "no \"%s\" partition", ASSETS_PARTITION);
+        return false;
+    }
+
+    assets_header_t hdr;
+    if (esp_partition_read(part, 0, &hdr, sizeof(hdr)) != ESP_OK ||
+        hdr.magic != ASSETS_MAGIC || hdr.version != ASSETS_VERSION ||
+        hdr.image_bytes < sizeof(hdr) || hdr.image_bytes > part->size) {
+        ESP_LOGW(TAG, "partition holds no asset image (flash tools/png_to_assets.py output)");
+        return false;
+    }
+    size_t dir_end = sizeof(hdr) + (size_t)hdr.count * sizeof(assets_entry_t);
+    if (dir_end > hdr.image_bytes) {
+        ESP_LOGW(TAG, "directory overruns image");
+        return false;
+    }
+
+    // Only the used part is mapped; the MMU works in 64 KiB pages, so this keeps cache pages free.
+    const void *ptr = NULL;
+    esp_err_t err = esp_partition_mmap(part, 0, hdr.image_bytes, ESP_PARTITION_MMAP_DATA, &ptr, &s_map_handle);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "mmap failed: %s", esp_err_to_name(err));
+        return false;
+    }
+    s_image = ptr;
+
+    const assets_entry_t *entries = (const assets_entry_t *)(s_image + sizeof(hdr));
+
+    s_count = 0;
+    for (uint16_t i = 0; i < hdr.count && s_count < ASSETS_MAX; i++) {
+        assets_entry_t e;
+        memcpy(&e, &entries[i], sizeof(e));
+        bool raw = e.encoding == ASSET_ENCODING_RAW;
+        if ((!raw && e.encoding != ASSET_ENCODING_Q565) ||
+            (raw && e.bytes != (uint32_t)e.width * e.height * sizeof(uint16_t)) ||
+            e.width == 0 || e.height == 0 || (e.offset & 1u) != 0 ||
+            e.offset < dir_end || e.bytes > hdr.image_bytes - e.offset) {
+            ESP_LOGW(TAG, "skip entry %u: bad geometry or encoding", (unsigned)i);
+            continue;
+        }
+        memcpy(s_names[s_count], e.name, ASSETS_NAME_LEN);
+        s_names[s_count][ASSETS_NAME_LEN] = '\0';
+        s_assets[s_count] = (asset_t){
+            .name = s_names[s_count],
+            .width = e.width,
+            .height = e.height,
+            .encoding = (asset_encoding_t)e.encoding,
+            .bytes = e.bytes,
+            .data = s_image + e.offset,
+            .pixels = raw ? (const uint16_t *)(s_image + e.offset) : NULL,
+        };
+        s_count++;
+    }
+    if (hdr.count > ASSETS_MAX) {
+        ESP_LOGW(TAG, "%u assets, only the first %d are used", (unsigned)hdr.count, ASSETS_MAX);
+    }
+
+    if (s_count == 0) {
+        // Nothing usable; give the cache pages back.
+        esp_partition_munmap(s_map_handle);
+        s_image = NULL;
+        ESP_LOGW(TAG, "no usable assets in image");
+        return false;
+    }
+
+    ESP_LOGI(TAG, "mapped %u bytes at %p, %d assets", (unsigned)hdr.image_bytes, ptr, s_count);
+    return true;
+}
+
+const asset_t *assets_find(const char *name)
+{
+    for (int i = 0; name && i < s_count; i++) {
+        if (strncmp(s_assets[i].name, name, ASSETS_NAME_LEN) == 0) {
+            return &s_assets[i];
+        }
+    }
+    return NULL;
+}
+
+int assets_count(void)
+{
+    return s_count;
+}
+
+const asset_t *assets_at(int index)
+{
+    return (index >= 0 && index < s_count) ? &s_assets[index] : NULL;
+}
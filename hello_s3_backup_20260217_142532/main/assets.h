@@ -0,0 +1,44 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Read-only image assets in the "assets" data partition, produced on the host
+// by tools/png_to_assets.py and mapped into the address space at boot. Raw
+// assets are already RGB565 big-endian (LCD_RGB_DATA_ENDIAN_BIG), so drawing
+// one is a plain copy; large ones are Q565 streams (q565.h) decoded band by
+// band into the draw blocks.
+//
+// Image layout, little-endian:
+//   header   "CLKA", u16 version, u16 count, u32 image_bytes
+//   entries  count x {char name[16] (NUL padded), u16 width, u16 height,
+//                     u32 offset, u32 bytes, u8 encoding, 3 pad}
+//   data     bytes per entry at offset
+
+#define ASSETS_MAGIC          0x414B4C43u   // "CLKA"
+#define ASSETS_VERSION        2
+#define ASSETS_NAME_LEN       16
+#define ASSETS_PARTITION      "assets"
+#define ASSETS_PARTITION_SUBTYPE 0x40
+
+typedef enum {
+    ASSET_ENCODING_RAW = 0,
+    ASSET_ENCODING_Q565 = 1,
+} asset_encoding_t;
+
+typedef struct {
+    const char *name;
+    uint16_t width;
+    uint16_t height;
+    asset_encoding_t encoding;
+    uint32_t bytes;
+    const void *data;         // points into mapped flash
+    const uint16_t *pixels;   // same as data for raw assets, NULL otherwise
+} asset_t;
+
+// Maps the partition and validates the directory. Returns false when there is
+// no partition or no valid image; every lookup then misses.
+bool assets_init(void);
+const asset_t *assets_find(const char *name);
+int assets_count(void);
+const asset_t *assets_at(int index);
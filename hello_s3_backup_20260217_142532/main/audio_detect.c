@@ -0,0 +1,177 @@
+#include "audio_detect.h"
+
+#include <string.h>
+
+#define HP_POLE_Q15         30893            // ~150 Hz corner: DC, mains hum, footstep thumps
+#define FLOOR_MIN_LEVEL     (8 * 256)        // about RMS 16; digital silence must not pull it lower
+#define FLOOR_RISE          1                // per frame, ~0.7 dB/s
+#define PLAYBACK_HOLD       8                // frames, covers the beep drain
+
+#define CLAP_ONSET          AUDIO_DB(12)     // rise over the quieter of the two previous frames
+#define CLAP_ABOVE_FLOOR    AUDIO_DB(24)
+#define CLAP_ZCR_MIN        48               // onset and peak frames; a 1 kHz tone is ~32, a clap ~60..130
+#define CLAP_DECAY          AUDIO_DB(12)     // drop from the peak that confirms it
+#define CLAP_MAX_FRAMES     6                // ~96 ms; anything longer is not a clap
+#define DOUBLE_WINDOW       35               // ~560 ms for the second clap
+
+#define VOICE_ABOVE_FLOOR   AUDIO_DB(9)
+#define VOICE_ZCR_MIN       6                // mains hum is ~2
+#define VOICE_ZCR_MAX       100              // broadband noise is ~128
+#define VOICE_MIN_FRAMES    12               // ~190 ms of active frames
+#define VOICE_HANG          14               // ~220 ms of inactive frames bridged between syllables
+#define VOICE_MOD           AUDIO_DB(6)      // syllables; a fan or tone stays flat
+
+static int32_t level_q8(uint32_t v)
+{
+    if (v == 0) {
+        return 0;
+    }
+    int msb = 31 - __builtin_clz(v);
+    uint32_t frac = (msb >= 8) ? (v >> (msb - 8)) : (v << (8 - msb));
+    return msb * 256 + (int32_t)(frac & 0xFF);
+}
+
+void audio_detect_init(audio_detect_t *d)
+{
+    memset(d, 0, sizeof(*d));
+    d->floor = FLOOR_MIN_LEVEL;
+}
+
+void audio_detect_set_playback(audio_detect_t *d, bool active)
+{
+    if (d->playback && !active) {
+        d->playback_hold = PLAYBACK_HOLD;
+    }
+    d->playback = active;
+}
+
+static void voice_reset(audio_detect_t *d)
+{
+    d->voice_frames = 0;
+    d->voice_gap = 0;
+    d->voice_reported = false;
+}
+
+audio_event_t audio_detect_frame(audio_detect_t *d, const int16_t *pcm)
+{
+    // Features: high-passed energy and zero crossings in one pass.
+    int32_t x1 = d->hp_x;
+    int32_t y1 = d->hp_y;
+    bool neg = y1 < 0;
+    uint32_t energy = 0;
+    uint16_t zcr = 0;
+    for (int i = 0; i < AUDIO_DETECT_FRAME; i++) {
+        int32_t x = pcm[i];
+        int32_t y = x - x1 + ((y1 * HP_POLE_Q15) >> 15);
+        y = y > 32767 ? 32767 : (y < -32767 ? -32767 : y);
+        x1 = x;
+        y1 = y;
+        energy += (uint32_t)(y * y) >> 8;
+        bool n = y < 0;
+        zcr += (n != neg);
+        neg = n;
+    }
+    d->hp_x = x1;
+    d->hp_y = y1;
+
+    int32_t level = level_q8(energy);
+    d->level = level;
+    d->zcr = zcr;
+    d->frames++;
+    if (!d->primed) {
+        d->primed = true;
+        d->level_1 = d->level_2 = level;
+        d->floor = level > FLOOR_MIN_LEVEL ? level : FLOOR_MIN_LEVEL;
+    }
+
+    bool playback = d->playback || d->playback_hold > 0;
+    if (!d->playback && d->playback_hold > 0) {
+        d->playback_hold--;
+    }
+
+    // Floor: falls fast, rises slowly; held while the speaker or a clap is on.
+    if (!playback && d->clap_frames == 0) {
+        if (level < d->floor) {
+            d->floor -= (d->floor - level + 3) / 4;
+        } else {
+            d->floor += (level - d->floor) < FLOOR_RISE ? (level - d->floor) : FLOOR_RISE;
+        }
+        if (d->floor < FLOOR_MIN_LEVEL) {
+            d->floor = FLOOR_MIN_LEVEL;
+        }
+    }
+
+    // Clap: sharp broadband onset, confirmed by a quick decay.
+    int32_t before = d->level_1 < d->level_2 ? d->level_1 : d->level_2;
+    bool clap_confirmed = false;
+    if (d->clap_frames == 0) {
+        if (level - before >= CLAP_ONSET && level - d->floor >= CLAP_ABOVE_FLOOR && zcr >= CLAP_ZCR_MIN) {
+            d->clap_frames = 1;
+            d->clap_peak = level;
+            d->clap_peak_zcr = zcr;
+        }
+    } else {
+        d->clap_frames++;
+        if (level > d->clap_peak) {
+            d->clap_peak = level;
+            d->clap_peak_zcr = zcr;
+        }
+        if (level <= d->clap_peak - CLAP_DECAY) {
+            d->clap_frames = 0;
+            clap_confirmed = d->clap_peak_zcr >= CLAP_ZCR_MIN;   // a thump peaks low
+        } else if (d->clap_frames > CLAP_MAX_FRAMES) {
+            d->clap_frames = 0;
+        }
+    }
+    d->level_2 = d->level_1;
+    d->level_1 = level;
+
+    audio_event_t ev = AUDIO_EV_NONE;
+    if (clap_confirmed) {
+        d->claps_pending++;
+        d->since_clap = 0;
+        voice_reset(d);
+        if (d->claps_pending >= 2) {
+            d->claps_pending = 0;
+            ev = AUDIO_EV_DOUBLE_CLAP;
+        }
+    } else if (d->claps_pending > 0 && ++d->since_clap > DOUBLE_WINDOW) {
+        d->claps_pending = 0;
+        ev = AUDIO_EV_CLAP;
+    }
+
+    // Voice: enough modulated, mid-ZCR frames above the floor, small gaps bridged.
+    bool active = !playback && d->clap_frames == 0 && !clap_confirmed &&
+                  level - d->floor >= VOICE_ABOVE_FLOOR && zcr >= VOICE_ZCR_MIN && zcr <= VOICE_ZCR_MAX;
+    if (active) {
+        if (d->voice_frames == 0) {
+            d->voice_min = d->voice_max = level;
+        }
+        d->voice_frames++;
+        d->voice_gap = 0;
+        d->voice_min = level < d->voice_min ? level : d->voice_min;
+        d->voice_max = level > d->voice_max ? level : d->voice_max;
+    } else if (d->voice_frames > 0 && ++d->voice_gap > VOICE_HANG) {
+        voice_reset(d);
+    }
+    if (ev == AUDIO_EV_NONE && !d->voice_reported && d->voice_frames >= VOICE_MIN_FRAMES &&
+        d->voice_max - d->voice_min >= VOICE_MOD) {
+        d->voice_reported = true;
+        ev = AUDIO_EV_VOICE;
+    }
+    return ev;
+}
+
+const char *audio_event_name(audio_event_t ev)
+{
+    switch (ev) {
+    case AUDIO_EV_CLAP:
+        return "clap";
+    case AUDIO_EV_DOUBLE_CLAP:
+        return "double_clap";
+    case AUDIO_EV_VOICE:
+        return "voice";
+    default:
+        return "none";
+    }
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Clap and voice-activity detection on 16 kHz mono PCM, one fixed-size frame
+// at a time. Integer only: a ~150 Hz high-pass, frame energy as log2 in Q8
+// (256 units per octave of power, about 3 dB), zero-crossing count and a slow
+// noise-floor tracker. A clap is a broadband onset well above the floor that decays within
+// ~100 ms; voice is sustained, modulated, mid-ZCR energy above the floor.
+//
+// No IDF dependencies: bench/audio_bench.c runs the same code on the host.
+
+#define AUDIO_DETECT_RATE_HZ 16000
+#define AUDIO_DETECT_FRAME   256   // samples, 16 ms
+
+// Level units: log2(energy) in Q8, so 1 dB is ~85 units.
+#define AUDIO_DB(db) ((int32_t)((db) * 85))
+
+typedef enum {
+    AUDIO_EV_NONE,
+    AUDIO_EV_CLAP,          // reported once the double-clap window has passed
+    AUDIO_EV_DOUBLE_CLAP,
+    AUDIO_EV_VOICE,         // once per speech segment
+} audio_event_t;
+
+typedef struct {
+    int32_t hp_x;            // high-pass input/output memory
+    int32_t hp_y;
+    int32_t floor;           // noise floor level
+    int32_t level_1;         // level one and two frames back
+    int32_t level_2;
+    bool primed;
+    bool playback;           // speaker active: voice off, floor frozen
+    uint8_t playback_hold;   // frames playback still counts after it ends
+
+    uint8_t clap_frames;     // frames since an open clap onset, 0 if none
+    int32_t clap_peak;
+    uint16_t clap_peak_zcr;
+    uint8_t claps_pending;   // confirmed but not yet reported
+    uint8_t since_clap;
+
+    uint16_t voice_frames;   // active frames in the current segment
+    uint8_t voice_gap;
+    bool voice_reported;
+    int32_t voice_min;
+    int32_t voice_max;
+
+    int32_t level;           // last frame's features, for logging and the bench
+    uint16_t zcr;
+    uint32_t frames;
+} audio_detect_t;
+
+void audio_detect_init(audio_detect_t *d);
+// Tells the detector the speaker is (or stops) playing. Kept on for a few
+// frames after it ends to cover the output drain and capture latency.
+void audio_detect_set_playback(audio_detect_t *d, bool active);
+// pcm holds AUDIO_DETECT_FRAME samples. Returns at most one event per frame.
+audio_event_t audio_detect_frame(audio_detect_t *d, const int16_t *pcm);
+const char *audio_event_name(audio_event_t ev);
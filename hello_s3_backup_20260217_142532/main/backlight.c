@@ -0,0 +1,241 @@
+#include "backlight.h"
+
+#include <stdatomic.h>
+
+#include "driver/ledc.h"
+#include "esp_attr.h"
+#include "esp_err.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+
+#define BACKLIGHT_MODE        LEDC_LOW_SPEED_MODE
+#define BACKLIGHT_CHANNEL     LEDC_CHANNEL_0
+#define BACKLIGHT_TIMER       LEDC_TIMER_0
+// RC_FAST keeps the backlight PWM (and the fade unit) running through light sleep; ~17.5 MHz caps 10-bit PWM near 17 kHz.
+#define BACKLIGHT_PWM_HZ      16000
+
+#ifndef BACKLIGHT_DEFAULT_PERCENT
+#define BACKLIGHT_DEFAULT_PERCENT 60
+#endif
+
+// First light after boot: quick, the panel already holds a full frame.
+#ifndef BACKLIGHT_BOOT_FADE_MS
+#define BACKLIGHT_BOOT_FADE_MS 300
+#endif
+
+#ifndef BACKLIGHT_SCHEDULE_FADE_MS
+#define BACKLIGHT_SCHEDULE_FADE_MS 4000
+#endif
+
+typedef struct {
+    uint8_t hour;
+    uint8_t minute;
+    uint8_t percent;
+} backlight_schedule_entry_t;
+
+// Sorted by start time; each level holds until the next entry and the last one wraps past midnight.
+static const backlight_schedule_entry_t s_schedule[] = {
+    {0, 30, 8},
+    {7, 0, 70},
+    {19, 0, 50},
+    {22, 0, 20},
+};
+
+// 10-bit duty for perceived brightness 0..100 %: CIE 1931 L* -> relative luminance.
+// Y = L / 903.3 for L <= 8, ((L + 16) / 116)^3 otherwise, scaled to 1023.
+static const uint16_t s_gamma_lut[101] = {
+       0,    1,    2,    3,    5,    6,    7,    8,    9,   10,
+      12,   13,   14,   16,   18,   20,   21,   24,   26,   28,
+      31,   33,   36,   39,   42,   45,   49,   52,   56,   60,
+      64,   68,   72,   77,   82,   87,   92,   98,  103,  109,
+     115,  121,  128,  135,  142,  149,  156,  164,  172,  180,
+     188,  197,  206,  215,  225,  235,  245,  255,  266,  276,
+     288,  299,  311,  323,  336,  348,  361,  375,  388,  402,
+     417,  432,  447,  462,  478,  494,  510,  527,  544,  562,
+     580,  598,  617,  636,  655,  675,  696,  716,  737,  759,
+     781,  803,  826,  849,  872,  896,  921,  946,  971,  997,
+    1023,
+};
+
+static const char *TAG = "backlight";
+
+static atomic_bool s_fading = false;
+static atomic_uint s_fade_end_irqs = 0;
+static volatile int64_t s_fade_end_us = 0;
+static int64_t s_fade_start_us = 0;
+static uint32_t s_fade_req_ms = 0;
+static uint32_t s_fades_started = 0;
+static uint32_t s_fades_deferred = 0;
+static uint32_t s_start_cost_us_max = 0;
+static uint8_t s_percent = 0;         // programmed into the hardware
+static int s_target_percent = -1;     // latest request, possibly still pending
+static uint32_t s_pending_fade_ms = 0;
+static bool s_pending = false;
+static bool s_initialized = false;
+
+static bool IRAM_ATTR backlight_fade_end_cb(const ledc_cb_param_t *param, void *user_arg)
+{
+    (void)user_arg;
+    if (param->event == LEDC_FADE_END_EVT) {
+        s_fade_end_us = esp_timer_get_time();
+        atomic_fetch_add_explicit(&s_fade_end_irqs, 1, memory_order_relaxed);
+        atomic_store_explicit(&s_fading, false, memory_order_release);
+    }
+    return false;
+}
+
+static void backlight_start_fade(uint8_t percent, uint32_t fade_ms)
+{
+    if (fade_ms == 0) {
+        fade_ms = 1;  // the fade unit is the only duty path, so "instant" is a one-period ramp
+    }
+
+    int64_t start_us = esp_timer_get_time();
+    atomic_store_explicit(&s_fading, true, memory_order_relaxed);
+    esp_err_t err = ledc_set_fade_with_time(BACKLIGHT_MODE, BACKLIGHT_CHANNEL, s_gamma_lut[percent], (int)fade_ms);
+    if (err == ESP_OK) {
+        err = ledc_fade_start(BACKLIGHT_MODE, BACKLIGHT_CHANNEL, LEDC_FADE_NO_WAIT);
+    }
+    if (err != ESP_OK) {
+        atomic_store(&s_fading, false);
+        ESP_LOGW(TAG, "fade to %u%% failed: %s", (unsigned)percent, esp_err_to_name(err));
+        return;
+    }
+    int64_t end_us = esp_timer_get_time();
+
+    uint32_t cost_us = (uint32_t)(end_us - start_us);
+    if (cost_us > s_start_cost_us_max) {
+        s_start_cost_us_max = cost_us;
+    }
+    s_fade_start_us = start_us;
+    s_fade_req_ms = fade_ms;
+    s_fades_started++;
+    s_percent = percent;
+}
+
+void backlight_init(int gpio)
+{
+    ledc_timer_config_t timer_cfg = {
+        .speed_mode = BACKLIGHT_MODE,
+        .duty_resolution = LEDC_TIMER_10_BIT,
+        .timer_num = BACKLIGHT_TIMER,
+        .freq_hz = BACKLIGHT_PWM_HZ,
+        .clk_cfg = LEDC_USE_RC_FAST_CLK,
+    };
+    ledc_channel_config_t channel_cfg = {
+        .gpio_num = gpio,
+        .speed_mode = BACKLIGHT_MODE,
+        .channel = BACKLIGHT_CHANNEL,
+        .timer_sel = BACKLIGHT_TIMER,
+        .duty = 0,
+        .hpoint = 0,
+        .intr_type = LEDC_INTR_DISABLE,
+        .flags.output_invert = 0,
+    };
+    ESP_ERROR_CHECK(ledc_timer_config(&timer_cfg));
+    ESP_ERROR_CHECK(ledc_channel_config(&channel_cfg));
+
+    // The fade ISR only fires at the end of a ramp; the steps are generated by the LEDC itself.
+    ESP_ERROR_CHECK(ledc_fade_func_install(0));
+    ledc_cbs_t cbs = {
+        .fade_cb = backlight_fade_end_cb,
+    };
+    ESP_ERROR_CHECK(ledc_cb_register(BACKLIGHT_MODE, BACKLIGHT_CHANNEL, &cbs, NULL));
+    s_initialized = true;
+}
+
+void backlight_fade_to(uint8_t percent, uint32_t fade_ms)
+{
+    if (!s_initialized) {
+        return;
+    }
+    if (percent > 100) {
+        percent = 100;
+    }
+    s_target_percent = percent;
+
+    if (atomic_load_explicit(&s_fading, memory_order_acquire)) {
+        // Starting now would block on the driver's fade semaphore; pick it up on a later tick.
+        s_pending = true;
+        s_pending_fade_ms = fade_ms;
+        s_fades_deferred++;
+        return;
+    }
+    s_pending = false;
+    if (s_gamma_lut[percent] == s_gamma_lut[s_percent] && s_fades_started > 0) {
+        s_percent = percent;
+        return;
+    }
+    backlight_start_fade(percent, fade_ms);
+}
+
+static uint8_t backlight_schedule_level(const struct tm *ti)
+{
+    const size_t count = sizeof(s_schedule) / sizeof(s_schedule[0]);
+    int now_min = ti->tm_hour * 60 + ti->tm_min;
+    uint8_t level = s_schedule[count - 1].percent;
+    for (size_t i = 0; i < count; i++) {
+        if (s_schedule[i].hour * 60 + s_schedule[i].minute > now_min) {
+            break;
+        }
+        level = s_schedule[i].percent;
+    }
+    return level;
+}
+
+void backlight_schedule_tick(const struct tm *ti, bool time_valid)
+{
+    if (!s_initialized) {
+        return;
+    }
+    if (s_pending && !atomic_load_explicit(&s_fading, memory_order_acquire)) {
+        backlight_fade_to((uint8_t)s_target_percent, s_pending_fade_ms);
+    }
+
+    uint8_t level = (time_valid && ti) ? backlight_schedule_level(ti) : BACKLIGHT_DEFAULT_PERCENT;
+    if (level != s_target_percent) {
+        backlight_fade_to(level, s_fades_started == 0 ? BACKLIGHT_BOOT_FADE_MS : BACKLIGHT_SCHEDULE_FADE_MS);
+    }
+}
+
+void backlight_get_stats(backlight_stats_t *out)
+{
+    if (!out) {
+        return;
+    }
+    bool fading = atomic_load(&s_fading);
+    out->fades_started = s_fades_started;
+    out->fade_end_irqs = atomic_load(&s_fade_end_irqs);
+    out->fades_deferred = s_fades_deferred;
+    out->start_cost_us_max = s_start_cost_us_max;
+    out->last_fade_ms = (!fading && s_fade_end_us > s_fade_start_us)
+                            ? (uint32_t)((s_fade_end_us - s_fade_start_us) / 1000)
+                            : 0;
+    out->last_fade_req_ms = s_fade_req_ms;
+    out->percent = s_percent;
+    out->fading = fading;
+}
+
+void backlight_log_stats(void)
+{
+    static uint32_t reported_started = 0;
+
+    backlight_stats_t st;
+    backlight_get_stats(&st);
+    if (st.fades_started == reported_started) {
+        return;
+    }
+    reported_started = st.fades_started;
+
+    // Only the fade-end interrupt is enabled, so the CPU sees exactly one wake per ramp;
+    // a mismatch means a lost or repeated fade-end.
+    uint32_t expected_irqs = st.fades_started - (st.fading ? 1 : 0);
+    ESP_LOGI(TAG, "level=%u%% duty=%u fades=%u end_irqs=%u deferred=%u start_cost_max_us=%u last_ramp_ms=%u/%u",
+             (unsigned)st.percent, (unsigned)s_gamma_lut[st.percent], (unsigned)st.fades_started,
+             (unsigned)st.fade_end_irqs, (unsigned)st.fades_deferred, (unsigned)st.start_cost_us_max,
+             (unsigned)st.last_fade_ms, (unsigned)st.last_fade_req_ms);
+    if (st.fade_end_irqs != expected_irqs) {
+        ESP_LOGW(TAG, "fade interrupts %u != completed fades %u",
+                 (unsigned)st.fade_end_irqs, (unsigned)expected_irqs);
+    }
+}
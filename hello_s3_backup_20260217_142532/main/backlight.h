@@ -0,0 +1,33 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+
+// Backlight on the LEDC hardware fade unit. Levels are perceived brightness in
+// percent and go through a CIE L* gamma table; ramps run entirely in hardware
+// and only the fade-end interrupt reaches the CPU.
+//
+// Not thread-safe: app_main owns it until the clock task starts, then the
+// clock task is the only caller.
+
+typedef struct {
+    uint32_t fades_started;
+    uint32_t fade_end_irqs;      // one per completed fade, nothing during the ramp
+    uint32_t fades_deferred;     // requests parked behind a running fade
+    uint32_t start_cost_us_max;  // CPU time to program and launch a fade
+    uint32_t last_fade_ms;       // measured launch to fade-end interrupt
+    uint32_t last_fade_req_ms;
+    uint8_t percent;             // last level handed to the hardware
+    bool fading;
+} backlight_stats_t;
+
+void backlight_init(int gpio);
+// Ramps to percent over fade_ms. If a fade is running the request is kept and
+// started by backlight_schedule_tick() once the hardware is free.
+void backlight_fade_to(uint8_t percent, uint32_t fade_ms);
+// Call once per clock tick; applies the time-of-day dimming table while the
+// wall clock is trustworthy.
+void backlight_schedule_tick(const struct tm *ti, bool time_valid);
+void backlight_get_stats(backlight_stats_t *out);
+void backlight_log_stats(void);
@@ -0,0 +1,659 @@
+#include "clock_face.h"
+
+#include <stddef.h>
+#include <string.h>
+
+#include "panel_config.h"
+
+enum {
+    SEG_A = 1 << 0,
+    SEG_B = 1 << 1,
+    SEG_C = 1 << 2,
+    SEG_D = 1 << 3,
+    SEG_E = 1 << 4,
+    SEG_F = 1 << 5,
+    SEG_G = 1 << 6,
+};
+
+static const uint8_t s_digit_mask[10] = {
+    SEG_A | SEG_B | SEG_C | SEG_D | SEG_E | SEG_F,
+    SEG_B | SEG_C,
+    SEG_A | SEG_B | SEG_D | SEG_E | SEG_G,
+    SEG_A | SEG_B | SEG_C | SEG_D | SEG_G,
+    SEG_B | SEG_C | SEG_F | SEG_G,
+    SEG_A | SEG_C | SEG_D | SEG_F | SEG_G,
+    SEG_A | SEG_C | SEG_D | SEG_E | SEG_F | SEG_G,
+    SEG_A | SEG_B | SEG_C,
+    SEG_A | SEG_B | SEG_C | SEG_D | SEG_E | SEG_F | SEG_G,
+    SEG_A | SEG_B | SEG_C | SEG_D | SEG_F | SEG_G,
+};
+
+#define DIGIT_W 36
+#define DIGIT_H 84
+#define SEG_W   7
+#define COLON_W 6
+#define GAP     6
+#define SEG_COUNT 7
+
+// Starting guess for the frame renderer's cost until the first frames have been timed.
+#define ANIM_NS_PER_PX_INIT 40
+
+typedef struct {
+    int digit_x[6];
+    int colon_x[2];
+    int y;
+} face_layout_t;
+
+typedef struct {
+    int x;
+    int y;
+    int w;
+    int h;
+} box_t;
+
+typedef struct {
+    uint8_t r;
+    uint8_t g;
+    uint8_t b;
+} rgb_t;
+
+typedef enum {
+    ANIM_IDLE,      // waiting for the window before the next edge
+    ANIM_RUNNING,
+    ANIM_DONE,      // landed, or nothing to animate into this edge
+} anim_phase_t;
+
+// One digit's part of a transition. region holds every pixel any of its frames may touch.
+typedef struct {
+    bool active;
+    int8_t from;
+    int8_t to;
+    box_t region;
+} digit_anim_t;
+
+static const rgb_t s_bg_rgb = {0x00, 0x00, 0x00};
+static const rgb_t s_digit_rgb[6] = {
+    {0xD9, 0x54, 0x75}, {0xD9, 0x54, 0x75},
+    {0xF3, 0x9A, 0x8F}, {0xF3, 0x9A, 0x8F},
+    {0xF2, 0xD3, 0xBF}, {0xF2, 0xD3, 0xBF},
+};
+
+static clock_face_fill_fn s_fill = NULL;
+static bool s_initialized = false;
+static bool s_last_synced = false;
+static bool s_colons_dirty = false;
+static int s_last_digits[6] = {-1, -1, -1, -1, -1, -1};
+
+static struct {
+    bool enabled;
+    clock_anim_sink_t sink;
+    clock_anim_config_t cfg;
+    anim_phase_t phase;
+    clock_anim_style_t style;   // cfg.style, or cheaper when that does not fit the budget
+    int64_t edge_us;
+    int64_t start_us;
+    int64_t period_us;
+    int next_slot;              // frame slots count from start_us; slot 0 is the old state
+    bool skip_next;             // the last frame went over the CPU budget
+    uint32_t ns_per_px;         // measured render cost, smoothed
+    digit_anim_t digits[6];
+    clock_anim_stats_t stats;
+} s_anim;
+
+void clock_face_init(clock_face_fill_fn fill)
+{
+    s_fill = fill;
+    clock_face_reset();
+}
+
+void clock_face_reset(void)
+{
+    s_initialized = false;
+    s_last_synced = false;
+    s_colons_dirty = false;
+    for (int i = 0; i < 6; i++) {
+        s_last_digits[i] = -1;
+    }
+    s_anim.phase = ANIM_IDLE;
+    s_anim.edge_us = 0;
+}
+
+void clock_face_set_anim(const clock_anim_sink_t *sink, const clock_anim_config_t *cfg)
+{
+    memset(&s_anim, 0, sizeof(s_anim));
+    s_anim.ns_per_px = ANIM_NS_PER_PX_INIT;
+    if (!sink || !cfg || cfg->style == CLOCK_ANIM_NONE || cfg->fps == 0 || cfg->duration_ms == 0) {
+        return;
+    }
+    s_anim.sink = *sink;
+    s_anim.cfg = *cfg;
+    s_anim.period_us = 1000000LL / cfg->fps;
+    s_anim.enabled = true;
+}
+
+void clock_face_get_anim_stats(clock_anim_stats_t *out)
+{
+    *out = s_anim.stats;
+}
+
+static void face_layout(face_layout_t *l)
+{
+    int total_w = (6 * DIGIT_W) + (2 * COLON_W) + (7 * GAP);
+    int x = (LCD_H_RES - total_w) / 2;
+    l->y = (LCD_V_RES - DIGIT_H) / 2;
+    for (int i = 0; i < 6; i++) {
+        l->digit_x[i] = x;
+        x += DIGIT_W;
+
+        if (i == 1 || i == 3) {
+            x += GAP;
+            l->colon_x[i / 2] = x;
+            x += COLON_W;
+        }
+        x += GAP;
+    }
+}
+
+static bool overlaps(int ax, int aw, int bx, int bw)
+{
+    return ax < bx + bw && bx < ax + aw;
+}
+
+void clock_face_invalidate_rect(int x, int y, int w, int h)
+{
+    face_layout_t l;
+    face_layout(&l);
+    if (!s_initialized || !overlaps(y, h, l.y, DIGIT_H)) {
+        return;
+    }
+    for (int i = 0; i < 6; i++) {
+        if (overlaps(x, w, l.digit_x[i], DIGIT_W)) {
+            s_last_digits[i] = -1;
+        }
+    }
+    for (int i = 0; i < 2; i++) {
+        if (overlaps(x, w, l.colon_x[i], COLON_W)) {
+            s_colons_dirty = true;
+        }
+    }
+}
+
+static void draw_colon(int x, int y, int digit_h, int dot_size, uint16_t color)
+{
+    int top_y = y + digit_h / 3;
+    int bottom_y = y + (digit_h * 2) / 3;
+    s_fill(x, top_y, dot_size, dot_size, color);
+    s_fill(x, bottom_y, dot_size, dot_size, color);
+}
+
+// Segment rectangles of a digit at (x, y), indexed like the SEG_ bits.
+static void digit_segments(int x, int y, int digit_w, int digit_h, int seg_w, box_t seg[SEG_COUNT])
+{
+    int mid_y = y + digit_h / 2 - seg_w / 2;
+    int upper_h = mid_y - (y + seg_w);
+    int lower_y = mid_y + seg_w;
+    int lower_h = (y + digit_h - seg_w) - lower_y;
+
+    if (upper_h < 1) {
+        upper_h = 1;
+    }
+    if (lower_h < 1) {
+        lower_h = 1;
+    }
+
+    seg[0] = (box_t){x + seg_w, y, digit_w - 2 * seg_w, seg_w};
+    seg[1] = (box_t){x + digit_w - seg_w, y + seg_w, seg_w, upper_h};
+    seg[2] = (box_t){x + digit_w - seg_w, lower_y, seg_w, lower_h};
+    seg[3] = (box_t){x + seg_w, y + digit_h - seg_w, digit_w - 2 * seg_w, seg_w};
+    seg[4] = (box_t){x, lower_y, seg_w, lower_h};
+    seg[5] = (box_t){x, y + seg_w, seg_w, upper_h};
+    seg[6] = (box_t){x + seg_w, mid_y, digit_w - 2 * seg_w, seg_w};
+}
+
+static void draw_digit_mask(int x, int y, int digit_w, int digit_h, int seg_w, uint8_t mask, uint16_t color)
+{
+    box_t seg[SEG_COUNT];
+    digit_segments(x, y, digit_w, digit_h, seg_w, seg);
+    for (int k = 0; k < SEG_COUNT; k++) {
+        if (mask & (1U << k)) {
+            s_fill(seg[k].x, seg[k].y, seg[k].w, seg[k].h, color);
+        }
+    }
+}
+
+static void draw_digit_value(int x, int y, int digit_w, int digit_h, int seg_w, int value, uint16_t color)
+{
+    if (value < 0 || value > 9) {
+        return;
+    }
+    draw_digit_mask(x, y, digit_w, digit_h, seg_w, s_digit_mask[value], color);
+}
+
+static uint16_t rgb_to_panel(rgb_t c)
+{
+    return rgb565_be(c.r, c.g, c.b);
+}
+
+// from moved towards to by a/256; a = 256 gives exactly to.
+static rgb_t rgb_mix(rgb_t from, rgb_t to, int a)
+{
+    rgb_t c = {
+        (uint8_t)(from.r + (((to.r - from.r) * a) >> 8)),
+        (uint8_t)(from.g + (((to.g - from.g) * a) >> 8)),
+        (uint8_t)(from.b + (((to.b - from.b) * a) >> 8)),
+    };
+    return c;
+}
+
+// Bounding box of a and b; a zero-width box is empty.
+static box_t box_union(box_t a, box_t b)
+{
+    if (a.w <= 0) {
+        return b;
+    }
+    int x1 = (a.x + a.w > b.x + b.w) ? a.x + a.w : b.x + b.w;
+    int y1 = (a.y + a.h > b.y + b.h) ? a.y + a.h : b.y + b.h;
+    a.x = a.x < b.x ? a.x : b.x;
+    a.y = a.y < b.y ? a.y : b.y;
+    a.w = x1 - a.x;
+    a.h = y1 - a.y;
+    return a;
+}
+
+static bool box_clip(box_t *b, box_t clip)
+{
+    int x0 = b->x > clip.x ? b->x : clip.x;
+    int y0 = b->y > clip.y ? b->y : clip.y;
+    int x1 = (b->x + b->w < clip.x + clip.w) ? b->x + b->w : clip.x + clip.w;
+    int y1 = (b->y + b->h < clip.y + clip.h) ? b->y + b->h : clip.y + clip.h;
+    *b = (box_t){x0, y0, x1 - x0, y1 - y0};
+    return b->w > 0 && b->h > 0;
+}
+
+// r shortened along its long side to f/256 of it, about its centre.
+static box_t box_scale(box_t r, int f)
+{
+    if (r.w >= r.h) {
+        int w = (r.w * f + 128) >> 8;
+        r.x += (r.w - w) / 2;
+        r.w = w;
+    } else {
+        int h = (r.h * f + 128) >> 8;
+        r.y += (r.h - h) / 2;
+        r.h = h;
+    }
+    return r;
+}
+
+static void paint(uint16_t *buf, box_t band, box_t r, uint16_t color)
+{
+    if (!box_clip(&r, band)) {
+        return;
+    }
+    for (int y = r.y; y < r.y + r.h; y++) {
+        uint16_t *row = buf + (size_t)(y - band.y) * band.w + (r.x - band.x);
+        for (int x = 0; x < r.w; x++) {
+            row[x] = color;
+        }
+    }
+}
+
+static box_t digit_box(const face_layout_t *l, int i)
+{
+    return (box_t){l->digit_x[i], l->y, DIGIT_W, DIGIT_H};
+}
+
+// What a style's frames of digit i may touch: the digit for a slide, the segments that change otherwise.
+static box_t anim_region(const face_layout_t *l, int i, int from, int to, clock_anim_style_t style)
+{
+    if (style == CLOCK_ANIM_SLIDE) {
+        return digit_box(l, i);
+    }
+    box_t seg[SEG_COUNT];
+    digit_segments(l->digit_x[i], l->y, DIGIT_W, DIGIT_H, SEG_W, seg);
+    uint8_t changed = s_digit_mask[from] ^ s_digit_mask[to];
+    box_t r = {0, 0, 0, 0};
+    for (int k = 0; k < SEG_COUNT; k++) {
+        if (changed & (1U << k)) {
+            r = box_union(r, seg[k]);
+        }
+    }
+    return r;
+}
+
+// Renders the rows of band (inside digit i's region) at progress a/256. a = 256 is the new digit
+// alone, whatever the style, so the last frame never depends on how the others were drawn.
+static void render_digit(uint16_t *buf, box_t band, const face_layout_t *l, int i, clock_anim_style_t style, int a)
+{
+    const digit_anim_t *d = &s_anim.digits[i];
+    uint8_t m0 = s_digit_mask[d->from];
+    uint8_t m1 = s_digit_mask[d->to];
+    const rgb_t fg = s_digit_rgb[i];
+    const uint16_t fg_px = rgb_to_panel(fg);
+    const uint16_t bg_px = rgb_to_panel(s_bg_rgb);
+    box_t seg[SEG_COUNT];
+
+    size_t n = (size_t)band.w * band.h;
+    for (size_t k = 0; k < n; k++) {
+        buf[k] = bg_px;
+    }
+    if (a >= 256) {
+        style = CLOCK_ANIM_NONE;
+    }
+
+    if (style == CLOCK_ANIM_SLIDE) {
+        int off = (DIGIT_H * a) >> 8;
+        digit_segments(l->digit_x[i], l->y + off, DIGIT_W, DIGIT_H, SEG_W, seg);
+        for (int k = 0; k < SEG_COUNT; k++) {
+            if (m0 & (1U << k)) {
+                paint(buf, band, seg[k], fg_px);
+            }
+        }
+        digit_segments(l->digit_x[i], l->y + off - DIGIT_H, DIGIT_W, DIGIT_H, SEG_W, seg);
+        for (int k = 0; k < SEG_COUNT; k++) {
+            if (m1 & (1U << k)) {
+                paint(buf, band, seg[k], fg_px);
+            }
+        }
+        return;
+    }
+
+    digit_segments(l->digit_x[i], l->y, DIGIT_W, DIGIT_H, SEG_W, seg);
+    for (int k = 0; k < SEG_COUNT; k++) {
+        bool on0 = (m0 & (1U << k)) != 0;
+        bool on1 = (m1 & (1U << k)) != 0;
+        if (style == CLOCK_ANIM_NONE ? !on1 : !(on0 || on1)) {
+            continue;
+        }
+        box_t r = seg[k];
+        uint16_t color = fg_px;
+        if (style != CLOCK_ANIM_NONE && on0 != on1) {
+            int lit = on1 ? a : 256 - a;
+            if (style == CLOCK_ANIM_FADE) {
+                color = rgb_to_panel(rgb_mix(s_bg_rgb, fg, lit));
+            } else {
+                r = box_scale(r, lit);
+            }
+        }
+        paint(buf, band, r, color);
+    }
+}
+
+// Renders and queues every active digit's region at progress a/256, band by band through the sink.
+// Returns false when the sink ran out of buffers part way.
+static bool anim_send(int a, clock_anim_style_t style)
+{
+    const clock_anim_sink_t *sink = &s_anim.sink;
+    face_layout_t l;
+    face_layout(&l);
+
+    int64_t t0 = sink->now_us(sink->ctx);
+    uint32_t px = 0;
+    bool ok = true;
+    for (int i = 0; i < 6 && ok; i++) {
+        const digit_anim_t *d = &s_anim.digits[i];
+        if (!d->active) {
+            continue;
+        }
+        for (int y = d->region.y; y < d->region.y + d->region.h;) {
+            size_t capacity = 0;
+            uint16_t *buf = sink->acquire(sink->ctx, &capacity);
+            int rows = buf ? (int)(capacity / (size_t)d->region.w) : 0;
+            if (rows < 1) {
+                ok = false;
+                break;
+            }
+            if (rows > d->region.y + d->region.h - y) {
+                rows = d->region.y + d->region.h - y;
+            }
+            box_t band = {d->region.x, y, d->region.w, rows};
+            render_digit(buf, band, &l, i, style, a);
+            sink->submit(sink->ctx, band.x, band.y, band.w, band.h, buf);
+            px += (uint32_t)(band.w * band.h);
+            y += rows;
+        }
+    }
+    uint32_t us = (uint32_t)(sink->now_us(sink->ctx) - t0);
+
+    clock_anim_stats_t *st = &s_anim.stats;
+    st->bytes += (uint64_t)px * 2;
+    st->cpu_us += us;
+    if (us > st->cpu_us_max) {
+        st->cpu_us_max = us;
+    }
+    if (ok) {
+        st->frames++;
+    }
+    if (px > 0) {
+        s_anim.ns_per_px = (3 * s_anim.ns_per_px + (uint32_t)((uint64_t)us * 1000 / px)) / 4;
+    }
+    s_anim.skip_next = us > s_anim.cfg.frame_cpu_us;
+    return ok;
+}
+
+static void next_second_digits(const struct tm *ti, int out[6])
+{
+    int h = ti->tm_hour;
+    int m = ti->tm_min;
+    int s = ti->tm_sec + 1;
+    if (s >= 60) {
+        s = 0;
+        m++;
+    }
+    if (m >= 60) {
+        m = 0;
+        h++;
+    }
+    if (h >= 24) {
+        h = 0;
+    }
+    out[0] = h / 10;
+    out[1] = h % 10;
+    out[2] = m / 10;
+    out[3] = m % 10;
+    out[4] = s / 10;
+    out[5] = s % 10;
+}
+
+// Picks the digits that change one second after `shown` and the richest style whose frames fit the
+// budget. False when there is nothing to animate.
+static bool anim_begin(const struct tm *shown)
+{
+    int next[6];
+    next_second_digits(shown, next);
+    face_layout_t l;
+    face_layout(&l);
+
+    clock_anim_style_t style = s_anim.cfg.style;
+    while (style != CLOCK_ANIM_NONE) {
+        uint32_t px = 0;
+        for (int i = 0; i < 6; i++) {
+            digit_anim_t *d = &s_anim.digits[i];
+            d->active = s_last_digits[i] >= 0 && s_last_digits[i] <= 9 && next[i] != s_last_digits[i];
+            if (!d->active) {
+                continue;
+            }
+            d->from = (int8_t)s_last_digits[i];
+            d->to = (int8_t)next[i];
+            d->region = anim_region(&l, i, d->from, d->to, style);
+            px += (uint32_t)(d->region.w * d->region.h);
+        }
+        if (px == 0) {
+            return false;
+        }
+        uint32_t est_us = (uint32_t)((uint64_t)px * s_anim.ns_per_px / 1000);
+        if (px * 2 <= s_anim.cfg.frame_bus_bytes && est_us <= s_anim.cfg.frame_cpu_us) {
+            break;
+        }
+        style = (clock_anim_style_t)(style - 1);
+    }
+    if (style != s_anim.cfg.style) {
+        s_anim.stats.simplified++;
+    }
+    if (style == CLOCK_ANIM_NONE) {
+        for (int i = 0; i < 6; i++) {
+            s_anim.digits[i].active = false;
+        }
+        return false;
+    }
+    s_anim.style = style;
+    s_anim.next_slot = 1;
+    s_anim.skip_next = false;
+    s_anim.stats.transitions++;
+    return true;
+}
+
+// Final frame: every region at the new digit. A digit invalidated meanwhile gets its whole box.
+static void anim_land(void)
+{
+    face_layout_t l;
+    face_layout(&l);
+    for (int i = 0; i < 6; i++) {
+        digit_anim_t *d = &s_anim.digits[i];
+        if (d->active && s_last_digits[i] < 0) {
+            d->region = digit_box(&l, i);
+        }
+    }
+    if (!anim_send(256, CLOCK_ANIM_NONE)) {
+        const uint16_t bg = rgb_to_panel(s_bg_rgb);
+        for (int i = 0; i < 6; i++) {
+            const digit_anim_t *d = &s_anim.digits[i];
+            if (d->active) {
+                s_fill(d->region.x, d->region.y, d->region.w, d->region.h, bg);
+                draw_digit_value(l.digit_x[i], l.y, DIGIT_W, DIGIT_H, SEG_W, d->to, rgb_to_panel(s_digit_rgb[i]));
+            }
+        }
+    }
+    for (int i = 0; i < 6; i++) {
+        if (s_anim.digits[i].active) {
+            s_last_digits[i] = s_anim.digits[i].to;
+            s_anim.digits[i].active = false;
+        }
+    }
+    s_anim.phase = ANIM_DONE;
+}
+
+int64_t clock_face_animate(const struct tm *shown, int64_t now_us, int64_t edge_us)
+{
+    if (!s_anim.enabled || !s_initialized || !s_fill) {
+        return 0;
+    }
+    if (edge_us != s_anim.edge_us) {
+        if (s_anim.phase == ANIM_RUNNING) {
+            anim_land();
+        }
+        s_anim.phase = ANIM_IDLE;
+        s_anim.edge_us = edge_us;
+        s_anim.start_us = edge_us - (int64_t)s_anim.cfg.duration_ms * 1000;
+    }
+    if (s_anim.phase == ANIM_DONE) {
+        return 0;
+    }
+    if (s_anim.phase == ANIM_IDLE) {
+        if (now_us < s_anim.start_us) {
+            return s_anim.start_us;
+        }
+        if (!anim_begin(shown)) {
+            s_anim.phase = ANIM_DONE;
+            return 0;
+        }
+        s_anim.phase = ANIM_RUNNING;
+    }
+    if (now_us >= edge_us) {
+        anim_land();
+        return 0;
+    }
+
+    int slot = (int)((now_us - s_anim.start_us) / s_anim.period_us);
+    if (slot >= s_anim.next_slot) {
+        // Slots that went by while the caller was not running count as dropped too.
+        s_anim.stats.dropped += (uint32_t)(slot - s_anim.next_slot);
+        if (s_anim.skip_next || s_anim.sink.busy(s_anim.sink.ctx)) {
+            s_anim.stats.dropped++;
+            s_anim.skip_next = false;
+        } else {
+            // Progress follows the slot, not the wake-up time, so frames stay evenly spaced.
+            int a = (int)((int64_t)slot * s_anim.period_us * 256 / (edge_us - s_anim.start_us));
+            if (!anim_send(a, s_anim.style)) {
+                s_anim.stats.dropped++;
+            }
+        }
+        s_anim.next_slot = slot + 1;
+    }
+    int64_t next_us = s_anim.start_us + (int64_t)s_anim.next_slot * s_anim.period_us;
+    return next_us < edge_us ? next_us : edge_us;
+}
+
+void clock_face_draw(const struct tm *ti, bool synced)
+{
+    const uint16_t bg = rgb_to_panel(s_bg_rgb);
+    uint16_t digit_colors[6];
+    for (int i = 0; i < 6; i++) {
+        digit_colors[i] = rgb_to_panel(s_digit_rgb[i]);
+    }
+    const uint16_t colon_color = synced ? rgb565_be(0xF7, 0xF3, 0xE8) : rgb565_be(0x4A, 0x48, 0x44);
+
+    face_layout_t l;
+    face_layout(&l);
+
+    int digits[6] = {
+        ti->tm_hour / 10,
+        ti->tm_hour % 10,
+        ti->tm_min / 10,
+        ti->tm_min % 10,
+        ti->tm_sec / 10,
+        ti->tm_sec % 10
+    };
+
+    if (!s_fill) {
+        return;
+    }
+
+    if (!s_initialized) {
+        s_fill(0, 0, LCD_H_RES, LCD_V_RES, bg);
+        for (int i = 0; i < 6; i++) {
+            draw_digit_value(l.digit_x[i], l.y, DIGIT_W, DIGIT_H, SEG_W, digits[i], digit_colors[i]);
+            s_last_digits[i] = digits[i];
+        }
+        draw_colon(l.colon_x[0], l.y, DIGIT_H, COLON_W, colon_color);
+        draw_colon(l.colon_x[1], l.y, DIGIT_H, COLON_W, colon_color);
+        s_last_synced = synced;
+        s_initialized = true;
+        return;
+    }
+
+    // A new time lands a running transition first (normally the final frame already went out at the
+    // edge). Redraws of the time it started from, e.g. after the touch overlay, leave it running.
+    if (s_anim.phase == ANIM_RUNNING) {
+        for (int i = 0; i < 6; i++) {
+            if (s_last_digits[i] >= 0 && digits[i] != s_last_digits[i]) {
+                anim_land();
+                break;
+            }
+        }
+    }
+
+    if (synced != s_last_synced || s_colons_dirty) {
+        draw_colon(l.colon_x[0], l.y, DIGIT_H, COLON_W, colon_color);
+        draw_colon(l.colon_x[1], l.y, DIGIT_H, COLON_W, colon_color);
+        s_last_synced = synced;
+        s_colons_dirty = false;
+    }
+
+    for (int i = 0; i < 6; i++) {
+        if (digits[i] == s_last_digits[i]) {
+            continue;
+        }
+        uint8_t old_mask = (s_last_digits[i] >= 0 && s_last_digits[i] <= 9) ? s_digit_mask[s_last_digits[i]] : 0;
+        uint8_t new_mask = s_digit_mask[digits[i]];
+        uint8_t turn_off = old_mask & (uint8_t)(~new_mask);
+        uint8_t turn_on = new_mask & (uint8_t)(~old_mask);
+        if (turn_off) {
+            draw_digit_mask(l.digit_x[i], l.y, DIGIT_W, DIGIT_H, SEG_W, turn_off, bg);
+        }
+        if (turn_on) {
+            draw_digit_mask(l.digit_x[i], l.y, DIGIT_W, DIGIT_H, SEG_W, turn_on, digit_colors[i]);
+        }
+        s_last_digits[i] = digits[i];
+    }
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+
+// Seven-segment HH:MM:SS face. It keeps the last drawn digits and only sends
+// segments that change, so all output goes through one fill callback.
+typedef void (*clock_face_fill_fn)(int x, int y, int w, int h, uint16_t color);
+
+void clock_face_init(clock_face_fill_fn fill);
+
+// Forget what is on the panel; the next draw clears the screen and repaints everything.
+void clock_face_reset(void);
+
+// Something else was drawn over (x, y, w, h) and has since been cleared to the
+// background: the digits and colons it touched are repainted whole on the next draw.
+void clock_face_invalidate_rect(int x, int y, int w, int h);
+
+// Colons are drawn dimmed while the shown time is not known to be correct.
+void clock_face_draw(const struct tm *ti, bool synced);
+
+// Digit transitions. Instead of switching at the second edge, digits that are
+// about to change animate during the last duration_ms before it, and the last
+// frame, sent at the edge itself, is exactly the new time. Frames only cover
+// the changing digits and go out through the sink as rendered pixel windows.
+//
+// Ordered by cost: a transition that does not fit the per-frame budget starts
+// in the next cheaper style. Running frames are dropped while the previous one
+// is still on the bus or after one that went over the CPU budget; the final
+// frame is never dropped.
+typedef enum {
+    CLOCK_ANIM_NONE,    // switch at the edge
+    CLOCK_ANIM_FADE,    // changing segments cross-fade
+    CLOCK_ANIM_MORPH,   // segments going off shrink into their centre while new ones grow out of it
+    CLOCK_ANIM_SLIDE,   // the old digit slides down and out as the new one comes in from above
+} clock_anim_style_t;
+
+typedef struct {
+    // A draw buffer; *capacity receives its size in pixels. NULL drops the frame.
+    uint16_t *(*acquire)(void *ctx, size_t *capacity);
+    // Queues the w*h pixels in buf for (x, y); buf belongs to the sink from here on.
+    void (*submit)(void *ctx, int x, int y, int w, int h, uint16_t *buf);
+    // True while earlier windows are still being sent.
+    bool (*busy)(void *ctx);
+    // Clock for timing frames, microseconds.
+    int64_t (*now_us)(void *ctx);
+    void *ctx;
+} clock_anim_sink_t;
+
+// Defaults: 50 fps over the last 300 ms, a frame may take a fifth of its slot on
+// the CPU and about 2.5 ms of the 20 MHz QSPI bus.
+#ifndef CLOCK_ANIM_DURATION_MS
+#define CLOCK_ANIM_DURATION_MS 300
+#endif
+#ifndef CLOCK_ANIM_FPS
+#define CLOCK_ANIM_FPS 50
+#endif
+#ifndef CLOCK_ANIM_FRAME_CPU_US
+#define CLOCK_ANIM_FRAME_CPU_US 4000
+#endif
+#ifndef CLOCK_ANIM_FRAME_BUS_BYTES
+#define CLOCK_ANIM_FRAME_BUS_BYTES (24 * 1024)
+#endif
+
+typedef struct {
+    clock_anim_style_t style;
+    uint16_t duration_ms;       // ends on the second edge
+    uint8_t fps;                // frame slots per second
+    uint32_t frame_cpu_us;      // render time one frame may take
+    uint32_t frame_bus_bytes;   // pixel bytes one frame may send
+} clock_anim_config_t;
+
+typedef struct {
+    uint32_t transitions;   // animated edges
+    uint32_t simplified;    // edges animated in a cheaper style than configured, or not at all
+    uint32_t frames;        // sent, final ones included
+    uint32_t dropped;       // frame slots that went by without a frame
+    uint64_t bytes;
+    uint64_t cpu_us;
+    uint32_t cpu_us_max;
+} clock_anim_stats_t;
+
+// A NULL sink or CLOCK_ANIM_NONE turns transitions off.
+void clock_face_set_anim(const clock_anim_sink_t *sink, const clock_anim_config_t *cfg);
+
+// Call between draws. shown is the time last passed to clock_face_draw(), edge_us
+// when the next second starts and now_us the current time, both on the sink's
+// clock. Starts the transition once the edge is duration_ms away and sends the
+// frame that is due; from edge_us on it sends the final frame. Returns when to
+// call again, or 0 when nothing is left to do before the next draw.
+int64_t clock_face_animate(const struct tm *shown, int64_t now_us, int64_t edge_us);
+
+void clock_face_get_anim_stats(clock_anim_stats_t *out);
@@ -0,0 +1,85 @@
+#include "cst816.h"
+
+#include <string.h>
+
+// Event code in XH[7:6].
+#define CST816_EVENT_DOWN    0
+#define CST816_EVENT_UP      1
+#define CST816_EVENT_CONTACT 2
+
+bool cst816_init(cst816_t *t, const cst816_bus_t *bus, uint16_t width, uint16_t height)
+{
+    memset(t, 0, sizeof(*t));
+    t->bus = *bus;
+    t->width = width;
+    t->height = height;
+
+    // Chip ID, project ID and firmware version are consecutive.
+    const uint8_t reg = CST816_REG_CHIP_ID;
+    uint8_t id[3] = {0};
+    if (!t->bus.write_read(t->bus.ctx, CST816_ADDR, &reg, 1, id, sizeof(id))) {
+        return false;
+    }
+    t->chip_id = id[0];
+    t->fw_version = id[2];
+
+    const uint8_t irq_ctl[2] = {CST816_REG_IRQ_CTL, CST816_IRQ_EN_TOUCH | CST816_IRQ_EN_CHANGE};
+    return t->bus.write(t->bus.ctx, CST816_ADDR, irq_ctl, sizeof(irq_ctl));
+}
+
+bool cst816_read(cst816_t *t, cst816_report_t *out)
+{
+    memset(out, 0, sizeof(*out));
+
+    const uint8_t reg = CST816_REG_GESTURE;
+    uint8_t r[CST816_BURST_BYTES];
+    if (!t->bus.write_read(t->bus.ctx, CST816_ADDR, &reg, 1, r, sizeof(r))) {
+        t->bus_errors++;
+        return false;
+    }
+    t->reads++;
+
+    uint8_t fingers = r[1] & 0x0F;
+    uint8_t event = r[2] >> 6;
+    uint16_t x = (uint16_t)(((r[2] & 0x0F) << 8) | r[3]);
+    uint16_t y = (uint16_t)(((r[4] & 0x0F) << 8) | r[5]);
+    out->gesture = r[0];
+
+    if (fingers == 0 || event == CST816_EVENT_UP) {
+        if (t->down) {
+            t->down = false;
+            out->event = CST816_EV_RELEASE;
+            out->x = t->x;
+            out->y = t->y;
+        }
+        return true;
+    }
+    if (x >= t->width || y >= t->height) {
+        t->out_of_range++;  // glitched frame; keep the last good state
+        return true;
+    }
+
+    if (!t->down) {
+        out->event = CST816_EV_PRESS;
+    } else if (x != t->x || y != t->y) {
+        out->event = CST816_EV_MOVE;
+    }
+    t->down = true;
+    t->x = x;
+    t->y = y;
+    out->x = x;
+    out->y = y;
+    return true;
+}
+
+cst816_report_t cst816_force_release(cst816_t *t)
+{
+    cst816_report_t out = {.event = CST816_EV_NONE};
+    if (t->down) {
+        t->down = false;
+        out.event = CST816_EV_RELEASE;
+        out.x = t->x;
+        out.y = t->y;
+    }
+    return out;
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// CST816-family capacitive touch controller: register protocol and the
+// press/move/release state machine. Bus access goes through callbacks, so the
+// same code runs against i2c_bus on the device and a scripted fake on the host
+// (bench/touch_bench.c). No IDF dependencies.
+//
+// Reads are meant to be driven by the INT line. The controller's own auto-sleep
+// is left on: it NAKs while asleep, but INT only fires once it is awake.
+
+#define CST816_ADDR 0x15
+
+#define CST816_REG_GESTURE  0x01   // burst start: gesture, fingers, XH, XL, YH, YL
+#define CST816_REG_CHIP_ID  0xA7
+#define CST816_REG_FW_VER   0xA9
+#define CST816_REG_IRQ_CTL  0xFA
+
+#define CST816_IRQ_EN_TOUCH   0x40   // pulse INT periodically while touched
+#define CST816_IRQ_EN_CHANGE  0x20   // pulse INT on touch state change
+
+#define CST816_BURST_BYTES 6
+
+typedef struct {
+    // One transaction: write wr, repeated start, read rd. Returns false on NAK/timeout.
+    bool (*write_read)(void *ctx, uint8_t addr, const uint8_t *wr, size_t wr_len, uint8_t *rd, size_t rd_len);
+    bool (*write)(void *ctx, uint8_t addr, const uint8_t *data, size_t len);
+    void *ctx;
+} cst816_bus_t;
+
+typedef enum {
+    CST816_EV_NONE,
+    CST816_EV_PRESS,
+    CST816_EV_MOVE,
+    CST816_EV_RELEASE,
+} cst816_event_t;
+
+typedef struct {
+    cst816_event_t event;
+    uint16_t x;
+    uint16_t y;
+    uint8_t gesture;
+} cst816_report_t;
+
+typedef struct {
+    cst816_bus_t bus;
+    uint16_t width;
+    uint16_t height;
+    uint8_t chip_id;
+    uint8_t fw_version;
+    bool down;
+    uint16_t x;
+    uint16_t y;
+    uint32_t reads;
+    uint32_t bus_errors;
+    uint32_t out_of_range;
+} cst816_t;
+
+// Reads the chip ID and enables touch/change interrupts. Call within the
+// controller's post-reset awake window.
+bool cst816_init(cst816_t *t, const cst816_bus_t *bus, uint16_t width, uint16_t height);
+// One burst read of the touch registers; fills out (EV_NONE when nothing
+// changed). Returns false only on a bus error, which leaves the state as is.
+bool cst816_read(cst816_t *t, cst816_report_t *out);
+// For when INT goes quiet while a finger is down (lift report lost): returns
+// a RELEASE at the last position, or EV_NONE if already up.
+cst816_report_t cst816_force_release(cst816_t *t);
@@ -0,0 +1,173 @@
+#include "dlog.h"
+
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "esp_cpu.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#define DLOG_RING_WORDS      1024  // per core, power of two
+#define DLOG_HDR_WORDS       3     // fmt address, timestamp (us), nargs
+#define DLOG_DRAIN_PERIOD_MS 200
+#define DLOG_DRAIN_PRIO      1
+#define DLOG_DRAIN_STACK     3072
+#define DLOG_LINE_WORDS      48    // raw words per emitted line, whole records only
+#define DLOG_BENCH_CALLS     64
+
+typedef struct {
+    uint32_t words[DLOG_RING_WORDS];
+    atomic_uint head;       // advanced by the owning core with interrupts masked
+    atomic_uint tail;       // advanced by the drain task
+    atomic_uint written;
+    atomic_uint dropped;
+    uint32_t high_water;
+} dlog_ring_t;
+
+static const char *TAG = "dlog";
+
+static dlog_ring_t s_rings[portNUM_PROCESSORS];
+
+void dlog_write(const char *fmt, uint32_t nargs, const uint32_t *args)
+{
+    if (nargs > DLOG_MAX_ARGS) {
+        nargs = DLOG_MAX_ARGS;
+    }
+    uint32_t need = DLOG_HDR_WORDS + nargs;
+    uint32_t ts = (uint32_t)esp_timer_get_time();
+
+    // Each core only ever writes its own ring, so masking local interrupts is
+    // enough to make the writer exclusive; no cross-core lock is taken.
+    UBaseType_t irq = portSET_INTERRUPT_MASK_FROM_ISR();
+    dlog_ring_t *ring = &s_rings[esp_cpu_get_core_id()];
+    unsigned head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    unsigned tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    uint32_t used = head - tail;
+
+    if (DLOG_RING_WORDS - used < need) {
+        atomic_fetch_add_explicit(&ring->dropped, 1, memory_order_relaxed);
+        portCLEAR_INTERRUPT_MASK_FROM_ISR(irq);
+        return;
+    }
+
+    ring->words[head & (DLOG_RING_WORDS - 1)] = (uint32_t)(uintptr_t)fmt;
+    ring->words[(head + 1) & (DLOG_RING_WORDS - 1)] = ts;
+    ring->words[(head + 2) & (DLOG_RING_WORDS - 1)] = nargs;
+    for (uint32_t i = 0; i < nargs; i++) {
+        ring->words[(head + DLOG_HDR_WORDS + i) & (DLOG_RING_WORDS - 1)] = args[i];
+    }
+    atomic_store_explicit(&ring->head, head + need, memory_order_release);
+    atomic_fetch_add_explicit(&ring->written, 1, memory_order_relaxed);
+    if (used + need > ring->high_water) {
+        ring->high_water = used + need;
+    }
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(irq);
+}
+
+void dlog_get_stats(int core, dlog_core_stats_t *out)
+{
+    if (core < 0 || core >= portNUM_PROCESSORS || !out) {
+        return;
+    }
+    out->written = atomic_load(&s_rings[core].written);
+    out->dropped = atomic_load(&s_rings[core].dropped);
+    out->high_water_words = s_rings[core].high_water;
+}
+
+static size_t dlog_base64(const uint8_t *in, size_t len, char *out)
+{
+    static const char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    size_t o = 0;
+    for (size_t i = 0; i < len; i += 3) {
+        uint32_t v = (uint32_t)in[i] << 16;
+        if (i + 1 < len) {
+            v |= (uint32_t)in[i + 1] << 8;
+        }
+        if (i + 2 < len) {
+            v |= in[i + 2];
+        }
+        out[o++] = alphabet[(v >> 18) & 0x3F];
+        out[o++] = alphabet[(v >> 12) & 0x3F];
+        out[o++] = (i + 1 < len) ? alphabet[(v >> 6) & 0x3F] : '=';
+        out[o++] = (i + 2 < len) ? alphabet[v & 0x3F] : '=';
+    }
+    out[o] = '\0';
+    return o;
+}
+
+static void dlog_drain_core(int core)
+{
+    static uint32_t line_words[DLOG_LINE_WORDS];
+    static char line[((DLOG_LINE_WORDS * 4 + 2) / 3) * 4 + 1];
+
+    dlog_ring_t *ring = &s_rings[core];
+    unsigned tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    unsigned head = atomic_load_explicit(&ring->head, memory_order_acquire);
+
+    while (tail != head) {
+        // Pack whole records so every line decodes on its own.
+        uint32_t n = 0;
+        while (tail != head) {
+            uint32_t nargs = ring->words[(tail + 2) & (DLOG_RING_WORDS - 1)];
+            uint32_t len = DLOG_HDR_WORDS + nargs;
+            if (n + len > DLOG_LINE_WORDS) {
+                break;
+            }
+            for (uint32_t i = 0; i < len; i++) {
+                line_words[n++] = ring->words[(tail + i) & (DLOG_RING_WORDS - 1)];
+            }
+            tail += len;
+        }
+        atomic_store_explicit(&ring->tail, tail, memory_order_release);
+
+        dlog_base64((const uint8_t *)line_words, n * sizeof(uint32_t), line);
+        printf("#DL%d %s\n", core, line);
+    }
+}
+
+static void dlog_drain_task(void *arg)
+{
+    (void)arg;
+    uint32_t reported_drops[portNUM_PROCESSORS] = {0};
+
+    while (1) {
+        for (int core = 0; core < portNUM_PROCESSORS; core++) {
+            dlog_drain_core(core);
+
+            uint32_t dropped = atomic_load(&s_rings[core].dropped);
+            if (dropped != reported_drops[core]) {
+                printf("#DLDROP %d %u\n", core, (unsigned)dropped);
+                reported_drops[core] = dropped;
+            }
+        }
+        vTaskDelay(pdMS_TO_TICKS(DLOG_DRAIN_PERIOD_MS));
+    }
+}
+
+void dlog_init(void)
+{
+    for (int core = 0; core < portNUM_PROCESSORS; core++) {
+        atomic_init(&s_rings[core].head, 0);
+        atomic_init(&s_rings[core].tail, 0);
+        atomic_init(&s_rings[core].written, 0);
+        atomic_init(&s_rings[core].dropped, 0);
+        s_rings[core].high_water = 0;
+    }
+
+    // Measure the hot-path cost once so regressions show up in the boot log.
+    int64_t start_us = esp_timer_get_time();
+    for (uint32_t i = 0; i < DLOG_BENCH_CALLS; i++) {
+        DLOG("dlog bench %u %u", i, DLOG_BENCH_CALLS);
+    }
+    int64_t elapsed_us = esp_timer_get_time() - start_us;
+
+    if (xTaskCreate(dlog_drain_task, "dlog", DLOG_DRAIN_STACK, NULL, DLOG_DRAIN_PRIO, NULL) != pdPASS) {
+        ESP_LOGE(TAG, "drain task create failed");
+        return;
+    }
+    ESP_LOGI(TAG, "ready: %u words/core, %u ns per call",
+             (unsigned)DLOG_RING_WORDS, (unsigned)((elapsed_us * 1000) / DLOG_BENCH_CALLS));
+}
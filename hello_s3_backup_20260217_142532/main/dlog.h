@@ -0,0 +1,45 @@
+#pragma once
+
+#include <stdint.h>
+
+// Deferred binary logging. DLOG() stores the format string address, a timestamp
+// and raw 32-bit arguments in a per-core ring; a low-priority task ships the
+// records as "#DL<core> <base64>" lines and tools/dlog_decode.py formats them
+// on the host using the strings in the ELF.
+//
+// Arguments are passed as 32-bit words: integers, chars and pointers to string
+// literals (%s). Floats and 64-bit values are not supported.
+
+#define DLOG_MAX_ARGS 8
+
+typedef struct {
+    uint32_t written;
+    uint32_t dropped;
+    uint32_t high_water_words;
+} dlog_core_stats_t;
+
+void dlog_init(void);
+void dlog_write(const char *fmt, uint32_t nargs, const uint32_t *args);
+void dlog_get_stats(int core, dlog_core_stats_t *out);
+
+#define DLOG_CAST_(x) (uint32_t)(uintptr_t)(x)
+#define DLOG_MAP0()
+#define DLOG_MAP1(a) DLOG_CAST_(a)
+#define DLOG_MAP2(a, ...) DLOG_CAST_(a), DLOG_MAP1(__VA_ARGS__)
+#define DLOG_MAP3(a, ...) DLOG_CAST_(a), DLOG_MAP2(__VA_ARGS__)
+#define DLOG_MAP4(a, ...) DLOG_CAST_(a), DLOG_MAP3(__VA_ARGS__)
+#define DLOG_MAP5(a, ...) DLOG_CAST_(a), DLOG_MAP4(__VA_ARGS__)
+#define DLOG_MAP6(a, ...) DLOG_CAST_(a), DLOG_MAP5(__VA_ARGS__)
+#define DLOG_MAP7(a, ...) DLOG_CAST_(a), DLOG_MAP6(__VA_ARGS__)
+#define DLOG_MAP8(a, ...) DLOG_CAST_(a), DLOG_MAP7(__VA_ARGS__)
+#define DLOG_NARGS_(_0, _1, _2, _3, _4, _5, _6, _7, _8, n, ...) n
+#define DLOG_NARGS(...) DLOG_NARGS_(0, ##__VA_ARGS__, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+#define DLOG_CAT2_(a, b) a##b
+#define DLOG_CAT_(a, b) DLOG_CAT2_(a, b)
+#define DLOG_MAP(n) DLOG_CAT_(DLOG_MAP, n)
+
+// fmt must be a string literal so its address stays valid and is present in the ELF.
+#define DLOG(fmt, ...) do {                                                        \
+        const uint32_t dlog_args_[] = {0, DLOG_MAP(DLOG_NARGS(__VA_ARGS__))(__VA_ARGS__)}; \
+        dlog_write("" fmt, DLOG_NARGS(__VA_ARGS__), dlog_args_ + 1);                 \
+    } while (0)
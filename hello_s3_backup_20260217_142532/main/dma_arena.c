@@ -0,0 +1,136 @@
+#include "dma_arena.h"
+
+#include <stdatomic.h>
+#include <stdbool.h>
+
+#include "esp_attr.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+
+#define DMA_ROUND_UP(n)        (((n) + DMA_ARENA_ALIGN - 1) / DMA_ARENA_ALIGN * DMA_ARENA_ALIGN)
+#define DMA_DRAW_STRIDE        DMA_ROUND_UP(DMA_DRAW_BLOCK_BYTES)
+#define DMA_I2S_STRIDE         DMA_ROUND_UP(DMA_I2S_BLOCK_BYTES)
+#define DMA_DRAW_OFFSET        0
+#define DMA_I2S_OFFSET         (DMA_DRAW_OFFSET + DMA_DRAW_STRIDE * DMA_DRAW_BLOCKS)
+#define DMA_ARENA_BYTES        (DMA_I2S_OFFSET + DMA_I2S_STRIDE * DMA_I2S_BLOCKS)
+
+_Static_assert(DMA_ARENA_BYTES <= DMA_ARENA_BUDGET_BYTES, "DMA arena exceeds DMA_ARENA_BUDGET_BYTES");
+_Static_assert(DMA_DRAW_BLOCKS >= 1 && DMA_DRAW_BLOCKS <= 32, "free mask is one 32-bit word");
+_Static_assert(DMA_I2S_BLOCKS >= 1 && DMA_I2S_BLOCKS <= 32, "free mask is one 32-bit word");
+
+typedef struct {
+    uint32_t offset;
+    uint32_t stride;
+    uint32_t block_bytes;
+    uint32_t blocks;
+} dma_pool_layout_t;
+
+typedef struct {
+    atomic_uint free_mask;   // bit set = block free
+    atomic_uint in_use;
+    atomic_uint high_water;
+    atomic_uint acquires;
+    atomic_uint exhausted;
+} dma_pool_state_t;
+
+static const char *TAG = "dma_arena";
+
+static const dma_pool_layout_t s_layout[DMA_POOL_COUNT] = {
+    [DMA_POOL_DRAW] = {DMA_DRAW_OFFSET, DMA_DRAW_STRIDE, DMA_DRAW_BLOCK_BYTES, DMA_DRAW_BLOCKS},
+    [DMA_POOL_I2S] = {DMA_I2S_OFFSET, DMA_I2S_STRIDE, DMA_I2S_BLOCK_BYTES, DMA_I2S_BLOCKS},
+};
+
+// Reserved at link time in internal DRAM, so it is DMA-capable and never competes with the heap.
+static DMA_ATTR uint8_t s_arena[DMA_ARENA_BYTES] __attribute__((aligned(DMA_ARENA_ALIGN)));
+
+#define DMA_FULL_MASK(n) ((n) >= 32 ? 0xFFFFFFFFu : ((1u << (n)) - 1u))
+
+static dma_pool_state_t s_pools[DMA_POOL_COUNT] = {
+    [DMA_POOL_DRAW] = {.free_mask = DMA_FULL_MASK(DMA_DRAW_BLOCKS)},
+    [DMA_POOL_I2S] = {.free_mask = DMA_FULL_MASK(DMA_I2S_BLOCKS)},
+};
+
+void *IRAM_ATTR dma_arena_acquire(dma_pool_t pool)
+{
+    if ((unsigned)pool >= DMA_POOL_COUNT) {
+        return NULL;
+    }
+    dma_pool_state_t *st = &s_pools[pool];
+    atomic_fetch_add_explicit(&st->acquires, 1, memory_order_relaxed);
+
+    unsigned mask = atomic_load_explicit(&st->free_mask, memory_order_relaxed);
+    unsigned bit;
+    do {
+        if (mask == 0) {
+            atomic_fetch_add_explicit(&st->exhausted, 1, memory_order_relaxed);
+            return NULL;
+        }
+        bit = (unsigned)__builtin_ctz(mask);
+    } while (!atomic_compare_exchange_weak_explicit(&st->free_mask, &mask, mask & ~(1u << bit),
+                                                    memory_order_acquire, memory_order_relaxed));
+
+    unsigned used = atomic_fetch_add_explicit(&st->in_use, 1, memory_order_relaxed) + 1;
+    unsigned hw = atomic_load_explicit(&st->high_water, memory_order_relaxed);
+    while (used > hw &&
+           !atomic_compare_exchange_weak_explicit(&st->high_water, &hw, used,
+                                                  memory_order_relaxed, memory_order_relaxed)) {
+    }
+    return &s_arena[s_layout[pool].offset + bit * s_layout[pool].stride];
+}
+
+void IRAM_ATTR dma_arena_release(dma_pool_t pool, void *block)
+{
+    if ((unsigned)pool >= DMA_POOL_COUNT || !block) {
+        return;
+    }
+    const dma_pool_layout_t *lay = &s_layout[pool];
+    uintptr_t rel = (uintptr_t)block - (uintptr_t)&s_arena[lay->offset];
+    unsigned bit = (unsigned)(rel / lay->stride);
+    if (rel % lay->stride != 0 || bit >= lay->blocks) {
+        return;  // not a block of this pool
+    }
+    dma_pool_state_t *st = &s_pools[pool];
+    atomic_fetch_sub_explicit(&st->in_use, 1, memory_order_relaxed);
+    atomic_fetch_or_explicit(&st->free_mask, 1u << bit, memory_order_release);
+}
+
+size_t dma_arena_block_size(dma_pool_t pool)
+{
+    return ((unsigned)pool < DMA_POOL_COUNT) ? s_layout[pool].block_bytes : 0;
+}
+
+void dma_arena_get_stats(dma_pool_t pool, dma_pool_stats_t *out)
+{
+    if ((unsigned)pool >= DMA_POOL_COUNT || !out) {
+        return;
+    }
+    dma_pool_state_t *st = &s_pools[pool];
+    out->block_bytes = s_layout[pool].block_bytes;
+    out->blocks = s_layout[pool].blocks;
+    out->in_use = atomic_load(&st->in_use);
+    out->high_water = atomic_load(&st->high_water);
+    out->acquires = atomic_load(&st->acquires);
+    out->exhausted = atomic_load(&st->exhausted);
+}
+
+void dma_arena_log_report(void)
+{
+    static const char *names[DMA_POOL_COUNT] = {"draw", "i2s"};
+
+    for (int p = 0; p < DMA_POOL_COUNT; p++) {
+        dma_pool_stats_t st;
+        dma_arena_get_stats((dma_pool_t)p, &st);
+        ESP_LOGI(TAG, "%s: %ux%u B in_use=%u high_water=%u acquires=%u exhausted=%u",
+                 names[p], (unsigned)st.blocks, (unsigned)st.block_bytes, (unsigned)st.in_use,
+                 (unsigned)st.high_water, (unsigned)st.acquires, (unsigned)st.exhausted);
+    }
+
+    // Pools cannot fragment; this tracks what everything else does to the internal DMA heap.
+    size_t free_bytes = heap_caps_get_free_size(MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+    size_t largest = heap_caps_get_largest_free_block(MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+    size_t min_free = heap_caps_get_minimum_free_size(MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+    unsigned frag_pct = free_bytes ? (unsigned)(100 - (largest * 100) / free_bytes) : 0;
+    ESP_LOGI(TAG, "arena=%u B, internal dma heap free=%u largest=%u min_free=%u frag=%u%%",
+             (unsigned)DMA_ARENA_BYTES, (unsigned)free_bytes, (unsigned)largest,
+             (unsigned)min_free, frag_pct);
+}
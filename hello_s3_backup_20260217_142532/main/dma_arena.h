@@ -0,0 +1,57 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "panel_config.h"
+
+// Fixed-size pools of DMA-capable blocks carved out of one static arena in
+// internal RAM. Acquire and release are lock-free and O(1), safe from any core
+// and from ISRs; nothing here touches the heap after link time.
+
+#define DMA_ARENA_ALIGN        32
+
+// One display chunk: DRAW_CHUNK_ROWS full-width RGB565 rows.
+#define DMA_DRAW_BLOCK_BYTES   (LCD_H_RES * DRAW_CHUNK_ROWS * 2)
+#ifndef DMA_DRAW_BLOCKS
+#define DMA_DRAW_BLOCKS        3
+#endif
+
+// One i2s_channel_write() call worth of 16-bit stereo frames.
+#define DMA_I2S_BLOCK_BYTES    2048
+#ifndef DMA_I2S_BLOCKS
+#define DMA_I2S_BLOCKS         2
+#endif
+
+// Internal DMA-capable RAM is shared with Wi-Fi, SPI and I2S driver buffers; stay well under it.
+#ifndef DMA_ARENA_BUDGET_BYTES
+#define DMA_ARENA_BUDGET_BYTES (24 * 1024)
+#endif
+
+typedef enum {
+    DMA_POOL_DRAW,
+    DMA_POOL_I2S,
+    DMA_POOL_COUNT,
+} dma_pool_t;
+
+typedef struct {
+    uint32_t block_bytes;
+    uint32_t blocks;
+    uint32_t in_use;
+    uint32_t high_water;
+    uint32_t acquires;
+    uint32_t exhausted;   // acquire calls that found the pool empty
+} dma_pool_stats_t;
+
+void *dma_arena_acquire(dma_pool_t pool);
+void dma_arena_release(dma_pool_t pool, void *block);
+size_t dma_arena_block_size(dma_pool_t pool);
+void dma_arena_get_stats(dma_pool_t pool, dma_pool_stats_t *out);
+// Pool high-water marks plus free/largest block of the internal DMA heap.
+void dma_arena_log_report(void);
+
+// Rows of a w-pixel-wide RGB565 image that fit one draw block (at least DRAW_CHUNK_ROWS).
+static inline int dma_draw_band_rows(int w)
+{
+    return (w > 0) ? (int)(DMA_DRAW_BLOCK_BYTES / ((unsigned)w * 2U)) : 0;
+}
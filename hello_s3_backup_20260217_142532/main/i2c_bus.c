@@ -0,0 +1,117 @@
+#include "i2c_bus.h"
+
+#include "driver/i2c.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+
+static const char *TAG = "i2c_bus";
+static const char *const s_client_names[I2C_BUS_CLIENT_COUNT] = {"exio", "touch"};
+
+static i2c_port_t s_port = I2C_NUM_0;
+static SemaphoreHandle_t s_lock = NULL;
+static i2c_bus_client_stats_t s_stats[I2C_BUS_CLIENT_COUNT];   // updated under s_lock
+
+esp_err_t i2c_bus_init(int port, int sda, int scl, uint32_t clk_hz)
+{
+    i2c_config_t conf = {
+        .mode = I2C_MODE_MASTER,
+        .sda_io_num = sda,
+        .scl_io_num = scl,
+        .sda_pullup_en = GPIO_PULLUP_ENABLE,
+        .scl_pullup_en = GPIO_PULLUP_ENABLE,
+        .master.clk_speed = clk_hz,
+        .clk_flags = 0,
+    };
+    s_port = (i2c_port_t)port;
+    s_lock = xSemaphoreCreateMutex();
+    if (!s_lock) {
+        return ESP_ERR_NO_MEM;
+    }
+    esp_err_t err = i2c_param_config(s_port, &conf);
+    if (err == ESP_OK) {
+        err = i2c_driver_install(s_port, conf.mode, 0, 0, 0);
+    }
+    return err;
+}
+
+static bool bus_take(i2c_bus_client_t client, int64_t *locked_us)
+{
+    int64_t start_us = esp_timer_get_time();
+    if (xSemaphoreTake(s_lock, pdMS_TO_TICKS(I2C_BUS_LOCK_TIMEOUT_MS)) != pdTRUE) {
+        s_stats[client].lock_timeouts++;   // racy without the lock; only ever a counter
+        return false;
+    }
+    *locked_us = esp_timer_get_time();
+    uint32_t wait_us = (uint32_t)(*locked_us - start_us);
+    i2c_bus_client_stats_t *st = &s_stats[client];
+    st->wait_sum_us += wait_us;
+    if (wait_us > st->wait_max_us) {
+        st->wait_max_us = wait_us;
+    }
+    return true;
+}
+
+static esp_err_t bus_give(i2c_bus_client_t client, int64_t locked_us, esp_err_t err)
+{
+    i2c_bus_client_stats_t *st = &s_stats[client];
+    uint32_t hold_us = (uint32_t)(esp_timer_get_time() - locked_us);
+    st->transactions++;
+    if (err != ESP_OK) {
+        st->errors++;
+    }
+    if (hold_us > st->hold_max_us) {
+        st->hold_max_us = hold_us;
+    }
+    xSemaphoreGive(s_lock);
+    return err;
+}
+
+esp_err_t i2c_bus_write(i2c_bus_client_t client, uint8_t addr, const uint8_t *data, size_t len)
+{
+    int64_t locked_us = 0;
+    if (!s_lock || !bus_take(client, &locked_us)) {
+        return ESP_ERR_TIMEOUT;
+    }
+    esp_err_t err = i2c_master_write_to_device(s_port, addr, data, len, pdMS_TO_TICKS(I2C_BUS_XFER_TIMEOUT_MS));
+    return bus_give(client, locked_us, err);
+}
+
+esp_err_t i2c_bus_write_read(i2c_bus_client_t client, uint8_t addr, const uint8_t *wr, size_t wr_len,
+                             uint8_t *rd, size_t rd_len)
+{
+    int64_t locked_us = 0;
+    if (!s_lock || !bus_take(client, &locked_us)) {
+        return ESP_ERR_TIMEOUT;
+    }
+    esp_err_t err = i2c_master_write_read_device(s_port, addr, wr, wr_len, rd, rd_len,
+                                                 pdMS_TO_TICKS(I2C_BUS_XFER_TIMEOUT_MS));
+    return bus_give(client, locked_us, err);
+}
+
+void i2c_bus_get_stats(i2c_bus_client_t client, i2c_bus_client_stats_t *out)
+{
+    if (client >= I2C_BUS_CLIENT_COUNT || !out || !s_lock) {
+        return;
+    }
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    *out = s_stats[client];
+    xSemaphoreGive(s_lock);
+}
+
+void i2c_bus_log_stats(void)
+{
+    for (int c = 0; c < I2C_BUS_CLIENT_COUNT; c++) {
+        i2c_bus_client_stats_t st = {0};
+        i2c_bus_get_stats((i2c_bus_client_t)c, &st);
+        if (st.transactions == 0 && st.lock_timeouts == 0) {
+            continue;
+        }
+        ESP_LOGI(TAG, "%s: txn=%u err=%u lock_to=%u wait_avg_us=%u wait_max_us=%u hold_max_us=%u",
+                 s_client_names[c], (unsigned)st.transactions, (unsigned)st.errors,
+                 (unsigned)st.lock_timeouts,
+                 (unsigned)(st.transactions ? st.wait_sum_us / st.transactions : 0),
+                 (unsigned)st.wait_max_us, (unsigned)st.hold_max_us);
+    }
+}
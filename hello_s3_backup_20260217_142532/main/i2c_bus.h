@@ -0,0 +1,42 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+
+// Owner of the shared EXIO/touch I2C port. Every transfer is one complete
+// transaction under the bus mutex, so an EXIO write can wait behind at most
+// one touch burst read and vice versa; nobody holds the bus between
+// transactions. Per-client wait and hold times show whether that holds.
+
+#ifndef I2C_BUS_LOCK_TIMEOUT_MS
+#define I2C_BUS_LOCK_TIMEOUT_MS 100
+#endif
+
+#ifndef I2C_BUS_XFER_TIMEOUT_MS
+#define I2C_BUS_XFER_TIMEOUT_MS 20
+#endif
+
+typedef enum {
+    I2C_BUS_CLIENT_EXIO,
+    I2C_BUS_CLIENT_TOUCH,
+    I2C_BUS_CLIENT_COUNT,
+} i2c_bus_client_t;
+
+typedef struct {
+    uint32_t transactions;
+    uint32_t errors;          // NAK or bus timeout
+    uint32_t lock_timeouts;
+    uint32_t wait_max_us;     // time spent queued behind the other client
+    uint32_t hold_max_us;
+    uint64_t wait_sum_us;
+} i2c_bus_client_stats_t;
+
+esp_err_t i2c_bus_init(int port, int sda, int scl, uint32_t clk_hz);
+esp_err_t i2c_bus_write(i2c_bus_client_t client, uint8_t addr, const uint8_t *data, size_t len);
+// Register read as one transaction: write wr (e.g. the start register), repeated start, read rd.
+esp_err_t i2c_bus_write_read(i2c_bus_client_t client, uint8_t addr, const uint8_t *wr, size_t wr_len,
+                             uint8_t *rd, size_t rd_len);
+void i2c_bus_get_stats(i2c_bus_client_t client, i2c_bus_client_stats_t *out);
+void i2c_bus_log_stats(void);
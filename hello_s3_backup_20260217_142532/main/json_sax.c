@@ -0,0 +1,477 @@
+#include "json_sax.h"
+
+#include <string.h>
+
+enum {
+    EXP_VALUE,
+    EXP_VALUE_OR_END,   // just after '['
+    EXP_KEY_OR_END,     // just after '{'
+    EXP_KEY,
+    EXP_COLON,
+    EXP_COMMA_OR_END,
+    EXP_DONE,
+};
+
+enum {
+    LEX_NONE,
+    LEX_STRING,
+    LEX_ESCAPE,
+    LEX_UNICODE,
+    LEX_NUMBER,
+    LEX_LITERAL,
+};
+
+static bool fail(json_sax_t *p, json_sax_error_t err)
+{
+    if (p->error == JSON_SAX_OK) {
+        p->error = err;
+    }
+    return false;
+}
+
+static bool emit(json_sax_t *p, json_event_t ev, const char *text, size_t len)
+{
+    if (!p->cb(p->ctx, ev, text, len, p->depth)) {
+        return fail(p, JSON_SAX_ERR_ABORTED);
+    }
+    return true;
+}
+
+static void value_done(json_sax_t *p)
+{
+    p->expect = (p->depth == 0) ? EXP_DONE : EXP_COMMA_OR_END;
+}
+
+static bool in_object(const json_sax_t *p)
+{
+    return p->depth > 0 && ((p->stack >> (p->depth - 1)) & 1u);
+}
+
+static bool open_container(json_sax_t *p, bool object)
+{
+    if (p->depth >= JSON_SAX_MAX_DEPTH) {
+        return fail(p, JSON_SAX_ERR_DEPTH);
+    }
+    if (!emit(p, object ? JSON_EV_OBJECT_BEGIN : JSON_EV_ARRAY_BEGIN, NULL, 0)) {
+        return false;
+    }
+    if (object) {
+        p->stack |= 1u << p->depth;
+    } else {
+        p->stack &= ~(1u << p->depth);
+    }
+    p->depth++;
+    p->expect = object ? EXP_KEY_OR_END : EXP_VALUE_OR_END;
+    return true;
+}
+
+static bool close_container(json_sax_t *p, bool object)
+{
+    p->depth--;
+    if (!emit(p, object ? JSON_EV_OBJECT_END : JSON_EV_ARRAY_END, NULL, 0)) {
+        return false;
+    }
+    value_done(p);
+    return true;
+}
+
+static void token_append(json_sax_t *p, const uint8_t *bytes, size_t n)
+{
+    if (p->token_full) {
+        return;
+    }
+    if (p->len + n > JSON_SAX_TOKEN_MAX) {
+        p->token_full = true;
+        p->truncations++;
+        return;
+    }
+    memcpy(&p->token[p->len], bytes, n);
+    p->len = (uint16_t)(p->len + n);
+}
+
+// Raw bytes are appended one at a time, so a cut string may end inside a multi-byte sequence.
+static void token_trim_utf8(json_sax_t *p)
+{
+    size_t i = p->len;
+    while (i > 0 && ((uint8_t)p->token[i - 1] & 0xC0) == 0x80) {
+        i--;
+    }
+    if (i == 0) {
+        return;
+    }
+    uint8_t lead = (uint8_t)p->token[i - 1];
+    size_t need = (lead >= 0xF0) ? 4 : (lead >= 0xE0) ? 3 : (lead >= 0xC0) ? 2 : 1;
+    if (p->len - (i - 1) < need) {
+        p->len = (uint16_t)(i - 1);
+    }
+}
+
+static void token_append_codepoint(json_sax_t *p, uint32_t cp)
+{
+    uint8_t buf[4];
+    size_t n;
+    if (cp < 0x80) {
+        buf[0] = (uint8_t)cp;
+        n = 1;
+    } else if (cp < 0x800) {
+        buf[0] = (uint8_t)(0xC0 | (cp >> 6));
+        buf[1] = (uint8_t)(0x80 | (cp & 0x3F));
+        n = 2;
+    } else if (cp < 0x10000) {
+        buf[0] = (uint8_t)(0xE0 | (cp >> 12));
+        buf[1] = (uint8_t)(0x80 | ((cp >> 6) & 0x3F));
+        buf[2] = (uint8_t)(0x80 | (cp & 0x3F));
+        n = 3;
+    } else {
+        buf[0] = (uint8_t)(0xF0 | (cp >> 18));
+        buf[1] = (uint8_t)(0x80 | ((cp >> 12) & 0x3F));
+        buf[2] = (uint8_t)(0x80 | ((cp >> 6) & 0x3F));
+        buf[3] = (uint8_t)(0x80 | (cp & 0x3F));
+        n = 4;
+    }
+    token_append(p, buf, n);
+}
+
+static void token_begin(json_sax_t *p, uint8_t lex)
+{
+    p->lex = lex;
+    p->len = 0;
+    p->token_full = false;
+}
+
+static bool is_digit(uint8_t c)
+{
+    return c >= '0' && c <= '9';
+}
+
+static bool number_valid(const char *s, size_t n)
+{
+    size_t i = 0;
+    if (i < n && s[i] == '-') {
+        i++;
+    }
+    if (i < n && s[i] == '0') {
+        i++;
+    } else if (i < n && is_digit((uint8_t)s[i])) {
+        while (i < n && is_digit((uint8_t)s[i])) {
+            i++;
+        }
+    } else {
+        return false;
+    }
+    if (i < n && s[i] == '.') {
+        size_t start = ++i;
+        while (i < n && is_digit((uint8_t)s[i])) {
+            i++;
+        }
+        if (i == start) {
+            return false;
+        }
+    }
+    if (i < n && (s[i] == 'e' || s[i] == 'E')) {
+        i++;
+        if (i < n && (s[i] == '+' || s[i] == '-')) {
+            i++;
+        }
+        size_t start = i;
+        while (i < n && is_digit((uint8_t)s[i])) {
+            i++;
+        }
+        if (i == start) {
+            return false;
+        }
+    }
+    return i == n;
+}
+
+static bool number_end(json_sax_t *p)
+{
+    p->lex = LEX_NONE;
+    p->token[p->len] = '\0';
+    if (!number_valid(p->token, p->len)) {
+        return fail(p, JSON_SAX_ERR_NUMBER);
+    }
+    if (!emit(p, JSON_EV_NUMBER, p->token, p->len)) {
+        return false;
+    }
+    value_done(p);
+    return true;
+}
+
+static bool string_end(json_sax_t *p)
+{
+    p->lex = LEX_NONE;
+    if (p->token_full) {
+        token_trim_utf8(p);
+    }
+    p->token[p->len] = '\0';
+    if (p->key) {
+        if (!emit(p, JSON_EV_KEY, p->token, p->len)) {
+            return false;
+        }
+        p->expect = EXP_COLON;
+        return true;
+    }
+    if (!emit(p, JSON_EV_STRING, p->token, p->len)) {
+        return false;
+    }
+    value_done(p);
+    return true;
+}
+
+static int hex_value(uint8_t c)
+{
+    if (is_digit(c)) {
+        return c - '0';
+    }
+    c |= 0x20;
+    return (c >= 'a' && c <= 'f') ? c - 'a' + 10 : -1;
+}
+
+static bool lex_string_byte(json_sax_t *p, uint8_t c)
+{
+    switch (p->lex) {
+    case LEX_STRING:
+        if (p->high_surrogate && c != '\\') {
+            return fail(p, JSON_SAX_ERR_STRING);
+        }
+        if (c == '"') {
+            return string_end(p);
+        }
+        if (c == '\\') {
+            p->lex = LEX_ESCAPE;
+            return true;
+        }
+        if (c < 0x20) {
+            return fail(p, JSON_SAX_ERR_STRING);
+        }
+        token_append(p, &c, 1);
+        return true;
+
+    case LEX_ESCAPE: {
+        static const char from[] = "\"\\/bfnrt";
+        static const char to[] = "\"\\/\b\f\n\r\t";
+        if (c == 'u') {
+            p->lex = LEX_UNICODE;
+            p->hex = 0;
+            p->hex_len = 0;
+            return true;
+        }
+        const char *hit = (c != '\0' && !p->high_surrogate) ? strchr(from, c) : NULL;
+        if (!hit) {
+            return fail(p, JSON_SAX_ERR_STRING);
+        }
+        token_append(p, (const uint8_t *)&to[hit - from], 1);
+        p->lex = LEX_STRING;
+        return true;
+    }
+
+    default: {  // LEX_UNICODE
+        int v = hex_value(c);
+        if (v < 0) {
+            return fail(p, JSON_SAX_ERR_STRING);
+        }
+        p->hex = (uint16_t)((p->hex << 4) | v);
+        if (++p->hex_len < 4) {
+            return true;
+        }
+        p->lex = LEX_STRING;
+        uint16_t u = p->hex;
+        if (p->high_surrogate) {
+            if (u < 0xDC00 || u > 0xDFFF) {
+                return fail(p, JSON_SAX_ERR_STRING);
+            }
+            uint32_t cp = 0x10000u + (((uint32_t)p->high_surrogate - 0xD800u) << 10) + (u - 0xDC00u);
+            p->high_surrogate = 0;
+            token_append_codepoint(p, cp);
+        } else if (u >= 0xD800 && u <= 0xDBFF) {
+            p->high_surrogate = u;
+        } else if ((u >= 0xDC00 && u <= 0xDFFF) || u == 0) {
+            return fail(p, JSON_SAX_ERR_STRING);  // lone low surrogate, or NUL inside a C string
+        } else {
+            token_append_codepoint(p, u);
+        }
+        return true;
+    }
+    }
+}
+
+static bool value_begin(json_sax_t *p, uint8_t c)
+{
+    switch (c) {
+    case '{':
+        return open_container(p, true);
+    case '[':
+        return open_container(p, false);
+    case '"':
+        token_begin(p, LEX_STRING);
+        p->key = false;
+        return true;
+    case 't':
+    case 'f':
+    case 'n':
+        token_begin(p, LEX_LITERAL);
+        p->token[0] = (char)c;
+        p->lit_len = 1;
+        return true;
+    default:
+        if (c == '-' || is_digit(c)) {
+            token_begin(p, LEX_NUMBER);
+            p->token[p->len++] = (char)c;
+            return true;
+        }
+        return fail(p, JSON_SAX_ERR_SYNTAX);
+    }
+}
+
+static bool structural_byte(json_sax_t *p, uint8_t c)
+{
+    if (c == ' ' || c == '\t' || c == '\n' || c == '\r') {
+        return true;
+    }
+    switch (p->expect) {
+    case EXP_VALUE_OR_END:
+        if (c == ']') {
+            return close_container(p, false);
+        }
+        return value_begin(p, c);
+    case EXP_VALUE:
+        return value_begin(p, c);
+    case EXP_KEY_OR_END:
+        if (c == '}') {
+            return close_container(p, true);
+        }
+        // fall through
+    case EXP_KEY:
+        if (c != '"') {
+            return fail(p, JSON_SAX_ERR_SYNTAX);
+        }
+        token_begin(p, LEX_STRING);
+        p->key = true;
+        return true;
+    case EXP_COLON:
+        if (c != ':') {
+            return fail(p, JSON_SAX_ERR_SYNTAX);
+        }
+        p->expect = EXP_VALUE;
+        return true;
+    case EXP_COMMA_OR_END:
+        if (c == ',') {
+            p->expect = in_object(p) ? EXP_KEY : EXP_VALUE;
+            return true;
+        }
+        if (c == '}' && in_object(p)) {
+            return close_container(p, true);
+        }
+        if (c == ']' && !in_object(p)) {
+            return close_container(p, false);
+        }
+        return fail(p, JSON_SAX_ERR_SYNTAX);
+    default:  // EXP_DONE: only whitespace may follow the top-level value
+        return fail(p, JSON_SAX_ERR_SYNTAX);
+    }
+}
+
+static bool consume(json_sax_t *p, uint8_t c)
+{
+    switch (p->lex) {
+    case LEX_STRING:
+    case LEX_ESCAPE:
+    case LEX_UNICODE:
+        return lex_string_byte(p, c);
+
+    case LEX_NUMBER:
+        if (is_digit(c) || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E') {
+            if (p->len >= JSON_SAX_TOKEN_MAX) {
+                return fail(p, JSON_SAX_ERR_NUMBER);
+            }
+            p->token[p->len++] = (char)c;
+            return true;
+        }
+        // Numbers have no terminator of their own: close it, then c is structural.
+        if (!number_end(p)) {
+            return false;
+        }
+        return structural_byte(p, c);
+
+    case LEX_LITERAL: {
+        const char *word = (p->token[0] == 't') ? "true" : (p->token[0] == 'f') ? "false" : "null";
+        if (c != (uint8_t)word[p->lit_len]) {
+            return fail(p, JSON_SAX_ERR_SYNTAX);
+        }
+        if (word[++p->lit_len] != '\0') {
+            return true;
+        }
+        p->lex = LEX_NONE;
+        json_event_t ev = (word[0] == 't') ? JSON_EV_TRUE : (word[0] == 'f') ? JSON_EV_FALSE : JSON_EV_NULL;
+        if (!emit(p, ev, NULL, 0)) {
+            return false;
+        }
+        value_done(p);
+        return true;
+    }
+
+    default:
+        return structural_byte(p, c);
+    }
+}
+
+void json_sax_init(json_sax_t *p, json_sax_cb_t cb, void *ctx)
+{
+    memset(p, 0, sizeof(*p));
+    p->cb = cb;
+    p->ctx = ctx;
+    p->expect = EXP_VALUE;
+    p->lex = LEX_NONE;
+}
+
+bool json_sax_feed(json_sax_t *p, const void *data, size_t len)
+{
+    const uint8_t *bytes = (const uint8_t *)data;
+    if (p->error != JSON_SAX_OK) {
+        return false;
+    }
+    for (size_t i = 0; i < len; i++) {
+        if (!consume(p, bytes[i])) {
+            return false;
+        }
+        p->offset++;
+    }
+    return true;
+}
+
+bool json_sax_finish(json_sax_t *p)
+{
+    if (p->error != JSON_SAX_OK) {
+        return false;
+    }
+    if (p->lex == LEX_NUMBER && !number_end(p)) {
+        return false;
+    }
+    if (p->lex != LEX_NONE || p->expect != EXP_DONE) {
+        return fail(p, JSON_SAX_ERR_TRUNCATED);
+    }
+    return true;
+}
+
+const char *json_sax_error_name(json_sax_error_t err)
+{
+    switch (err) {
+    case JSON_SAX_OK:
+        return "ok";
+    case JSON_SAX_ERR_SYNTAX:
+        return "syntax";
+    case JSON_SAX_ERR_DEPTH:
+        return "too deep";
+    case JSON_SAX_ERR_NUMBER:
+        return "bad number";
+    case JSON_SAX_ERR_STRING:
+        return "bad string";
+    case JSON_SAX_ERR_TRUNCATED:
+        return "truncated";
+    case JSON_SAX_ERR_ABORTED:
+        return "aborted";
+    default:
+        return "?";
+    }
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Push-mode SAX JSON parser: bytes go in through json_sax_feed() in chunks of
+// any size (down to one byte) and events come out through a callback as soon as
+// each token is complete. The parser never sees more than the current chunk, so
+// its memory is the fixed struct below whatever the document size.
+//
+// Strict RFC 8259 apart from two limits: nesting deeper than JSON_SAX_MAX_DEPTH
+// is an error, and key/string values longer than JSON_SAX_TOKEN_MAX bytes are
+// cut at a UTF-8 boundary (counted in `truncations`).
+
+#ifndef JSON_SAX_TOKEN_MAX
+#define JSON_SAX_TOKEN_MAX 96
+#endif
+
+#ifndef JSON_SAX_MAX_DEPTH
+#define JSON_SAX_MAX_DEPTH 16
+#endif
+
+_Static_assert(JSON_SAX_MAX_DEPTH <= 32, "container stack is one uint32_t");
+
+typedef enum {
+    JSON_EV_OBJECT_BEGIN,
+    JSON_EV_OBJECT_END,
+    JSON_EV_ARRAY_BEGIN,
+    JSON_EV_ARRAY_END,
+    JSON_EV_KEY,
+    JSON_EV_STRING,
+    JSON_EV_NUMBER,   // text is the literal as written, e.g. "-1.5e3"
+    JSON_EV_TRUE,
+    JSON_EV_FALSE,
+    JSON_EV_NULL,
+} json_event_t;
+
+typedef enum {
+    JSON_SAX_OK = 0,
+    JSON_SAX_ERR_SYNTAX,
+    JSON_SAX_ERR_DEPTH,
+    JSON_SAX_ERR_NUMBER,     // malformed or longer than JSON_SAX_TOKEN_MAX
+    JSON_SAX_ERR_STRING,     // control character, bad escape or lone surrogate
+    JSON_SAX_ERR_TRUNCATED,  // json_sax_finish() before the top-level value closed
+    JSON_SAX_ERR_ABORTED,    // the callback returned false
+} json_sax_error_t;
+
+// depth is the number of containers enclosing the token: the top-level value
+// and its OBJECT_END are at 0, its members at 1. text is NUL-terminated and
+// only valid during the call; it is NULL for structural and literal events.
+typedef bool (*json_sax_cb_t)(void *ctx, json_event_t ev, const char *text, size_t len, int depth);
+
+typedef struct {
+    json_sax_cb_t cb;
+    void *ctx;
+    uint32_t offset;        // bytes consumed; points at the offending byte after an error
+    uint32_t truncations;
+    uint32_t stack;         // one bit per open container, set for objects
+    json_sax_error_t error;
+    uint8_t depth;
+    uint8_t expect;
+    uint8_t lex;
+    uint8_t lit_len;
+    uint8_t hex_len;
+    bool token_full;
+    bool key;               // the string being lexed is an object key
+    uint16_t hex;
+    uint16_t high_surrogate;
+    uint16_t len;
+    char token[JSON_SAX_TOKEN_MAX + 1];
+} json_sax_t;
+
+void json_sax_init(json_sax_t *p, json_sax_cb_t cb, void *ctx);
+// Returns false once the document is known to be bad; p->error says why.
+bool json_sax_feed(json_sax_t *p, const void *data, size_t len);
+// Call at end of input: flushes a trailing top-level number and checks that a
+// complete value was seen.
+bool json_sax_finish(json_sax_t *p);
+const char *json_sax_error_name(json_sax_error_t err);
@@ -0,0 +1,287 @@
+#include "lvgl_port.h"
+
+#include <math.h>
+
+#include "esp_attr.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "lvgl.h"
+#include "panel_config.h"
+
+// The panel takes big-endian RGB565 (see rgb565_be()); LVGL must render it that way.
+#if LV_COLOR_DEPTH != 16 || !LV_COLOR_16_SWAP
+#error "lvgl_port needs CONFIG_LV_COLOR_DEPTH_16 and CONFIG_LV_COLOR_16_SWAP"
+#endif
+
+#define DISC_CENTER ((float)LCD_H_RES / 2.0f)
+#define DISC_RADIUS ((float)LCD_H_RES / 2.0f)
+
+static const char *TAG = "lvgl";
+
+static DMA_ATTR lv_color_t s_buf[2][LCD_H_RES * LVGL_BUF_ROWS];
+static lv_disp_draw_buf_t s_draw_buf;
+static lv_disp_drv_t s_drv;
+static lvgl_port_flush_fn_t s_flush = NULL;
+static SemaphoreHandle_t s_flush_sem = NULL;   // given on every flush done
+static int64_t s_flush_start_us = 0;           // one flush in flight at a time
+
+static esp_timer_handle_t s_tick_timer = NULL;
+static portMUX_TYPE s_tick_lock = portMUX_INITIALIZER_UNLOCKED;
+static int64_t s_tick_last_us = 0;
+
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;   // s_stats
+static lvgl_port_stats_t s_stats;
+
+// Feeds LVGL the whole ms elapsed since the last call. Runs from the tick timer and before every
+// run, so timer events skipped during light sleep cost no time.
+static void lvgl_tick_catch_up(void)
+{
+    int64_t now = esp_timer_get_time();
+    portENTER_CRITICAL(&s_tick_lock);
+    uint32_t ms = (uint32_t)((now - s_tick_last_us) / 1000);
+    if (ms > 0) {
+        s_tick_last_us += (int64_t)ms * 1000;
+        lv_tick_inc(ms);
+    }
+    portEXIT_CRITICAL(&s_tick_lock);
+}
+
+static void lvgl_tick_cb(void *arg)
+{
+    (void)arg;
+    lvgl_tick_catch_up();
+}
+
+static void lvgl_flush_cb(lv_disp_drv_t *drv, const lv_area_t *area, lv_color_t *px)
+{
+    (void)drv;
+    s_flush_start_us = esp_timer_get_time();
+    s_flush(area->x1, area->y1, lv_area_get_width(area), lv_area_get_height(area), (const uint16_t *)px);
+}
+
+// LVGL calls this in a loop while the buffer it needs is still on the bus; block instead of spinning.
+static void lvgl_wait_cb(lv_disp_drv_t *drv)
+{
+    (void)drv;
+    xSemaphoreTake(s_flush_sem, 1);
+}
+
+// Pixels [*lo, *hi] the disc reaches on the line of the band [a, b] nearest the centre.
+static void disc_extent(int a, int b, int *lo, int *hi)
+{
+    float d = 0.0f;
+    if ((float)a > DISC_CENTER) {
+        d = (float)a - DISC_CENTER;
+    } else if ((float)(b + 1) < DISC_CENTER) {
+        d = DISC_CENTER - (float)(b + 1);
+    }
+    float half = d < DISC_RADIUS ? sqrtf(DISC_RADIUS * DISC_RADIUS - d * d) : 0.0f;
+    *lo = (int)floorf(DISC_CENTER - half);
+    *hi = (int)ceilf(DISC_CENTER + half) - 1;
+}
+
+// Round panel: nothing outside the disc is visible, so invalidated areas shrink to the part of
+// their box the disc reaches. A ring-shaped widget near the edge loses its empty corners.
+static void lvgl_rounder_cb(lv_disp_drv_t *drv, lv_area_t *area)
+{
+    (void)drv;
+    int x_lo;
+    int x_hi;
+    int y_lo;
+    int y_hi;
+    disc_extent(area->y1, area->y2, &x_lo, &x_hi);
+    disc_extent(area->x1, area->x2, &y_lo, &y_hi);
+    // Wholly outside the disc: leave it, an empty area would upset LVGL's bookkeeping.
+    if (x_lo > area->x2 || x_hi < area->x1 || y_lo > area->y2 || y_hi < area->y1) {
+        return;
+    }
+    area->x1 = area->x1 > x_lo ? area->x1 : (lv_coord_t)x_lo;
+    area->x2 = area->x2 < x_hi ? area->x2 : (lv_coord_t)x_hi;
+    area->y1 = area->y1 > y_lo ? area->y1 : (lv_coord_t)y_lo;
+    area->y2 = area->y2 < y_hi ? area->y2 : (lv_coord_t)y_hi;
+}
+
+static void lvgl_monitor_cb(lv_disp_drv_t *drv, uint32_t time_ms, uint32_t px)
+{
+    (void)drv;
+    portENTER_CRITICAL(&s_lock);
+    s_stats.frames++;
+    s_stats.render_ms_sum += time_ms;
+    if (time_ms > s_stats.render_ms_max) {
+        s_stats.render_ms_max = time_ms;
+    }
+    s_stats.pixels += px;
+    portEXIT_CRITICAL(&s_lock);
+}
+
+static void lvgl_mem_sample(void)
+{
+    lv_mem_monitor_t mon;
+    lv_mem_monitor(&mon);
+    portENTER_CRITICAL(&s_lock);
+    s_stats.mem_total = mon.total_size;
+    s_stats.mem_used = mon.total_size - mon.free_size;
+    s_stats.mem_max_used = mon.max_used;
+    s_stats.mem_frag_pct = mon.frag_pct;
+    portEXIT_CRITICAL(&s_lock);
+}
+
+bool lvgl_port_flush_done(void)
+{
+    uint32_t us = (uint32_t)(esp_timer_get_time() - s_flush_start_us);
+    portENTER_CRITICAL_SAFE(&s_lock);
+    s_stats.flushes++;
+    s_stats.flush_us_sum += us;
+    if (us > s_stats.flush_us_max) {
+        s_stats.flush_us_max = us;
+    }
+    portEXIT_CRITICAL_SAFE(&s_lock);
+
+    lv_disp_flush_ready(&s_drv);
+
+    // Also reached from the submitting task when every chunk finished (or failed) before it returned.
+    BaseType_t woken = pdFALSE;
+    if (xPortInIsrContext()) {
+        xSemaphoreGiveFromISR(s_flush_sem, &woken);
+    } else {
+        xSemaphoreGive(s_flush_sem);
+    }
+    return woken == pdTRUE;
+}
+
+bool lvgl_port_init(lvgl_port_flush_fn_t flush)
+{
+    s_flush = flush;
+    s_flush_sem = xSemaphoreCreateBinary();
+    if (!s_flush || !s_flush_sem) {
+        return false;
+    }
+
+    lv_init();
+    lv_disp_draw_buf_init(&s_draw_buf, s_buf[0], s_buf[1], LCD_H_RES * LVGL_BUF_ROWS);
+    lv_disp_drv_init(&s_drv);
+    s_drv.hor_res = LCD_H_RES;
+    s_drv.ver_res = LCD_V_RES;
+    s_drv.draw_buf = &s_draw_buf;
+    s_drv.flush_cb = lvgl_flush_cb;
+    s_drv.wait_cb = lvgl_wait_cb;
+    s_drv.rounder_cb = lvgl_rounder_cb;
+    s_drv.monitor_cb = lvgl_monitor_cb;
+    if (!lv_disp_drv_register(&s_drv)) {
+        ESP_LOGE(TAG, "display register failed");
+        return false;
+    }
+
+    s_tick_last_us = esp_timer_get_time();
+    const esp_timer_create_args_t args = {
+        .callback = lvgl_tick_cb,
+        .name = "lv_tick",
+        .skip_unhandled_events = true,
+    };
+    esp_err_t err = esp_timer_create(&args, &s_tick_timer);
+    if (err == ESP_OK) {
+        err = esp_timer_start_periodic(s_tick_timer, LVGL_TICK_PERIOD_MS * 1000ULL);
+    }
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "tick timer failed: %s", esp_err_to_name(err));
+        return false;
+    }
+
+    lvgl_mem_sample();
+    ESP_LOGI(TAG, "lvgl %d.%d.%d: 2 x %u B render buffers (%d rows), refresh %d ms, heap %u KB",
+             LVGL_VERSION_MAJOR, LVGL_VERSION_MINOR, LVGL_VERSION_PATCH, (unsigned)sizeof(s_buf[0]),
+             LVGL_BUF_ROWS, LV_DISP_DEF_REFR_PERIOD, (unsigned)(s_stats.mem_total / 1024));
+    return true;
+}
+
+uint32_t lvgl_port_run(void)
+{
+    lvgl_tick_catch_up();
+    uint32_t next_ms = lv_timer_handler();
+    lvgl_mem_sample();
+    // The refresh timer fires every period even with nothing to draw; don't wake up for that.
+    if (lv_disp_get_default()->inv_p == 0 && lv_anim_count_running() == 0) {
+        return UINT32_MAX;
+    }
+    return next_ms;
+}
+
+void lvgl_port_invalidate_rect(int x, int y, int w, int h)
+{
+    lv_area_t area = {
+        .x1 = (lv_coord_t)x,
+        .y1 = (lv_coord_t)y,
+        .x2 = (lv_coord_t)(x + w - 1),
+        .y2 = (lv_coord_t)(y + h - 1),
+    };
+    lv_inv_area(lv_disp_get_default(), &area);
+}
+
+void lvgl_port_bench(int frames)
+{
+    if (frames <= 0) {
+        return;
+    }
+    lvgl_port_stats_t before;
+    lvgl_port_get_stats(&before);
+
+    int64_t t0 = esp_timer_get_time();
+    for (int i = 0; i < frames; i++) {
+        lv_obj_invalidate(lv_scr_act());
+        lv_refr_now(NULL);
+    }
+    // lv_refr_now() returns with the last buffer still on the bus.
+    while (s_draw_buf.flushing) {
+        lvgl_wait_cb(&s_drv);
+    }
+    int64_t us = esp_timer_get_time() - t0;
+    lvgl_mem_sample();
+
+    lvgl_port_stats_t st;
+    lvgl_port_get_stats(&st);
+    uint32_t flushes = st.flushes - before.flushes;
+    uint32_t fps10 = (uint32_t)((int64_t)frames * 10000000LL / (us > 0 ? us : 1));
+    ESP_LOGI(TAG, "bench: %d full redraws in %lld ms = %u.%u fps, render avg %u ms, %u flushes avg %u us, "
+             "%u px/frame, mem %u/%u KB (max %u KB, frag %u%%)",
+             frames, (long long)(us / 1000), (unsigned)(fps10 / 10), (unsigned)(fps10 % 10),
+             (unsigned)((st.render_ms_sum - before.render_ms_sum) / (uint32_t)frames), (unsigned)flushes,
+             (unsigned)(flushes ? (st.flush_us_sum - before.flush_us_sum) / flushes : 0),
+             (unsigned)((st.pixels - before.pixels) / (uint32_t)frames), (unsigned)(st.mem_used / 1024),
+             (unsigned)(st.mem_total / 1024), (unsigned)(st.mem_max_used / 1024), (unsigned)st.mem_frag_pct);
+}
+
+void lvgl_port_get_stats(lvgl_port_stats_t *out)
+{
+    portENTER_CRITICAL(&s_lock);
+    *out = s_stats;
+    portEXIT_CRITICAL(&s_lock);
+}
+
+void lvgl_port_log_stats(void)
+{
+    static uint32_t last_frames = 0;
+    static int64_t last_us = 0;
+
+    lvgl_port_stats_t st;
+    lvgl_port_get_stats(&st);
+    int64_t now = esp_timer_get_time();
+    uint32_t fps10 = 0;
+    if (last_us > 0 && now > last_us) {
+        fps10 = (uint32_t)((int64_t)(st.frames - last_frames) * 10000000LL / (now - last_us));
+    }
+    last_frames = st.frames;
+    last_us = now;
+    if (st.frames == 0) {
+        return;
+    }
+    ESP_LOGI(TAG, "frames=%u fps=%u.%u render_avg_ms=%u render_max_ms=%u px/frame=%u flushes=%u "
+             "flush_avg_us=%u flush_max_us=%u mem=%u/%u KB max=%u KB frag=%u%%",
+             (unsigned)st.frames, (unsigned)(fps10 / 10), (unsigned)(fps10 % 10),
+             (unsigned)(st.render_ms_sum / st.frames), (unsigned)st.render_ms_max,
+             (unsigned)(st.pixels / st.frames), (unsigned)st.flushes,
+             (unsigned)(st.flushes ? st.flush_us_sum / st.flushes : 0), (unsigned)st.flush_us_max,
+             (unsigned)(st.mem_used / 1024), (unsigned)(st.mem_total / 1024), (unsigned)(st.mem_max_used / 1024),
+             (unsigned)st.mem_frag_pct);
+}
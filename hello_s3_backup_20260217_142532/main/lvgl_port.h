@@ -0,0 +1,53 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// LVGL 8.3 display driver for the round panel: two partial render buffers in
+// internal DMA RAM, asynchronous flush (LVGL renders into one buffer while the
+// other is on the bus), invalidated areas clipped to the visible disc, and
+// lv_tick fed from esp_timer.
+//
+// LVGL is single-threaded: everything here except lvgl_port_flush_done() must
+// be called from the one task that owns the UI.
+
+// Rows per render buffer; two full-width buffers of this height are reserved.
+#ifndef LVGL_BUF_ROWS
+#define LVGL_BUF_ROWS 20
+#endif
+
+#ifndef LVGL_TICK_PERIOD_MS
+#define LVGL_TICK_PERIOD_MS 5
+#endif
+
+// Queues the w*h pixels for (x, y) and calls lvgl_port_flush_done() once they
+// have left the bus. pixels stay valid until then.
+typedef void (*lvgl_port_flush_fn_t)(int x, int y, int w, int h, const uint16_t *pixels);
+
+typedef struct {
+    uint32_t frames;          // refresh cycles that drew something
+    uint32_t render_ms_sum;   // per frame, as LVGL reports it (render plus waiting on flushes)
+    uint32_t render_ms_max;
+    uint64_t pixels;
+    uint32_t flushes;
+    uint64_t flush_us_sum;    // flush_cb until the transfer is done
+    uint32_t flush_us_max;
+    uint32_t mem_total;       // LVGL heap (LV_MEM_SIZE), sampled after each run
+    uint32_t mem_used;
+    uint32_t mem_max_used;
+    uint8_t mem_frag_pct;
+} lvgl_port_stats_t;
+
+bool lvgl_port_init(lvgl_port_flush_fn_t flush);
+// Transfer-done hook, ISR-safe. Returns true when a higher-priority task was woken.
+bool lvgl_port_flush_done(void);
+// Runs LVGL's timers (refresh included); returns ms until they want to run again, UINT32_MAX
+// when nothing is left to draw or animate.
+uint32_t lvgl_port_run(void);
+// Marks (x, y, w, h) for redraw, e.g. after something else was drawn over it.
+void lvgl_port_invalidate_rect(int x, int y, int w, int h);
+// Redraws the active screen in full `frames` times and logs frame rate, flush time and memory.
+void lvgl_port_bench(int frames);
+void lvgl_port_get_stats(lvgl_port_stats_t *out);
+// Frame rate since the previous call, flush time and LVGL memory.
+void lvgl_port_log_stats(void);
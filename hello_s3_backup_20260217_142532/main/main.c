@@ -1,28 +1,51 @@
+#include <stdatomic.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <sys/time.h>
 #include <time.h>
 
-#include "driver/i2c.h"
 #include "driver/i2s_std.h"
-#include "driver/ledc.h"
 #include "driver/gpio.h"
+#include "analog_face.h"
+#include "assets.h"
+#include "backlight.h"
+#include "clock_face.h"
 #include "driver/spi_master.h"
+#include "dlog.h"
+#include "dma_arena.h"
+#include "esp_attr.h"
 #include "esp_event.h"
-#include "esp_heap_caps.h"
 #include "esp_lcd_panel_io.h"
 #include "esp_lcd_panel_ops.h"
 #include "esp_lcd_panel_vendor.h"
 #include "esp_lcd_st77916.h"
 #include "esp_log.h"
+#include "esp_memory_utils.h"
 #include "esp_netif.h"
+#include "esp_pm.h"
 #include "esp_sntp.h"
+#include "esp_system.h"
 #include "esp_timer.h"
 #include "esp_wifi.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/event_groups.h"
+#include "freertos/semphr.h"
 #include "freertos/task.h"
+#include "i2c_bus.h"
+#include "lvgl_port.h"
+#include "mem_telemetry.h"
+#include "mic_capture.h"
+#include "nvs.h"
 #include "nvs_flash.h"
+#include "panel_config.h"
+#include "q565.h"
+#include "reminder_screen.h"
+#include "reminder_store.h"
+#include "reminder_sync.h"
+#include "spsc_queue.h"
+#include "touch.h"
 
 // Fill your Wi-Fi here to enable NTP time sync.
 #ifndef WIFI_SSID
@@ -38,12 +61,44 @@
 #define CLOCK_TIMEZONE "CST-8"
 #endif
 
+#define TIME_VALID_MIN_YEAR      2024
+#define TIME_RTC_MAGIC           0x434C4B55u
+#define TIME_NVS_NS              "clock_time"
+#define TIME_NVS_KEY             "last"
+#define TIME_NVS_VERSION         1
+#define TIME_NVS_SAVE_INTERVAL_S 900
+// Drift is only trusted once measured over at least this long.
+#define TIME_DRIFT_MIN_SPAN_S    600
+// Crystal plus temperature stays well inside this; anything larger is a clock step, not drift.
+#define TIME_DRIFT_MAX_PPB       500000
+
+// Optional static IPv4 config, e.g. "192.168.1.50". Empty means DHCP; with
+// CONFIG_LWIP_DHCP_RESTORE_LAST_IP lwIP re-requests the previous lease from NVS.
+#ifndef WIFI_STATIC_IP
+#define WIFI_STATIC_IP      ""
+#endif
+
+#ifndef WIFI_STATIC_GW
+#define WIFI_STATIC_GW      ""
+#endif
+
+#ifndef WIFI_STATIC_NETMASK
+#define WIFI_STATIC_NETMASK "255.255.255.0"
+#endif
+
+#ifndef WIFI_STATIC_DNS
+#define WIFI_STATIC_DNS     ""
+#endif
+
 #define WIFI_CONNECTED_BIT BIT0
 #define WIFI_FAIL_BIT      BIT1
+// Retries before the boot wait gives up; reconnects continue in the background.
 #define WIFI_MAX_RETRY     10
-
-#define LCD_H_RES 360
-#define LCD_V_RES 360
+#define WIFI_BACKOFF_MIN_MS 250
+#define WIFI_BACKOFF_MAX_MS 60000
+#define WIFI_CACHE_NVS_NS  "wifi_cache"
+#define WIFI_CACHE_NVS_KEY "ap"
+#define WIFI_CACHE_VERSION 1
 
 #define LCD_SPI_HOST         SPI2_HOST
 #define LCD_PIN_CS           21
@@ -62,6 +117,7 @@
 #define EXIO_REG_OUTPUT      0x01
 #define EXIO_REG_CONFIG      0x03
 #define EXIO_OUTPUT_DEFAULT  0x00
+#define EXIO_TOUCH_RST_PIN   1
 #define EXIO_LCD_RST_PIN     2
 #define EXIO_AUDIO_SD_PIN    5
 
@@ -71,9 +127,74 @@
 #define BEEP_SAMPLE_RATE_HZ  22050
 #define BEEP_AMPLITUDE       12000
 #define BEEP_WRITE_TIMEOUT_MS 200
-#define BEEP_WRITE_CHUNK_BYTES 2048
 
-#define DRAW_CHUNK_ROWS      8
+// Lets the last queued DMA descriptors play out before the channel (and its PM lock) is released.
+#define BEEP_DRAIN_MS        80
+
+// Boot blit benchmark: passes per method, and the most single-color runs worth timing as fills.
+#define ASSETS_BENCH_REPS     4
+#define ASSETS_BENCH_MAX_RUNS 5000
+
+// Touch feedback: a dot under the finger while it is down; latency logged every N events.
+#define TOUCH_DOT_SIZE          12
+#define TOUCH_LAT_REPORT_EVENTS 50
+
+// Reminder alert: chirps until a clap or voice snoozes it, a double clap dismisses it, or it times out.
+#define ALERT_DURATION_S      60
+#define ALERT_SNOOZE_S        300
+#define ALERT_CHIRP_HZ        1040
+#define ALERT_CHIRP_MS        150
+#define ALERT_CHIRP_PERIOD_MS 2000
+#define ALERT_POLL_MS         100
+
+// Watch face: the digital clock_face unless one of these selects the anti-aliased analog_face or
+// the LVGL reminder screen (redrawn LVGL_BENCH_FRAMES times at boot to measure it).
+#ifndef CLOCK_FACE_ANALOG
+#define CLOCK_FACE_ANALOG     0
+#endif
+#ifndef CLOCK_FACE_LVGL
+#define CLOCK_FACE_LVGL       0
+#endif
+#if CLOCK_FACE_ANALOG && CLOCK_FACE_LVGL
+#error "CLOCK_FACE_ANALOG and CLOCK_FACE_LVGL are exclusive"
+#endif
+#define LVGL_BENCH_FRAMES     20
+
+// Digit transitions on the digital face (clock_anim_style_t). Off by default: they add about 15
+// render/DMA wake-ups and tens of KB of bus traffic per second to the once-per-second tick.
+#ifndef CLOCK_ANIM_STYLE
+#define CLOCK_ANIM_STYLE      CLOCK_ANIM_NONE
+#endif
+
+// Rendering owns one core; clock/network/reminder logic runs on the other.
+#ifndef RENDER_TASK_CORE
+#define RENDER_TASK_CORE     1
+#endif
+
+#ifndef RENDER_TASK_PRIO
+#define RENDER_TASK_PRIO     10
+#endif
+
+#ifndef CLOCK_TASK_CORE
+#define CLOCK_TASK_CORE      0
+#endif
+
+#ifndef CLOCK_TASK_PRIO
+#define CLOCK_TASK_PRIO      5
+#endif
+
+#define RENDER_TASK_STACK    4096
+#define CLOCK_TASK_STACK     4096
+#define SCENE_QUEUE_LEN      4
+
+#define PM_MAX_FREQ_MHZ      CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ
+#define PM_MIN_FREQ_MHZ      40
+#define PM_REPORT_TICKS      60
+// Task table for the scheduler report; sized like mem_telemetry's.
+#define SCHED_MAX_TASKS      24
+// Board-level current estimates; tools/power_model.py uses the same defaults.
+#define PM_EST_ACTIVE_MA     45
+#define PM_EST_SLEEP_MA      3
 
 // Some ESP32-S3-Touch-LCD-1.85C batches require this init table.
 static const st77916_lcd_init_cmd_t st77916_init_waveshare_185c[] = {
@@ -265,264 +386,404 @@ static const st77916_lcd_init_cmd_t st77916_init_waveshare_185c[] = {
 
 static const char *TAG = "clock_lcd";
 
+typedef struct {
+    uint8_t version;
+    uint8_t channel;
+    uint8_t bssid[6];
+} wifi_ap_cache_t;
+
+typedef enum {
+    TIME_SOURCE_UPTIME = 0,
+    TIME_SOURCE_ESTIMATE,   // last NVS snapshot after power loss, off-time unknown
+    TIME_SOURCE_RETAINED,   // RTC kept counting through a warm reset or deep sleep
+    TIME_SOURCE_NTP,
+} time_source_t;
+
+// Lives in RTC slow memory: survives software resets, panics and deep sleep.
+typedef struct {
+    uint32_t magic;
+    uint8_t source;
+    int64_t last_sync_us;   // wall clock of the last NTP sync
+    int64_t last_seen_us;   // wall clock of the last displayed tick
+    int64_t corrected_us;   // drift already folded in up to this wall clock
+    int64_t folded_us;      // drift correction added to the wall clock since the last sync
+    int32_t drift_ppb;      // positive: local clock runs slow
+    uint8_t rebuilt;        // resumed from last_seen_us since the last sync; reset downtime is lost
+} time_rtc_state_t;
+
+typedef struct {
+    uint8_t version;
+    uint8_t synced;
+    int64_t epoch_us;
+    int32_t drift_ppb;
+} time_nvs_state_t;
+
 static EventGroupHandle_t s_wifi_event_group;
 static int s_wifi_retry_count = 0;
-static bool s_time_synced = false;
+static volatile time_source_t s_time_source = TIME_SOURCE_UPTIME;
+static volatile bool s_time_nvs_dirty = false;
+static RTC_NOINIT_ATTR time_rtc_state_t s_time_rtc;
+
+// One clock frame as handed from the clock task to the render task.
+typedef struct {
+    struct tm ti;
+    uint8_t source;
+    int64_t queued_us;
+    int64_t next_edge_us;   // esp_timer time at which ti is one second old
+} clock_scene_t;
+
+static clock_scene_t s_scene_slots[SCENE_QUEUE_LEN];
+static spsc_queue_t s_scene_queue;
+static TaskHandle_t s_render_task = NULL;
+static TaskHandle_t s_net_task = NULL;
+static volatile uint32_t s_scene_dropped = 0;
+static esp_netif_t *s_wifi_netif = NULL;
+static esp_timer_handle_t s_wifi_retry_timer = NULL;
+static wifi_ap_cache_t s_wifi_cache = {0};
+static bool s_wifi_cache_valid = false;
+static bool s_wifi_using_cache = false;
+static bool s_wifi_got_ip = false;
+static int64_t s_wifi_start_us = 0;
+static int64_t s_wifi_connected_us = 0;
 
 static esp_lcd_panel_handle_t s_panel = NULL;
-static uint16_t *s_draw_buf = NULL;
-static size_t s_draw_buf_pixels = 0;
 static uint64_t s_boot_us = 0;
 static uint8_t s_exio_output_state = 0;
+static atomic_int s_lcd_inflight = 0;
+static SemaphoreHandle_t s_lcd_idle_sem = NULL;
+static esp_pm_lock_handle_t s_pm_render_lock = NULL;
+// Render hold accounting for the pm: report; ISR-safe since async holds end in the transfer-done ISR.
+static portMUX_TYPE s_pm_hold_lock = portMUX_INITIALIZER_UNLOCKED;
+static int s_pm_holds = 0;
+static int64_t s_pm_held_since_us = 0;
+static int64_t s_pm_active_us = 0;             // held time not yet taken by pm_take_active_us()
+static atomic_int s_pm_idle_unholds = 0;       // holds handed to the bus, dropped once it is idle
 static i2s_chan_handle_t s_i2s_tx_chan = NULL;
-static i2s_chan_handle_t s_i2s_rx_chan = NULL;
-static int16_t *s_beep_pcm = NULL;
-static size_t s_beep_pcm_bytes = 0;
-
-enum {
-    SEG_A = 1 << 0,
-    SEG_B = 1 << 1,
-    SEG_C = 1 << 2,
-    SEG_D = 1 << 3,
-    SEG_E = 1 << 4,
-    SEG_F = 1 << 5,
-    SEG_G = 1 << 6,
-};
+static atomic_int s_alert_event = AUDIO_EV_NONE;   // latest mic event for the alert loop
 
-static const uint8_t s_digit_mask[10] = {
-    SEG_A | SEG_B | SEG_C | SEG_D | SEG_E | SEG_F,
-    SEG_B | SEG_C,
-    SEG_A | SEG_B | SEG_D | SEG_E | SEG_G,
-    SEG_A | SEG_B | SEG_C | SEG_D | SEG_G,
-    SEG_B | SEG_C | SEG_F | SEG_G,
-    SEG_A | SEG_C | SEG_D | SEG_F | SEG_G,
-    SEG_A | SEG_C | SEG_D | SEG_E | SEG_F | SEG_G,
-    SEG_A | SEG_B | SEG_C,
-    SEG_A | SEG_B | SEG_C | SEG_D | SEG_E | SEG_F | SEG_G,
-    SEG_A | SEG_B | SEG_C | SEG_D | SEG_F | SEG_G,
-};
+// A render hold keeps the CPU at full speed and out of light sleep, and its time counts as active
+// in the pm: report. Holds nest; the time runs while at least one is taken.
+static void IRAM_ATTR pm_hold(void)
+{
+    portENTER_CRITICAL_SAFE(&s_pm_hold_lock);
+    if (s_pm_holds++ == 0) {
+        s_pm_held_since_us = esp_timer_get_time();
+    }
+    portEXIT_CRITICAL_SAFE(&s_pm_hold_lock);
+    if (s_pm_render_lock) {
+        esp_pm_lock_acquire(s_pm_render_lock);
+    }
+}
 
-static uint16_t rgb565_be(uint8_t r, uint8_t g, uint8_t b)
+static void IRAM_ATTR pm_unhold(void)
 {
-    uint16_t c = ((uint16_t)(r & 0xF8) << 8) | ((uint16_t)(g & 0xFC) << 3) | ((uint16_t)b >> 3);
-    return (uint16_t)((c << 8) | (c >> 8));
+    if (s_pm_render_lock) {
+        esp_pm_lock_release(s_pm_render_lock);
+    }
+    portENTER_CRITICAL_SAFE(&s_pm_hold_lock);
+    if (s_pm_holds > 0 && --s_pm_holds == 0) {
+        s_pm_active_us += esp_timer_get_time() - s_pm_held_since_us;
+    }
+    portEXIT_CRITICAL_SAFE(&s_pm_hold_lock);
 }
 
-static esp_err_t ensure_draw_buf(size_t pixels)
+// Drops the holds that were handed to the bus; runs when it goes idle (ISR) or finds it idle.
+static void IRAM_ATTR pm_drop_idle_holds(void)
 {
-    if (s_draw_buf_pixels >= pixels) {
-        return ESP_OK;
+    for (int n = atomic_exchange(&s_pm_idle_unholds, 0); n > 0; n--) {
+        pm_unhold();
     }
+}
 
-    if (s_draw_buf) {
-        free(s_draw_buf);
-        s_draw_buf = NULL;
-        s_draw_buf_pixels = 0;
+// Held time since the last call, including a hold still running.
+static int64_t pm_take_active_us(void)
+{
+    portENTER_CRITICAL_SAFE(&s_pm_hold_lock);
+    int64_t active_us = s_pm_active_us;
+    if (s_pm_holds > 0) {
+        int64_t now_us = esp_timer_get_time();
+        active_us += now_us - s_pm_held_since_us;
+        s_pm_held_since_us = now_us;
     }
+    s_pm_active_us = 0;
+    portEXIT_CRITICAL_SAFE(&s_pm_hold_lock);
+    return active_us;
+}
 
-    s_draw_buf = heap_caps_malloc(pixels * sizeof(uint16_t), MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
-    if (!s_draw_buf) {
-        s_draw_buf = heap_caps_malloc(pixels * sizeof(uint16_t), MALLOC_CAP_DMA);
+// Runs when a window's last chunk is done, from the transfer-done ISR (or the submitter when the
+// chunks finished first). Returns true when it woke a higher-priority task.
+typedef bool (*lcd_done_fn_t)(void);
+
+// Every queued window holds a slot until its last chunk has left the SPI DMA, and with it the arena
+// block it was drawn from, if any. Windows without a block (direct blits, LVGL's own buffers) are
+// not bounded by the arena, so a submitter that finds the ring full waits for the bus.
+#define LCD_FILL_SLOTS (DMA_DRAW_BLOCKS + 2)
+
+typedef struct {
+    uint16_t *buf;
+    lcd_done_fn_t on_done;
+    atomic_int pending;   // queued chunks plus one while the submitter is still queueing
+} lcd_fill_slot_t;
+
+static lcd_fill_slot_t s_fill_slots[LCD_FILL_SLOTS];
+static atomic_uint s_fill_head = 0;   // advanced by the drawing task
+static atomic_uint s_fill_tail = 0;   // advanced past slots that reached zero, oldest first
+
+// Releases finished slots in submission order. A slot can reach zero before an older one (the
+// submitter drops its guard after the chunks already went out), so it waits until everything
+// before it is released. The ISR and the submitter may both get here; the tail only moves by CAS,
+// so each slot is released once.
+static bool IRAM_ATTR lcd_fill_slots_retire(void)
+{
+    bool woken = false;
+    while (1) {
+        unsigned tail = atomic_load_explicit(&s_fill_tail, memory_order_acquire);
+        if (tail == atomic_load_explicit(&s_fill_head, memory_order_acquire)) {
+            break;
+        }
+        lcd_fill_slot_t *slot = &s_fill_slots[tail % LCD_FILL_SLOTS];
+        if (atomic_load_explicit(&slot->pending, memory_order_acquire) != 0) {
+            break;
+        }
+        // Read before the tail moves; the slot may be reused right after.
+        uint16_t *buf = slot->buf;
+        lcd_done_fn_t on_done = slot->on_done;
+        if (!atomic_compare_exchange_strong_explicit(&s_fill_tail, &tail, tail + 1,
+                                                     memory_order_acq_rel, memory_order_acquire)) {
+            continue;
+        }
+        dma_arena_release(DMA_POOL_DRAW, buf);
+        if (on_done && on_done()) {
+            woken = true;
+        }
     }
-    if (!s_draw_buf) {
-        return ESP_ERR_NO_MEM;
+    return woken;
+}
+
+static bool IRAM_ATTR lcd_fill_slot_put(lcd_fill_slot_t *slot)
+{
+    if (atomic_fetch_sub_explicit(&slot->pending, 1, memory_order_acq_rel) == 1) {
+        return lcd_fill_slots_retire();
     }
+    return false;
+}
 
-    s_draw_buf_pixels = pixels;
-    return ESP_OK;
+// Chunks complete in submission order, so a finished chunk belongs to the oldest unreleased slot.
+// (A slot only sits at zero unreleased behind an older one that still has chunks queued.)
+static bool IRAM_ATTR lcd_fill_chunk_done(void)
+{
+    unsigned tail = atomic_load_explicit(&s_fill_tail, memory_order_acquire);
+    return lcd_fill_slot_put(&s_fill_slots[tail % LCD_FILL_SLOTS]);
 }
 
-static void lcd_fill_rect(int x, int y, int w, int h, uint16_t color)
+static bool lcd_on_color_trans_done(esp_lcd_panel_io_handle_t io, esp_lcd_panel_io_event_data_t *edata, void *user_ctx)
 {
-    if (!s_panel || w <= 0 || h <= 0) {
-        return;
+    (void)io;
+    (void)edata;
+    (void)user_ctx;
+
+    bool done_woken = lcd_fill_chunk_done();
+
+    BaseType_t woken = pdFALSE;
+    if (atomic_fetch_sub(&s_lcd_inflight, 1) == 1) {
+        pm_drop_idle_holds();
+        if (s_lcd_idle_sem) {
+            xSemaphoreGiveFromISR(s_lcd_idle_sem, &woken);
+        }
     }
+    return done_woken || woken == pdTRUE;
+}
 
-    if (x < 0) {
-        w += x;
-        x = 0;
+static void lcd_wait_idle(void)
+{
+    while (atomic_load(&s_lcd_inflight) > 0) {
+        // A stale give only costs one extra loop; the counter is the source of truth.
+        xSemaphoreTake(s_lcd_idle_sem, pdMS_TO_TICKS(100));
     }
-    if (y < 0) {
-        h += y;
-        y = 0;
+}
+
+// Clips a window to the panel; returns false when nothing is left. dx/dy report how far the origin moved.
+static bool lcd_clip(int *x, int *y, int *w, int *h, int *dx, int *dy)
+{
+    *dx = 0;
+    *dy = 0;
+    if (*x < 0) {
+        *dx = -*x;
+        *w += *x;
+        *x = 0;
     }
-    if (x + w > LCD_H_RES) {
-        w = LCD_H_RES - x;
+    if (*y < 0) {
+        *dy = -*y;
+        *h += *y;
+        *y = 0;
     }
-    if (y + h > LCD_V_RES) {
-        h = LCD_V_RES - y;
+    if (*x + *w > LCD_H_RES) {
+        *w = LCD_H_RES - *x;
     }
-    if (w <= 0 || h <= 0) {
-        return;
+    if (*y + *h > LCD_V_RES) {
+        *h = LCD_V_RES - *y;
     }
+    return *w > 0 && *h > 0;
+}
 
-    size_t chunk_pixels = (size_t)w * DRAW_CHUNK_ROWS;
-    if (ensure_draw_buf(chunk_pixels) != ESP_OK) {
-        return;
+// Earlier transfers keep streaming from their own blocks; only stall when every block is queued.
+static uint16_t *lcd_acquire_block(void)
+{
+    uint16_t *buf = dma_arena_acquire(DMA_POOL_DRAW);
+    if (!buf) {
+        lcd_wait_idle();
+        buf = dma_arena_acquire(DMA_POOL_DRAW);
     }
+    return buf;
+}
 
-    for (size_t i = 0; i < chunk_pixels; i++) {
-        s_draw_buf[i] = color;
+// Sends src to the window in chunks of chunk_rows. With advance_src each chunk reads the next
+// chunk_rows * w pixels of src (a full w*h image); without it every chunk reads src from its start
+// (one chunk's worth of repeated fill). block (NULL when src is caller-owned) goes back to the
+// arena after the last chunk completes, then on_done (may be NULL) runs.
+static void lcd_queue_chunks_notify(int x, int y, int w, int h, int chunk_rows, const uint16_t *src,
+                                    bool advance_src, uint16_t *block, lcd_done_fn_t on_done)
+{
+    unsigned head = atomic_load_explicit(&s_fill_head, memory_order_relaxed);
+    if (head - atomic_load_explicit(&s_fill_tail, memory_order_acquire) >= LCD_FILL_SLOTS) {
+        lcd_wait_idle();
     }
+    lcd_fill_slot_t *slot = &s_fill_slots[head % LCD_FILL_SLOTS];
+    slot->buf = block;
+    slot->on_done = on_done;
+    atomic_store_explicit(&slot->pending, 1, memory_order_relaxed);
+    atomic_store_explicit(&s_fill_head, head + 1, memory_order_release);
 
     int remain = h;
     int y_pos = y;
     while (remain > 0) {
-        int rows = (remain > DRAW_CHUNK_ROWS) ? DRAW_CHUNK_ROWS : remain;
-        esp_lcd_panel_draw_bitmap(s_panel, x, y_pos, x + w, y_pos + rows, s_draw_buf);
+        int rows = (remain > chunk_rows) ? chunk_rows : remain;
+        atomic_fetch_add(&slot->pending, 1);
+        atomic_fetch_add(&s_lcd_inflight, 1);
+        if (esp_lcd_panel_draw_bitmap(s_panel, x, y_pos, x + w, y_pos + rows, src) != ESP_OK) {
+            atomic_fetch_sub(&s_lcd_inflight, 1);
+            atomic_fetch_sub(&slot->pending, 1);
+        }
+        if (advance_src) {
+            src += (size_t)rows * w;
+        }
         y_pos += rows;
         remain -= rows;
     }
+    // Drop the submit guard on this window's own slot; it is released here if every chunk already
+    // finished (or failed) and every older window is released too, otherwise with the last of those.
+    lcd_fill_slot_put(slot);
 }
 
-static void draw_colon(int x, int y, int digit_h, int dot_size, uint16_t color)
+static void lcd_queue_chunks(int x, int y, int w, int h, int chunk_rows, const uint16_t *src, uint16_t *block)
 {
-    int top_y = y + digit_h / 3;
-    int bottom_y = y + (digit_h * 2) / 3;
-    lcd_fill_rect(x, top_y, dot_size, dot_size, color);
-    lcd_fill_rect(x, bottom_y, dot_size, dot_size, color);
+    lcd_queue_chunks_notify(x, y, w, h, chunk_rows, src, false, block, NULL);
 }
 
-static void draw_digit_mask(int x, int y, int digit_w, int digit_h, int seg_w, uint8_t mask, uint16_t color)
+static void lcd_fill_rect(int x, int y, int w, int h, uint16_t color)
 {
-    int mid_y = y + digit_h / 2 - seg_w / 2;
-    int upper_h = mid_y - (y + seg_w);
-    int lower_y = mid_y + seg_w;
-    int lower_h = (y + digit_h - seg_w) - lower_y;
-
-    if (upper_h < 1) {
-        upper_h = 1;
-    }
-    if (lower_h < 1) {
-        lower_h = 1;
+    int dx;
+    int dy;
+    if (!s_panel || !lcd_clip(&x, &y, &w, &h, &dx, &dy)) {
+        return;
     }
 
-    if (mask & SEG_A) {
-        lcd_fill_rect(x + seg_w, y, digit_w - 2 * seg_w, seg_w, color);
-    }
-    if (mask & SEG_B) {
-        lcd_fill_rect(x + digit_w - seg_w, y + seg_w, seg_w, upper_h, color);
-    }
-    if (mask & SEG_C) {
-        lcd_fill_rect(x + digit_w - seg_w, lower_y, seg_w, lower_h, color);
-    }
-    if (mask & SEG_D) {
-        lcd_fill_rect(x + seg_w, y + digit_h - seg_w, digit_w - 2 * seg_w, seg_w, color);
-    }
-    if (mask & SEG_E) {
-        lcd_fill_rect(x, lower_y, seg_w, lower_h, color);
-    }
-    if (mask & SEG_F) {
-        lcd_fill_rect(x, y + seg_w, seg_w, upper_h, color);
+    uint16_t *buf = lcd_acquire_block();
+    if (!buf) {
+        return;
     }
-    if (mask & SEG_G) {
-        lcd_fill_rect(x + seg_w, mid_y, digit_w - 2 * seg_w, seg_w, color);
+
+    size_t chunk_pixels = (size_t)w * DRAW_CHUNK_ROWS;
+    for (size_t i = 0; i < chunk_pixels; i++) {
+        buf[i] = color;
     }
+    lcd_queue_chunks(x, y, w, h, DRAW_CHUNK_ROWS, buf, buf);
 }
 
-static void draw_digit_value(int x, int y, int digit_w, int digit_h, int seg_w, int value, uint16_t color)
+// Draws a pre-swapped RGB565 image. Sources the DMA can read go out as they are and must stay
+// valid until lcd_wait_idle(); anything else (mapped flash) is copied row band by row band into
+// arena blocks. Either way there is no per-pixel work.
+static void lcd_blit(int x, int y, int w, int h, const uint16_t *pixels, int stride)
 {
-    if (value < 0 || value > 9) {
+    int dx;
+    int dy;
+    if (!s_panel || !pixels || !lcd_clip(&x, &y, &w, &h, &dx, &dy)) {
         return;
     }
-    draw_digit_mask(x, y, digit_w, digit_h, seg_w, s_digit_mask[value], color);
-}
+    pixels += (size_t)dy * stride + dx;
+
+    bool direct = esp_ptr_dma_capable(pixels) && stride == w;
+    int band_rows = dma_draw_band_rows(w);
+    for (int row = 0; row < h; row += band_rows) {
+        int rows = (h - row > band_rows) ? band_rows : h - row;
+        const uint16_t *src = pixels + (size_t)row * stride;
+        if (direct) {
+            lcd_queue_chunks(x, y + row, w, rows, rows, src, NULL);
+            continue;
+        }
 
-// Ring text animation removed: keep clock-only UI.
+        uint16_t *block = lcd_acquire_block();
+        if (!block) {
+            return;
+        }
+        if (stride == w) {
+            memcpy(block, src, (size_t)rows * w * sizeof(uint16_t));
+        } else {
+            for (int r = 0; r < rows; r++) {
+                memcpy(block + (size_t)r * w, src + (size_t)r * stride, (size_t)w * sizeof(uint16_t));
+            }
+        }
+        lcd_queue_chunks(x, y + row, w, rows, rows, block, block);
+    }
+}
 
-static void draw_time(const struct tm *ti)
+// Streams a Q565 image band by band: each band decodes straight into an arena block and is queued
+// while the next one decodes, so RAM use is one decoder state however large the image is.
+static bool lcd_draw_q565(int x, int y, const void *data, size_t len)
 {
-    const uint16_t bg = rgb565_be(0x00, 0x00, 0x00);
-    const uint16_t hour_color = rgb565_be(0xD9, 0x54, 0x75);
-    const uint16_t minute_color = rgb565_be(0xF3, 0x9A, 0x8F);
-    const uint16_t second_color = rgb565_be(0xF2, 0xD3, 0xBF);
-    const uint16_t digit_colors[6] = {
-        hour_color, hour_color,
-        minute_color, minute_color,
-        second_color, second_color
-    };
-    const uint16_t colon_color = rgb565_be(0xF7, 0xF3, 0xE8);
-
-    const int digit_w = 36;
-    const int digit_h = 84;
-    const int seg_w = 7;
-    const int colon_w = 6;
-    const int gap = 6;
-
-    int total_w = (6 * digit_w) + (2 * colon_w) + (7 * gap);
-    int x0 = (LCD_H_RES - total_w) / 2;
-    int y = (LCD_V_RES - digit_h) / 2;
-
-    int digits[6] = {
-        ti->tm_hour / 10,
-        ti->tm_hour % 10,
-        ti->tm_min / 10,
-        ti->tm_min % 10,
-        ti->tm_sec / 10,
-        ti->tm_sec % 10
-    };
-
-    static bool initialized = false;
-    static int last_digits[6] = {-1, -1, -1, -1, -1, -1};
-
-    int digit_x[6] = {0};
-    int colon_x[2] = {0};
-    int x = x0;
-    for (int i = 0; i < 6; i++) {
-        digit_x[i] = x;
-        x += digit_w;
-
-        if (i == 1) {
-            x += gap;
-            colon_x[0] = x;
-            x += colon_w;
-        } else if (i == 3) {
-            x += gap;
-            colon_x[1] = x;
-            x += colon_w;
-        }
-        x += gap;
-    }
-
-    if (!initialized) {
-        lcd_fill_rect(0, 0, LCD_H_RES, LCD_V_RES, bg);
-        for (int i = 0; i < 6; i++) {
-            draw_digit_value(digit_x[i], y, digit_w, digit_h, seg_w, digits[i], digit_colors[i]);
-            last_digits[i] = digits[i];
-        }
-        draw_colon(colon_x[0], y, digit_h, colon_w, colon_color);
-        draw_colon(colon_x[1], y, digit_h, colon_w, colon_color);
-        initialized = true;
-        return;
+    q565_decoder_t dec;
+    if (!s_panel || !q565_decoder_init(&dec, data, len)) {
+        return false;
+    }
+    if (x < 0 || y < 0 || x + dec.width > LCD_H_RES || y + dec.height > LCD_V_RES) {
+        return false;  // bands are whole rows; no clipping
     }
 
-    for (int i = 0; i < 6; i++) {
-        if (digits[i] == last_digits[i]) {
-            continue;
-        }
-        uint8_t old_mask = (last_digits[i] >= 0 && last_digits[i] <= 9) ? s_digit_mask[last_digits[i]] : 0;
-        uint8_t new_mask = s_digit_mask[digits[i]];
-        uint8_t turn_off = old_mask & (uint8_t)(~new_mask);
-        uint8_t turn_on = new_mask & (uint8_t)(~old_mask);
-        if (turn_off) {
-            draw_digit_mask(digit_x[i], y, digit_w, digit_h, seg_w, turn_off, bg);
+    int band_rows = dma_draw_band_rows(dec.width);
+    int row = 0;
+    while (row < dec.height) {
+        uint16_t *block = lcd_acquire_block();
+        if (!block) {
+            return false;
         }
-        if (turn_on) {
-            draw_digit_mask(digit_x[i], y, digit_w, digit_h, seg_w, turn_on, digit_colors[i]);
+        int rows = q565_decode_rows(&dec, block, band_rows);
+        if (rows <= 0) {
+            dma_arena_release(DMA_POOL_DRAW, block);
+            ESP_LOGW(TAG, "q565: corrupt stream at row %d", row);
+            return false;
         }
-        last_digits[i] = digits[i];
+        lcd_queue_chunks(x, y + row, dec.width, rows, rows, block, block);
+        row += rows;
     }
+    return true;
 }
 
-static esp_err_t i2c_write_u8(uint8_t dev_addr, uint8_t reg, uint8_t val)
+static bool lcd_draw_asset(const asset_t *asset, int x, int y)
 {
-    uint8_t payload[2] = {reg, val};
-    return i2c_master_write_to_device(EXIO_I2C_PORT, dev_addr, payload, sizeof(payload), pdMS_TO_TICKS(100));
+    if (!asset) {
+        return false;
+    }
+    if (asset->encoding == ASSET_ENCODING_Q565) {
+        return lcd_draw_q565(x, y, asset->data, asset->bytes);
+    }
+    lcd_blit(x, y, asset->width, asset->height, asset->pixels, asset->width);
+    return true;
 }
 
 static esp_err_t exio_write_reg(uint8_t reg, uint8_t val)
 {
-    return i2c_write_u8(EXIO_ADDR, reg, val);
+    uint8_t payload[2] = {reg, val};
+    return i2c_bus_write(I2C_BUS_CLIENT_EXIO, EXIO_ADDR, payload, sizeof(payload));
 }
 
 static esp_err_t exio_write_output(uint8_t val)
@@ -549,17 +810,8 @@ static esp_err_t exio_set_pin_level(uint8_t exio_pin, bool high)
 
 static void exio_init(void)
 {
-    i2c_config_t conf = {
-        .mode = I2C_MODE_MASTER,
-        .sda_io_num = EXIO_I2C_SDA,
-        .scl_io_num = EXIO_I2C_SCL,
-        .sda_pullup_en = GPIO_PULLUP_ENABLE,
-        .scl_pullup_en = GPIO_PULLUP_ENABLE,
-        .master.clk_speed = 400000,
-        .clk_flags = 0,
-    };
-    ESP_ERROR_CHECK(i2c_param_config(EXIO_I2C_PORT, &conf));
-    ESP_ERROR_CHECK(i2c_driver_install(EXIO_I2C_PORT, conf.mode, 0, 0, 0));
+    // The touch controller sits on the same bus; i2c_bus arbitrates between the two.
+    ESP_ERROR_CHECK(i2c_bus_init(EXIO_I2C_PORT, EXIO_I2C_SDA, EXIO_I2C_SCL, 400000));
 
     // TCA9554: all pins output.
     ESP_ERROR_CHECK(exio_write_reg(EXIO_REG_CONFIG, 0x00));
@@ -568,11 +820,13 @@ static void exio_init(void)
     ESP_LOGI(TAG, "EXIO output default: 0x%02x", s_exio_output_state);
 }
 
+// LCD and touch controller share one reset pulse; the touch chip is up well within the LCD's 120 ms.
 static void lcd_hw_reset_via_exio(void)
 {
-    ESP_ERROR_CHECK(exio_set_pin_level(EXIO_LCD_RST_PIN, false));
+    uint8_t rst_mask = (uint8_t)((1U << (EXIO_LCD_RST_PIN - 1)) | (1U << (EXIO_TOUCH_RST_PIN - 1)));
+    ESP_ERROR_CHECK(exio_write_output(s_exio_output_state & (uint8_t)~rst_mask));
     vTaskDelay(pdMS_TO_TICKS(20));
-    ESP_ERROR_CHECK(exio_set_pin_level(EXIO_LCD_RST_PIN, true));
+    ESP_ERROR_CHECK(exio_write_output(s_exio_output_state | rst_mask));
     vTaskDelay(pdMS_TO_TICKS(120));
 }
 
@@ -591,7 +845,8 @@ static bool beep_init_i2s(void)
     i2s_chan_config_t chan_cfg = I2S_CHANNEL_DEFAULT_CONFIG(I2S_NUM_0, I2S_ROLE_MASTER);
     chan_cfg.auto_clear = true;
 
-    esp_err_t err = i2s_new_channel(&chan_cfg, &s_i2s_tx_chan, &s_i2s_rx_chan);
+    // TX only: the mic has its own pins and rate, so it runs on a second port (mic_capture.c).
+    esp_err_t err = i2s_new_channel(&chan_cfg, &s_i2s_tx_chan, NULL);
     if (err != ESP_OK) {
         ESP_LOGW(TAG, "i2s_new_channel failed: %s", esp_err_to_name(err));
         return false;
@@ -620,90 +875,87 @@ static bool beep_init_i2s(void)
         return false;
     }
 
-    err = i2s_channel_enable(s_i2s_tx_chan);
-    if (err != ESP_OK) {
-        ESP_LOGW(TAG, "i2s_channel_enable failed: %s", esp_err_to_name(err));
-        return false;
-    }
+    // The channel is enabled per tone: an enabled channel holds a PM lock and blocks light sleep.
 
     ESP_LOGI(TAG, "beep i2s ready: %d Hz, PHILIPS, bclk=%d ws=%d dout=%d",
              BEEP_SAMPLE_RATE_HZ, SPEAKER_I2S_BCLK, SPEAKER_I2S_WS, SPEAKER_I2S_DOUT);
     return true;
 }
 
-static bool beep_build_tone(uint32_t freq_hz, uint32_t duration_ms)
+// Square wave synthesized one arena block at a time, so a tone of any length needs no heap.
+static void beep_play_tone(uint32_t freq_hz, uint32_t duration_ms)
 {
-    size_t samples = (BEEP_SAMPLE_RATE_HZ * (size_t)duration_ms) / 1000U;
-    if (samples == 0) {
-        samples = 1;
+    if (!s_i2s_tx_chan) {
+        return;
     }
 
-    size_t bytes = samples * 2U * sizeof(int16_t);  // stereo 16-bit
-    if (bytes != s_beep_pcm_bytes || s_beep_pcm == NULL) {
-        if (s_beep_pcm) {
-            free(s_beep_pcm);
-            s_beep_pcm = NULL;
-            s_beep_pcm_bytes = 0;
-        }
-        s_beep_pcm = heap_caps_malloc(bytes, MALLOC_CAP_INTERNAL);
-        if (!s_beep_pcm) {
-            s_beep_pcm = heap_caps_malloc(bytes, MALLOC_CAP_DEFAULT);
-        }
-        if (!s_beep_pcm) {
-            ESP_LOGW(TAG, "beep pcm alloc failed: %u bytes", (unsigned)bytes);
-            return false;
-        }
-        s_beep_pcm_bytes = bytes;
+    int16_t *block = dma_arena_acquire(DMA_POOL_I2S);
+    if (!block) {
+        ESP_LOGW(TAG, "beep: no free i2s block");
+        return;
     }
 
-    uint32_t period = (freq_hz > 0) ? (BEEP_SAMPLE_RATE_HZ / freq_hz) : 0;
-    if (period < 2) {
-        period = 2;
+    // Keeps the detector from hearing the tone as voice; claps still get through.
+    mic_capture_set_playback(true);
+    esp_err_t last_err = i2s_channel_enable(s_i2s_tx_chan);
+    if (last_err != ESP_OK) {
+        mic_capture_set_playback(false);
+        ESP_LOGW(TAG, "i2s_channel_enable failed: %s", esp_err_to_name(last_err));
+        dma_arena_release(DMA_POOL_I2S, block);
+        return;
     }
 
-    for (size_t i = 0; i < samples; i++) {
-        int16_t sample = ((i % period) < (period / 2U)) ? BEEP_AMPLITUDE : (int16_t)-BEEP_AMPLITUDE;
-        s_beep_pcm[i * 2] = sample;
-        s_beep_pcm[i * 2 + 1] = sample;
+    size_t samples = (BEEP_SAMPLE_RATE_HZ * (size_t)duration_ms) / 1000U;
+    if (samples == 0) {
+        samples = 1;
     }
-    return true;
-}
-
-static void beep_play_once(void)
-{
-    if (!s_i2s_tx_chan || !s_beep_pcm || s_beep_pcm_bytes == 0) {
-        return;
+    uint32_t period = (freq_hz > 0) ? (BEEP_SAMPLE_RATE_HZ / freq_hz) : 0;
+    if (period < 2) {
+        period = 2;
     }
 
-    size_t offset = 0;
-    esp_err_t last_err = ESP_OK;
-    while (offset < s_beep_pcm_bytes) {
-        size_t remain = s_beep_pcm_bytes - offset;
-        size_t chunk = (remain > BEEP_WRITE_CHUNK_BYTES) ? BEEP_WRITE_CHUNK_BYTES : remain;
-        size_t written = 0;
-
-        esp_err_t err = i2s_channel_write(
-            s_i2s_tx_chan,
-            ((const uint8_t *)s_beep_pcm) + offset,
-            chunk,
-            &written,
-            pdMS_TO_TICKS(BEEP_WRITE_TIMEOUT_MS));
+    const size_t frames_per_block = DMA_I2S_BLOCK_BYTES / (2U * sizeof(int16_t));  // stereo 16-bit
+    size_t done = 0;
+    while (done < samples) {
+        size_t frames = samples - done;
+        if (frames > frames_per_block) {
+            frames = frames_per_block;
+        }
+        for (size_t i = 0; i < frames; i++) {
+            size_t n = done + i;
+            int16_t sample = ((n % period) < (period / 2U)) ? BEEP_AMPLITUDE : (int16_t)-BEEP_AMPLITUDE;
+            block[i * 2] = sample;
+            block[i * 2 + 1] = sample;
+        }
 
-        if (written > 0) {
+        size_t bytes = frames * 2U * sizeof(int16_t);
+        size_t offset = 0;
+        while (offset < bytes) {
+            size_t written = 0;
+            esp_err_t err = i2s_channel_write(s_i2s_tx_chan, (const uint8_t *)block + offset, bytes - offset,
+                                              &written, pdMS_TO_TICKS(BEEP_WRITE_TIMEOUT_MS));
             offset += written;
+            if (err != ESP_OK) {
+                last_err = err;
+                if (written == 0) {
+                    break;
+                }
+            }
         }
-        if (err != ESP_OK && written == 0) {
-            last_err = err;
+        if (offset != bytes) {
             break;
         }
-        if (err != ESP_OK) {
-            last_err = err;
-        }
+        done += frames;
     }
 
-    if (offset != s_beep_pcm_bytes) {
-        ESP_LOGW(TAG, "beep write partial: %u/%u bytes, err=%s",
-                 (unsigned)offset, (unsigned)s_beep_pcm_bytes, esp_err_to_name(last_err));
+    vTaskDelay(pdMS_TO_TICKS(BEEP_DRAIN_MS));
+    i2s_channel_disable(s_i2s_tx_chan);
+    mic_capture_set_playback(false);
+    dma_arena_release(DMA_POOL_I2S, block);
+
+    if (done != samples) {
+        ESP_LOGW(TAG, "beep write partial: %u/%u frames, err=%s",
+                 (unsigned)done, (unsigned)samples, esp_err_to_name(last_err));
     }
 }
 
@@ -719,49 +971,13 @@ static void audio_boot_self_test(void)
     for (size_t i = 0; i < 2; i++) {
         audio_amp_set(amp_levels[i]);
         vTaskDelay(pdMS_TO_TICKS(60));
-        if (!beep_build_tone(freqs[i], 220)) {
-            return;
-        }
         ESP_LOGI(TAG, "audio self-test tone %u/2: amp_sd=%d freq=%u",
                  (unsigned)(i + 1), amp_levels[i] ? 1 : 0, (unsigned)freqs[i]);
-        beep_play_once();
+        beep_play_tone(freqs[i], 220);
         vTaskDelay(pdMS_TO_TICKS(120));
     }
 }
 
-static void backlight_init(void)
-{
-    ledc_timer_config_t timer_cfg = {
-        .speed_mode = LEDC_LOW_SPEED_MODE,
-        .duty_resolution = LEDC_TIMER_10_BIT,
-        .timer_num = LEDC_TIMER_0,
-        .freq_hz = 20000,
-        .clk_cfg = LEDC_AUTO_CLK,
-    };
-    ledc_channel_config_t channel_cfg = {
-        .gpio_num = LCD_PIN_BACKLIGHT,
-        .speed_mode = LEDC_LOW_SPEED_MODE,
-        .channel = LEDC_CHANNEL_0,
-        .timer_sel = LEDC_TIMER_0,
-        .duty = 0,
-        .hpoint = 0,
-        .intr_type = LEDC_INTR_DISABLE,
-        .flags.output_invert = 0,
-    };
-    ESP_ERROR_CHECK(ledc_timer_config(&timer_cfg));
-    ESP_ERROR_CHECK(ledc_channel_config(&channel_cfg));
-}
-
-static void backlight_set_percent(uint8_t percent)
-{
-    if (percent > 100) {
-        percent = 100;
-    }
-    uint32_t duty = (percent * 1023U) / 100U;
-    ESP_ERROR_CHECK(ledc_set_duty(LEDC_LOW_SPEED_MODE, LEDC_CHANNEL_0, duty));
-    ESP_ERROR_CHECK(ledc_update_duty(LEDC_LOW_SPEED_MODE, LEDC_CHANNEL_0));
-}
-
 static void lcd_init(void)
 {
     gpio_set_direction(LCD_PIN_TE, GPIO_MODE_OUTPUT);
@@ -779,7 +995,10 @@ static void lcd_init(void)
     };
     ESP_ERROR_CHECK(spi_bus_initialize(LCD_SPI_HOST, &bus_cfg, SPI_DMA_CH_AUTO));
 
-    esp_lcd_panel_io_spi_config_t io_cfg = ST77916_PANEL_IO_QSPI_CONFIG(LCD_PIN_CS, NULL, NULL);
+    s_lcd_idle_sem = xSemaphoreCreateBinary();
+    assert(s_lcd_idle_sem);
+
+    esp_lcd_panel_io_spi_config_t io_cfg = ST77916_PANEL_IO_QSPI_CONFIG(LCD_PIN_CS, lcd_on_color_trans_done, NULL);
     io_cfg.pclk_hz = 20 * 1000 * 1000;
     io_cfg.trans_queue_depth = 10;
 
@@ -806,35 +1025,187 @@ static void lcd_init(void)
     ESP_ERROR_CHECK(esp_lcd_panel_disp_on_off(s_panel, true));
 }
 
+static void nvs_init(void)
+{
+    esp_err_t ret = nvs_flash_init();
+    if (ret == ESP_ERR_NVS_NO_FREE_PAGES || ret == ESP_ERR_NVS_NEW_VERSION_FOUND) {
+        ESP_ERROR_CHECK(nvs_flash_erase());
+        ret = nvs_flash_init();
+    }
+    ESP_ERROR_CHECK(ret);
+}
+
+static bool wifi_cache_load(wifi_ap_cache_t *out)
+{
+    nvs_handle_t nvs = 0;
+    if (nvs_open(WIFI_CACHE_NVS_NS, NVS_READONLY, &nvs) != ESP_OK) {
+        return false;
+    }
+
+    size_t len = sizeof(*out);
+    esp_err_t err = nvs_get_blob(nvs, WIFI_CACHE_NVS_KEY, out, &len);
+    nvs_close(nvs);
+    return err == ESP_OK && len == sizeof(*out) &&
+           out->version == WIFI_CACHE_VERSION &&
+           out->channel >= 1 && out->channel <= 14;
+}
+
+static void wifi_cache_store(const wifi_ap_cache_t *cache)
+{
+    nvs_handle_t nvs = 0;
+    esp_err_t err = nvs_open(WIFI_CACHE_NVS_NS, NVS_READWRITE, &nvs);
+    if (err == ESP_OK) {
+        if (cache) {
+            err = nvs_set_blob(nvs, WIFI_CACHE_NVS_KEY, cache, sizeof(*cache));
+        } else {
+            err = nvs_erase_key(nvs, WIFI_CACHE_NVS_KEY);
+            if (err == ESP_ERR_NVS_NOT_FOUND) {
+                err = ESP_OK;
+            }
+        }
+        if (err == ESP_OK) {
+            err = nvs_commit(nvs);
+        }
+        nvs_close(nvs);
+    }
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "wifi cache write failed: %s", esp_err_to_name(err));
+    }
+}
+
+static void wifi_apply_sta_config(bool use_cache)
+{
+    wifi_config_t wifi_cfg = {0};
+    strlcpy((char *)wifi_cfg.sta.ssid, WIFI_SSID, sizeof(wifi_cfg.sta.ssid));
+    strlcpy((char *)wifi_cfg.sta.password, WIFI_PASS, sizeof(wifi_cfg.sta.password));
+    wifi_cfg.sta.pmf_cfg.capable = true;
+    wifi_cfg.sta.pmf_cfg.required = false;
+
+    if (use_cache) {
+        // Probe only the cached channel and join the cached AP directly.
+        wifi_cfg.sta.scan_method = WIFI_FAST_SCAN;
+        wifi_cfg.sta.channel = s_wifi_cache.channel;
+        wifi_cfg.sta.bssid_set = true;
+        memcpy(wifi_cfg.sta.bssid, s_wifi_cache.bssid, sizeof(wifi_cfg.sta.bssid));
+    } else {
+        wifi_cfg.sta.scan_method = WIFI_ALL_CHANNEL_SCAN;
+        wifi_cfg.sta.sort_method = WIFI_CONNECT_AP_BY_SIGNAL;
+    }
+
+    s_wifi_using_cache = use_cache;
+    ESP_ERROR_CHECK(esp_wifi_set_config(WIFI_IF_STA, &wifi_cfg));
+}
+
+static void wifi_retry_timer_cb(void *arg)
+{
+    (void)arg;
+    s_wifi_start_us = esp_timer_get_time();
+    esp_wifi_connect();
+}
+
+static void wifi_schedule_retry(void)
+{
+    int shift = (s_wifi_retry_count < 16) ? s_wifi_retry_count : 16;
+    uint32_t delay_ms = (uint32_t)WIFI_BACKOFF_MIN_MS << shift;
+    if (delay_ms > WIFI_BACKOFF_MAX_MS) {
+        delay_ms = WIFI_BACKOFF_MAX_MS;
+    }
+    s_wifi_retry_count++;
+
+    if (s_wifi_retry_count >= WIFI_MAX_RETRY) {
+        xEventGroupSetBits(s_wifi_event_group, WIFI_FAIL_BIT);
+    }
+
+    ESP_LOGI(TAG, "retry Wi-Fi connection #%d in %u ms", s_wifi_retry_count, (unsigned)delay_ms);
+    esp_timer_stop(s_wifi_retry_timer);
+    esp_timer_start_once(s_wifi_retry_timer, (uint64_t)delay_ms * 1000ULL);
+}
+
 static void wifi_event_handler(void *arg, esp_event_base_t event_base, int32_t event_id, void *event_data)
 {
     (void)arg;
-    (void)event_data;
 
     if (event_base == WIFI_EVENT && event_id == WIFI_EVENT_STA_START) {
+        s_wifi_start_us = esp_timer_get_time();
         esp_wifi_connect();
+    } else if (event_base == WIFI_EVENT && event_id == WIFI_EVENT_STA_CONNECTED) {
+        const wifi_event_sta_connected_t *ev = (const wifi_event_sta_connected_t *)event_data;
+        s_wifi_connected_us = esp_timer_get_time();
+        // The driver reports no separate scan/auth/assoc events, so this span covers all three.
+        ESP_LOGI(TAG, "wifi timing: scan+auth+assoc %lld ms (%s scan, ch=%d)",
+                 (long long)((s_wifi_connected_us - s_wifi_start_us) / 1000),
+                 s_wifi_using_cache ? "fast" : "full", ev->channel);
+
+        s_wifi_cache.version = WIFI_CACHE_VERSION;
+        s_wifi_cache.channel = ev->channel;
+        memcpy(s_wifi_cache.bssid, ev->bssid, sizeof(s_wifi_cache.bssid));
     } else if (event_base == WIFI_EVENT && event_id == WIFI_EVENT_STA_DISCONNECTED) {
-        if (s_wifi_retry_count < WIFI_MAX_RETRY) {
-            esp_wifi_connect();
-            s_wifi_retry_count++;
-            ESP_LOGI(TAG, "retry Wi-Fi connection (%d/%d)", s_wifi_retry_count, WIFI_MAX_RETRY);
-        } else {
-            xEventGroupSetBits(s_wifi_event_group, WIFI_FAIL_BIT);
+        const wifi_event_sta_disconnected_t *ev = (const wifi_event_sta_disconnected_t *)event_data;
+        xEventGroupClearBits(s_wifi_event_group, WIFI_CONNECTED_BIT);
+        ESP_LOGW(TAG, "Wi-Fi disconnected, reason=%d", ev->reason);
+
+        if (s_wifi_using_cache) {
+            // Never reconnect blindly to the cached AP; a fresh full scan picks the best one.
+            wifi_apply_sta_config(false);
+            if (!s_wifi_got_ip) {
+                // Cached AP/channel is stale: forget it and go straight to a full scan.
+                ESP_LOGW(TAG, "cached AP failed, fall back to full scan");
+                s_wifi_cache_valid = false;
+                wifi_cache_store(NULL);
+                s_wifi_start_us = esp_timer_get_time();
+                esp_wifi_connect();
+                return;
+            }
         }
+        wifi_schedule_retry();
     } else if (event_base == IP_EVENT && event_id == IP_EVENT_STA_GOT_IP) {
+        int64_t now_us = esp_timer_get_time();
+        ESP_LOGI(TAG, "wifi timing: dhcp %lld ms, time-to-IP %lld ms",
+                 (long long)((now_us - s_wifi_connected_us) / 1000),
+                 (long long)((now_us - s_boot_us) / 1000));
+
+        wifi_ap_cache_t stored = {0};
+        bool stored_valid = s_wifi_cache_valid && wifi_cache_load(&stored);
+        if (!stored_valid || memcmp(&stored, &s_wifi_cache, sizeof(stored)) != 0) {
+            wifi_cache_store(&s_wifi_cache);
+            s_wifi_cache_valid = true;
+        }
+
+        s_wifi_got_ip = true;
         s_wifi_retry_count = 0;
         xEventGroupSetBits(s_wifi_event_group, WIFI_CONNECTED_BIT);
     }
 }
 
-static void nvs_init(void)
+static void wifi_apply_static_ip(void)
 {
-    esp_err_t ret = nvs_flash_init();
-    if (ret == ESP_ERR_NVS_NO_FREE_PAGES || ret == ESP_ERR_NVS_NEW_VERSION_FOUND) {
-        ESP_ERROR_CHECK(nvs_flash_erase());
-        ret = nvs_flash_init();
+    if (strlen(WIFI_STATIC_IP) == 0) {
+        return;
     }
-    ESP_ERROR_CHECK(ret);
+
+    esp_netif_ip_info_t ip_info = {0};
+    if (esp_netif_str_to_ip4(WIFI_STATIC_IP, &ip_info.ip) != ESP_OK ||
+        esp_netif_str_to_ip4(WIFI_STATIC_NETMASK, &ip_info.netmask) != ESP_OK ||
+        esp_netif_str_to_ip4(WIFI_STATIC_GW, &ip_info.gw) != ESP_OK) {
+        ESP_LOGW(TAG, "invalid static IP config, keep DHCP");
+        return;
+    }
+
+    ESP_ERROR_CHECK(esp_netif_dhcpc_stop(s_wifi_netif));
+    ESP_ERROR_CHECK(esp_netif_set_ip_info(s_wifi_netif, &ip_info));
+
+    esp_netif_dns_info_t dns = {0};
+    if (esp_netif_str_to_ip4(WIFI_STATIC_DNS, &dns.ip.u_addr.ip4) == ESP_OK) {
+        dns.ip.type = ESP_IPADDR_TYPE_V4;
+        esp_netif_set_dns_info(s_wifi_netif, ESP_NETIF_DNS_MAIN, &dns);
+    }
+    ESP_LOGI(TAG, "using static IP %s", WIFI_STATIC_IP);
+}
+
+static bool wifi_is_connected(void)
+{
+    return s_wifi_event_group &&
+           (xEventGroupGetBits(s_wifi_event_group) & WIFI_CONNECTED_BIT) != 0;
 }
 
 static bool wifi_connect_blocking(void)
@@ -849,35 +1220,47 @@ static bool wifi_connect_blocking(void)
         return false;
     }
 
+    const esp_timer_create_args_t retry_timer_args = {
+        .callback = wifi_retry_timer_cb,
+        .name = "wifi_retry",
+    };
+    ESP_ERROR_CHECK(esp_timer_create(&retry_timer_args, &s_wifi_retry_timer));
+
     ESP_ERROR_CHECK(esp_netif_init());
     ESP_ERROR_CHECK(esp_event_loop_create_default());
-    esp_netif_create_default_wifi_sta();
+    s_wifi_netif = esp_netif_create_default_wifi_sta();
+    wifi_apply_static_ip();
 
     wifi_init_config_t cfg = WIFI_INIT_CONFIG_DEFAULT();
     ESP_ERROR_CHECK(esp_wifi_init(&cfg));
+    // Config is rebuilt every boot; keep the driver from rewriting it to flash.
+    ESP_ERROR_CHECK(esp_wifi_set_storage(WIFI_STORAGE_RAM));
 
-    esp_event_handler_instance_t any_id;
-    esp_event_handler_instance_t got_ip;
+    // Handlers stay registered so the backoff reconnect keeps running after boot.
     ESP_ERROR_CHECK(esp_event_handler_instance_register(WIFI_EVENT,
                                                         ESP_EVENT_ANY_ID,
                                                         &wifi_event_handler,
                                                         NULL,
-                                                        &any_id));
+                                                        NULL));
     ESP_ERROR_CHECK(esp_event_handler_instance_register(IP_EVENT,
                                                         IP_EVENT_STA_GOT_IP,
                                                         &wifi_event_handler,
                                                         NULL,
-                                                        &got_ip));
-
-    wifi_config_t wifi_cfg = {0};
-    strlcpy((char *)wifi_cfg.sta.ssid, WIFI_SSID, sizeof(wifi_cfg.sta.ssid));
-    strlcpy((char *)wifi_cfg.sta.password, WIFI_PASS, sizeof(wifi_cfg.sta.password));
-    wifi_cfg.sta.pmf_cfg.capable = true;
-    wifi_cfg.sta.pmf_cfg.required = false;
+                                                        NULL));
+
+    s_wifi_cache_valid = wifi_cache_load(&s_wifi_cache);
+    if (s_wifi_cache_valid) {
+        ESP_LOGI(TAG, "cached AP %02x:%02x:%02x:%02x:%02x:%02x ch=%d",
+                 s_wifi_cache.bssid[0], s_wifi_cache.bssid[1], s_wifi_cache.bssid[2],
+                 s_wifi_cache.bssid[3], s_wifi_cache.bssid[4], s_wifi_cache.bssid[5],
+                 s_wifi_cache.channel);
+    }
 
     ESP_ERROR_CHECK(esp_wifi_set_mode(WIFI_MODE_STA));
-    ESP_ERROR_CHECK(esp_wifi_set_config(WIFI_IF_STA, &wifi_cfg));
+    wifi_apply_sta_config(s_wifi_cache_valid);
     ESP_ERROR_CHECK(esp_wifi_start());
+    // Modem sleep lets auto light sleep run between DTIM beacons without dropping the AP.
+    ESP_ERROR_CHECK(esp_wifi_set_ps(WIFI_PS_MIN_MODEM));
 
     ESP_LOGI(TAG, "connecting to Wi-Fi: %s", WIFI_SSID);
     EventBits_t bits = xEventGroupWaitBits(
@@ -889,30 +1272,210 @@ static bool wifi_connect_blocking(void)
 
     bool connected = (bits & WIFI_CONNECTED_BIT) != 0;
     if (!connected) {
-        ESP_LOGW(TAG, "Wi-Fi connect timeout or failure");
+        ESP_LOGW(TAG, "Wi-Fi connect timeout or failure, keep retrying in background");
     }
 
-    ESP_ERROR_CHECK(esp_event_handler_instance_unregister(IP_EVENT, IP_EVENT_STA_GOT_IP, got_ip));
-    ESP_ERROR_CHECK(esp_event_handler_instance_unregister(WIFI_EVENT, ESP_EVENT_ANY_ID, any_id));
-    vEventGroupDelete(s_wifi_event_group);
-    s_wifi_event_group = NULL;
-
     return connected;
 }
 
-static bool sync_time_from_ntp(void)
+static const char *time_source_name(time_source_t source)
 {
-    setenv("TZ", CLOCK_TIMEZONE, 1);
-    tzset();
+    switch (source) {
+    case TIME_SOURCE_NTP:
+        return "ntp";
+    case TIME_SOURCE_RETAINED:
+        return "retained";
+    case TIME_SOURCE_ESTIMATE:
+        return "estimate";
+    default:
+        return "uptime";
+    }
+}
 
-    static const char *ntp_servers[] = {
-        "ntp.aliyun.com",
-        "ntp.ntsc.ac.cn",
-        "pool.ntp.org",
-        "time.cloudflare.com",
-    };
+static int64_t time_wall_us(void)
+{
+    struct timeval tv = {0};
+    gettimeofday(&tv, NULL);
+    return (int64_t)tv.tv_sec * 1000000LL + tv.tv_usec;
+}
 
-    time_t now = 0;
+static void time_set_wall_us(int64_t wall_us)
+{
+    struct timeval tv = {
+        .tv_sec = (time_t)(wall_us / 1000000LL),
+        .tv_usec = (suseconds_t)(wall_us % 1000000LL),
+    };
+    settimeofday(&tv, NULL);
+}
+
+static bool time_wall_is_plausible(int64_t wall_us)
+{
+    time_t t = (time_t)(wall_us / 1000000LL);
+    struct tm ti = {0};
+    gmtime_r(&t, &ti);
+    return ti.tm_year >= (TIME_VALID_MIN_YEAR - 1900);
+}
+
+static void time_nvs_save(void)
+{
+    time_nvs_state_t state = {
+        .version = TIME_NVS_VERSION,
+        .synced = (s_time_source == TIME_SOURCE_NTP || s_time_source == TIME_SOURCE_RETAINED),
+        .epoch_us = time_wall_us(),
+        .drift_ppb = s_time_rtc.drift_ppb,
+    };
+
+    nvs_handle_t nvs = 0;
+    esp_err_t err = nvs_open(TIME_NVS_NS, NVS_READWRITE, &nvs);
+    if (err == ESP_OK) {
+        err = nvs_set_blob(nvs, TIME_NVS_KEY, &state, sizeof(state));
+        if (err == ESP_OK) {
+            err = nvs_commit(nvs);
+        }
+        nvs_close(nvs);
+    }
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "time snapshot write failed: %s", esp_err_to_name(err));
+    }
+}
+
+static bool time_nvs_load(time_nvs_state_t *out)
+{
+    nvs_handle_t nvs = 0;
+    if (nvs_open(TIME_NVS_NS, NVS_READONLY, &nvs) != ESP_OK) {
+        return false;
+    }
+
+    size_t len = sizeof(*out);
+    esp_err_t err = nvs_get_blob(nvs, TIME_NVS_KEY, out, &len);
+    nvs_close(nvs);
+    return err == ESP_OK && len == sizeof(*out) && out->version == TIME_NVS_VERSION;
+}
+
+// Decide what the first frame can trust. Must run before the first face_draw().
+static void time_restore_at_boot(void)
+{
+    setenv("TZ", CLOCK_TIMEZONE, 1);
+    tzset();
+
+    esp_reset_reason_t reason = esp_reset_reason();
+    bool rtc_kept = reason != ESP_RST_POWERON && reason != ESP_RST_BROWNOUT &&
+                    reason != ESP_RST_UNKNOWN && s_time_rtc.magic == TIME_RTC_MAGIC;
+
+    if (rtc_kept && s_time_rtc.source >= TIME_SOURCE_RETAINED) {
+        int64_t now_us = time_wall_us();
+        if (now_us < s_time_rtc.last_seen_us) {
+            // System time did not survive this reset type; resume from the last tick. The
+            // downtime before the reset is gone, so the next sync cannot measure drift.
+            now_us = s_time_rtc.last_seen_us + esp_timer_get_time();
+            s_time_rtc.rebuilt = 1;
+        }
+        // Fold in the drift accumulated since the last sync or earlier correction.
+        int64_t from_us = (s_time_rtc.corrected_us > s_time_rtc.last_sync_us)
+                          ? s_time_rtc.corrected_us : s_time_rtc.last_sync_us;
+        int64_t span_us = now_us - from_us;
+        if (span_us > 0) {
+            int64_t fold_us = (span_us / 1000000LL) * s_time_rtc.drift_ppb / 1000LL;
+            now_us += fold_us;
+            s_time_rtc.folded_us += fold_us;
+        }
+        s_time_rtc.corrected_us = now_us;
+        time_set_wall_us(now_us);
+        s_time_source = TIME_SOURCE_RETAINED;
+        ESP_LOGI(TAG, "time retained across reset (reason=%d), drift=%ld ppb",
+                 reason, (long)s_time_rtc.drift_ppb);
+        return;
+    }
+
+    memset(&s_time_rtc, 0, sizeof(s_time_rtc));
+    s_time_rtc.magic = TIME_RTC_MAGIC;
+
+    time_nvs_state_t saved = {0};
+    if (time_nvs_load(&saved) && time_wall_is_plausible(saved.epoch_us)) {
+        // Power was lost for an unknown time: show the snapshot, flagged as unsynced.
+        time_set_wall_us(saved.epoch_us);
+        bool drift_ok = saved.drift_ppb >= -TIME_DRIFT_MAX_PPB && saved.drift_ppb <= TIME_DRIFT_MAX_PPB;
+        s_time_rtc.drift_ppb = drift_ok ? saved.drift_ppb : 0;
+        s_time_source = TIME_SOURCE_ESTIMATE;
+        ESP_LOGI(TAG, "time estimated from NVS snapshot (reason=%d, was %s)",
+                 reason, saved.synced ? "synced" : "unsynced");
+        return;
+    }
+
+    s_time_source = TIME_SOURCE_UPTIME;
+}
+
+// Overrides the weak lwIP SNTP hook so the clock error at each sync can feed the drift estimate.
+void sntp_sync_time(struct timeval *tv)
+{
+    int64_t before_us = time_wall_us();
+    int64_t ntp_us = (int64_t)tv->tv_sec * 1000000LL + tv->tv_usec;
+    settimeofday(tv, NULL);
+    sntp_set_sync_status(SNTP_SYNC_STATUS_COMPLETED);
+
+    // Only a clock that ran on its own since the last sync measures the oscillator: not an NVS
+    // estimate and not one rebuilt from last_seen_us after a reset.
+    if ((s_time_source == TIME_SOURCE_NTP || s_time_source == TIME_SOURCE_RETAINED) && !s_time_rtc.rebuilt) {
+        int64_t span_us = before_us - s_time_rtc.last_sync_us;
+        if (span_us >= (int64_t)TIME_DRIFT_MIN_SPAN_S * 1000000LL) {
+            // Corrections folded in at boot hid part of the error; the oscillator made all of it.
+            int64_t error_us = ntp_us - before_us + s_time_rtc.folded_us;
+            int64_t limit_us = span_us / 1000000LL * TIME_DRIFT_MAX_PPB / 1000LL;
+            if (error_us > limit_us || error_us < -limit_us) {
+                ESP_LOGW(TAG, "clock off by %lld ms over %lld s; not drift, estimate kept",
+                         (long long)(error_us / 1000), (long long)(span_us / 1000000LL));
+            } else {
+                int64_t measured = error_us * 1000000LL / (span_us / 1000LL);
+                int64_t drift = (s_time_rtc.drift_ppb == 0)
+                                ? measured
+                                : ((int64_t)s_time_rtc.drift_ppb * 3 + measured) / 4;
+                s_time_rtc.drift_ppb = (int32_t)drift;
+            }
+        }
+    }
+
+    s_time_rtc.magic = TIME_RTC_MAGIC;
+    s_time_rtc.last_sync_us = ntp_us;
+    s_time_rtc.last_seen_us = ntp_us;
+    s_time_rtc.corrected_us = ntp_us;
+    s_time_rtc.folded_us = 0;
+    s_time_rtc.rebuilt = 0;
+    s_time_rtc.source = TIME_SOURCE_NTP;
+    s_time_source = TIME_SOURCE_NTP;
+    s_time_nvs_dirty = true;
+}
+
+// Fills ti for display and returns where the value came from.
+static time_source_t clock_read(struct tm *ti)
+{
+    memset(ti, 0, sizeof(*ti));
+    time_source_t source = s_time_source;
+
+    if (source != TIME_SOURCE_UPTIME) {
+        int64_t wall_us = time_wall_us();
+        time_t now = (time_t)(wall_us / 1000000LL);
+        localtime_r(&now, ti);
+        s_time_rtc.last_seen_us = wall_us;
+        return source;
+    }
+
+    uint64_t uptime_s = (esp_timer_get_time() - s_boot_us) / 1000000ULL;
+    ti->tm_hour = (int)((uptime_s / 3600ULL) % 24ULL);
+    ti->tm_min = (int)((uptime_s / 60ULL) % 60ULL);
+    ti->tm_sec = (int)(uptime_s % 60ULL);
+    return source;
+}
+
+static bool sync_time_from_ntp(void)
+{
+    static const char *ntp_servers[] = {
+        "ntp.aliyun.com",
+        "ntp.ntsc.ac.cn",
+        "pool.ntp.org",
+        "time.cloudflare.com",
+    };
+
+    time_t now = 0;
     struct tm ti = {0};
 
     for (size_t s = 0; s < sizeof(ntp_servers) / sizeof(ntp_servers[0]); s++) {
@@ -924,24 +1487,16 @@ static bool sync_time_from_ntp(void)
 
         ESP_LOGI(TAG, "NTP trying server: %s", ntp_servers[s]);
 
+        // A restored clock already looks valid, so only the SNTP status counts here.
         for (int i = 0; i < 50; i++) {  // 25s per server
             if (esp_sntp_get_sync_status() == SNTP_SYNC_STATUS_COMPLETED) {
                 time(&now);
                 localtime_r(&now, &ti);
-                ESP_LOGI(TAG, "NTP synced via %s: %04d-%02d-%02d %02d:%02d:%02d",
+                ESP_LOGI(TAG, "NTP synced via %s: %04d-%02d-%02d %02d:%02d:%02d, drift=%ld ppb",
                          ntp_servers[s],
                          ti.tm_year + 1900, ti.tm_mon + 1, ti.tm_mday,
-                         ti.tm_hour, ti.tm_min, ti.tm_sec);
-                return true;
-            }
-
-            time(&now);
-            localtime_r(&now, &ti);
-            if (ti.tm_year >= (2024 - 1900)) {
-                ESP_LOGI(TAG, "NTP synced via %s: %04d-%02d-%02d %02d:%02d:%02d",
-                         ntp_servers[s],
-                         ti.tm_year + 1900, ti.tm_mon + 1, ti.tm_mday,
-                         ti.tm_hour, ti.tm_min, ti.tm_sec);
+                         ti.tm_hour, ti.tm_min, ti.tm_sec,
+                         (long)s_time_rtc.drift_ppb);
                 return true;
             }
             vTaskDelay(pdMS_TO_TICKS(500));
@@ -950,58 +1505,829 @@ static bool sync_time_from_ntp(void)
         ESP_LOGW(TAG, "NTP timeout on server: %s", ntp_servers[s]);
     }
 
-    ESP_LOGW(TAG, "all NTP servers failed, fallback to uptime clock");
+    ESP_LOGW(TAG, "all NTP servers failed, keep %s clock", time_source_name(s_time_source));
+    return false;
+}
+
+static void pm_init(void)
+{
+#if CONFIG_PM_ENABLE
+    esp_pm_config_t pm_cfg = {
+        .max_freq_mhz = PM_MAX_FREQ_MHZ,
+        .min_freq_mhz = PM_MIN_FREQ_MHZ,
+        .light_sleep_enable = true,
+    };
+    esp_err_t err = esp_pm_configure(&pm_cfg);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "esp_pm_configure failed: %s", esp_err_to_name(err));
+        return;
+    }
+    ESP_ERROR_CHECK(esp_pm_lock_create(ESP_PM_CPU_FREQ_MAX, 0, "render", &s_pm_render_lock));
+    ESP_LOGI(TAG, "pm: DFS %d-%d MHz, auto light sleep on", PM_MIN_FREQ_MHZ, PM_MAX_FREQ_MHZ);
+#endif
+}
+
+// Full speed and no light sleep from the start of a frame until its last chunk leaves the SPI DMA.
+static void pm_render_begin(void)
+{
+    pm_hold();
+}
+
+static void pm_render_end(void)
+{
+    lcd_wait_idle();
+    pm_unhold();
+}
+
+// Same, without waiting: the hold passes to the bus and is dropped when the last queued chunk is
+// done, so the caller can go back to sleep while the frame is still being sent.
+static void pm_render_end_async(void)
+{
+    atomic_fetch_add(&s_pm_idle_unholds, 1);
+    if (atomic_load(&s_lcd_inflight) == 0) {
+        pm_drop_idle_holds();   // went idle before the ISR could see the handed-over hold
+    }
+}
+
+static void pm_tick_record(int64_t active_us, int64_t period_us)
+{
+    static uint32_t ticks = 0;
+    static int64_t active_sum_us = 0;
+    static int64_t active_max_us = 0;
+    static int64_t period_sum_us = 0;
+
+    if (period_us <= 0) {
+        return;
+    }
+    ticks++;
+    active_sum_us += active_us;
+    period_sum_us += period_us;
+    if (active_us > active_max_us) {
+        active_max_us = active_us;
+    }
+    if (ticks < PM_REPORT_TICKS) {
+        return;
+    }
+
+    // Linear two-state model: active current while awake, sleep current otherwise.
+    int32_t duty_ppm = (int32_t)((active_sum_us * 1000000LL) / period_sum_us);
+    int32_t est_ua = PM_EST_SLEEP_MA * 1000 +
+                     (int32_t)(((int64_t)(PM_EST_ACTIVE_MA - PM_EST_SLEEP_MA) * duty_ppm) / 1000);
+    ESP_LOGI(TAG, "pm: ticks=%u active_avg_us=%lld active_max_us=%lld duty_ppm=%ld est_ua=%ld",
+             (unsigned)ticks, (long long)(active_sum_us / ticks), (long long)active_max_us,
+             (long)duty_ppm, (long)est_ua);
+
+    ticks = 0;
+    active_sum_us = 0;
+    active_max_us = 0;
+    period_sum_us = 0;
+}
+
+// Microseconds until the next second edge of whatever clock is on screen.
+static int64_t clock_us_to_next_second(time_source_t source)
+{
+    int64_t ref_us = (source != TIME_SOURCE_UPTIME) ? time_wall_us() : (esp_timer_get_time() - s_boot_us);
+    return 1000000LL - (ref_us % 1000000LL);
+}
+
+// Wake just past the next second edge; tickless idle sleeps meanwhile.
+static void clock_sleep_until_next_second(time_source_t source)
+{
+    const int64_t guard_us = 2000;
+    const int64_t tick_us = (int64_t)portTICK_PERIOD_MS * 1000LL;
+    int64_t wait_us = clock_us_to_next_second(source) + guard_us;
+    TickType_t ticks = (TickType_t)((wait_us + tick_us - 1) / tick_us);
+    vTaskDelay(ticks > 0 ? ticks : 1);
+}
+
+static void render_stats_record(int64_t queue_latency_us, uint32_t coalesced)
+{
+    static uint32_t frames = 0;
+    static uint32_t coalesced_sum = 0;
+    static int64_t latency_sum_us = 0;
+    static int64_t latency_max_us = 0;
+
+    frames++;
+    coalesced_sum += coalesced;
+    latency_sum_us += queue_latency_us;
+    if (queue_latency_us > latency_max_us) {
+        latency_max_us = queue_latency_us;
+    }
+    if (frames < PM_REPORT_TICKS) {
+        return;
+    }
+
+    ESP_LOGI(TAG, "render: frames=%u queue_lat_avg_us=%lld queue_lat_max_us=%lld coalesced=%u dropped=%u",
+             (unsigned)frames, (long long)(latency_sum_us / frames), (long long)latency_max_us,
+             (unsigned)coalesced_sum, (unsigned)s_scene_dropped);
+
+    frames = 0;
+    coalesced_sum = 0;
+    latency_sum_us = 0;
+    latency_max_us = 0;
+}
+
+// Ring use of the deferred log itself, per core; drops also show up as #DLDROP lines, this adds
+// how close the rings came to dropping.
+static void dlog_stats_report(void)
+{
+    for (int core = 0; core < portNUM_PROCESSORS; core++) {
+        dlog_core_stats_t st;
+        dlog_get_stats(core, &st);
+        DLOG("dlog: core%d written=%u dropped=%u high_water=%u words",
+             core, st.written, st.dropped, st.high_water_words);
+    }
+}
+
+// Per-core busy time from the FreeRTOS run-time counters: whatever the idle task did not get.
+static void sched_stats_report(void)
+{
+#if CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS
+    static uint32_t last_total = 0;
+    static uint32_t last_idle[portNUM_PROCESSORS] = {0};
+    static uint32_t last_render = 0;
+
+    // Only the clock task reports, so one static table is enough and the heap stays out of it.
+    static TaskStatus_t tasks[SCHED_MAX_TASKS];
+    uint32_t total = 0;
+    UBaseType_t count = uxTaskGetSystemState(tasks, SCHED_MAX_TASKS, &total);
+    if (count == 0) {
+        // More tasks than SCHED_MAX_TASKS: uxTaskGetSystemState fills nothing.
+        return;
+    }
+
+    uint32_t idle[portNUM_PROCESSORS] = {0};
+    uint32_t render = 0;
+    for (UBaseType_t i = 0; i < count; i++) {
+        for (int core = 0; core < portNUM_PROCESSORS; core++) {
+            if (tasks[i].xHandle == xTaskGetIdleTaskHandleForCPU(core)) {
+                idle[core] = tasks[i].ulRunTimeCounter;
+            }
+        }
+        if (tasks[i].xHandle == s_render_task) {
+            render = tasks[i].ulRunTimeCounter;
+        }
+    }
+
+    uint32_t elapsed = total - last_total;
+    if (last_total != 0 && elapsed > 0) {
+        uint32_t busy_pm[portNUM_PROCESSORS] = {0};
+        for (int core = 0; core < portNUM_PROCESSORS; core++) {
+            uint32_t idle_delta = idle[core] - last_idle[core];
+            busy_pm[core] = (idle_delta >= elapsed) ? 0 : (uint32_t)(1000ULL - (1000ULL * idle_delta) / elapsed);
+        }
+        ESP_LOGI(TAG, "sched: cpu0=%u.%u%% cpu1=%u.%u%% render=%u.%u%%",
+                 (unsigned)(busy_pm[0] / 10), (unsigned)(busy_pm[0] % 10),
+                 (unsigned)(busy_pm[portNUM_PROCESSORS - 1] / 10), (unsigned)(busy_pm[portNUM_PROCESSORS - 1] % 10),
+                 (unsigned)((1000ULL * (render - last_render)) / elapsed / 10),
+                 (unsigned)((1000ULL * (render - last_render)) / elapsed % 10));
+    }
+
+    last_total = total;
+    memcpy(last_idle, idle, sizeof(last_idle));
+    last_render = render;
+#endif
+}
+
+static void touch_on_event(void)
+{
+    if (s_render_task) {
+        xTaskNotifyGive(s_render_task);
+    }
+}
+
+// INT edge to the frame showing it having left the SPI DMA, reported every TOUCH_LAT_REPORT_EVENTS.
+static void touch_latency_record(int64_t irq_us, int64_t read_us, int64_t flushed_us)
+{
+    static uint32_t events = 0;
+    static int64_t total_sum_us = 0;
+    static int64_t total_max_us = 0;
+    static int64_t render_sum_us = 0;
+
+    if (irq_us == 0) {
+        return;  // forced release, no INT behind it
+    }
+    int64_t total_us = flushed_us - irq_us;
+    events++;
+    total_sum_us += total_us;
+    render_sum_us += flushed_us - read_us;
+    if (total_us > total_max_us) {
+        total_max_us = total_us;
+    }
+    if (events < TOUCH_LAT_REPORT_EVENTS) {
+        return;
+    }
+
+    ESP_LOGI(TAG, "touch: events=%u irq_to_flush_avg_us=%lld irq_to_flush_max_us=%lld read_to_flush_avg_us=%lld",
+             (unsigned)events, (long long)(total_sum_us / events), (long long)total_max_us,
+             (long long)(render_sum_us / events));
+    events = 0;
+    total_sum_us = 0;
+    total_max_us = 0;
+    render_sum_us = 0;
+}
+
+#if !CLOCK_FACE_LVGL
+// Sink for faces that render pixel windows (analog face, digit transitions) straight into arena blocks.
+static uint16_t *block_sink_acquire(void *ctx, size_t *capacity)
+{
+    (void)ctx;
+    *capacity = DMA_DRAW_BLOCK_BYTES / sizeof(uint16_t);
+    return lcd_acquire_block();
+}
+
+// The face sizes every window to fit one block, so it goes out as a single chunk.
+static void block_sink_submit(void *ctx, int x, int y, int w, int h, uint16_t *buf)
+{
+    (void)ctx;
+    lcd_queue_chunks(x, y, w, h, h, buf, buf);
+}
+#endif
+
+#if !CLOCK_FACE_ANALOG && !CLOCK_FACE_LVGL
+// Transition frames are due every few ms, finer than the tick; a one-shot timer wakes the render task.
+static esp_timer_handle_t s_anim_timer = NULL;
+
+static void anim_timer_cb(void *arg)
+{
+    (void)arg;
+    xTaskNotifyGive(s_render_task);
+}
+
+static bool anim_sink_busy(void *ctx)
+{
+    (void)ctx;
+    return atomic_load(&s_lcd_inflight) > 0;
+}
+
+static int64_t anim_sink_now_us(void *ctx)
+{
+    (void)ctx;
+    return esp_timer_get_time();
+}
+#endif
+
+#if CLOCK_FACE_LVGL
+static bool s_lvgl_ready = false;
+static uint32_t s_lvgl_next_ms = UINT32_MAX;   // from the last lvgl_port_run()
+
+// LVGL renders into its own DMA-capable buffers, so they go out as they are, DRAW_CHUNK_ROWS rows
+// per transfer to stay within max_transfer_sz; LVGL gets the buffer back from the transfer-done ISR.
+static void lvgl_sink_flush(int x, int y, int w, int h, const uint16_t *pixels)
+{
+    lcd_queue_chunks_notify(x, y, w, h, DRAW_CHUNK_ROWS, pixels, true, NULL, lvgl_port_flush_done);
+}
+#endif
+
+static void face_init(void)
+{
+#if CLOCK_FACE_ANALOG
+    const analog_face_sink_t sink = {.acquire = block_sink_acquire, .submit = block_sink_submit};
+    analog_face_init(&sink);
+#elif CLOCK_FACE_LVGL
+    s_lvgl_ready = lvgl_port_init(lvgl_sink_flush);
+    if (!s_lvgl_ready) {
+        ESP_LOGE(TAG, "lvgl init failed; no face");
+        return;
+    }
+    reminder_screen_create();
+    // Backlight is still off; measure the reference screen before the render task owns LVGL.
+    time_t now = time(NULL);
+    struct tm ti;
+    localtime_r(&now, &ti);
+    reminder_screen_update(&ti, false);
+    lvgl_port_bench(LVGL_BENCH_FRAMES);
+#else
+    clock_face_init(lcd_fill_rect);
+    if (CLOCK_ANIM_STYLE == CLOCK_ANIM_NONE) {
+        return;   // no anim timer: face_animate() stays a no-op
+    }
+    const esp_timer_create_args_t timer_args = {
+        .callback = anim_timer_cb,
+        .name = "face_anim",
+    };
+    if (esp_timer_create(&timer_args, &s_anim_timer) != ESP_OK) {
+        ESP_LOGW(TAG, "no anim timer; digits switch at the edge");
+        return;
+    }
+    const clock_anim_sink_t sink = {
+        .acquire = block_sink_acquire,
+        .submit = block_sink_submit,
+        .busy = anim_sink_busy,
+        .now_us = anim_sink_now_us,
+    };
+    const clock_anim_config_t cfg = {
+        .style = CLOCK_ANIM_STYLE,
+        .duration_ms = CLOCK_ANIM_DURATION_MS,
+        .fps = CLOCK_ANIM_FPS,
+        .frame_cpu_us = CLOCK_ANIM_FRAME_CPU_US,
+        .frame_bus_bytes = CLOCK_ANIM_FRAME_BUS_BYTES,
+    };
+    clock_face_set_anim(&sink, &cfg);
+#endif
+}
+
+static void face_invalidate_rect(int x, int y, int w, int h)
+{
+#if CLOCK_FACE_ANALOG
+    analog_face_invalidate_rect(x, y, w, h);
+#elif CLOCK_FACE_LVGL
+    if (s_lvgl_ready) {
+        lvgl_port_invalidate_rect(x, y, w, h);
+    }
+#else
+    clock_face_invalidate_rect(x, y, w, h);
+#endif
+}
+
+static void face_draw(const struct tm *ti, bool synced)
+{
+#if CLOCK_FACE_ANALOG
+    analog_face_draw(ti, synced);
+#elif CLOCK_FACE_LVGL
+    if (s_lvgl_ready) {
+        reminder_screen_update(ti, synced);
+        s_lvgl_next_ms = lvgl_port_run();
+    }
+#else
+    clock_face_draw(ti, synced);
+#endif
+}
+
+// Render task wake-up between scenes: LVGL may still owe a refresh the last draw came too early
+// for (it refreshes at most every LV_DISP_DEF_REFR_PERIOD ms) or be animating.
+static TickType_t face_wait_ticks(void)
+{
+#if CLOCK_FACE_LVGL
+    if (s_lvgl_ready && s_lvgl_next_ms != UINT32_MAX) {
+        TickType_t ticks = pdMS_TO_TICKS(s_lvgl_next_ms);
+        return ticks > 0 ? ticks : 1;
+    }
+#endif
+    return portMAX_DELAY;
+}
+
+// Digital face only: runs the transition towards scene's next edge after each draw and on every
+// wake-up between scenes, and asks for the next frame slot through the anim timer.
+static void face_animate(const clock_scene_t *scene)
+{
+#if !CLOCK_FACE_ANALOG && !CLOCK_FACE_LVGL
+    if (!s_anim_timer || scene->next_edge_us == 0) {
+        return;
+    }
+    // Frames overlap the bus: the next slot finds it busy (and drops) if this one is still going out.
+    pm_render_begin();
+    int64_t wake_us = clock_face_animate(&scene->ti, esp_timer_get_time(), scene->next_edge_us);
+    pm_render_end_async();
+    esp_timer_stop(s_anim_timer);
+    if (wake_us != 0) {
+        int64_t wait_us = wake_us - esp_timer_get_time();
+        esp_timer_start_once(s_anim_timer, wait_us > 0 ? (uint64_t)wait_us : 1);
+    }
+#else
+    (void)scene;
+#endif
+}
+
+static void face_idle(const clock_scene_t *scene)
+{
+#if CLOCK_FACE_LVGL
+    if (s_lvgl_ready && s_lvgl_next_ms != UINT32_MAX) {
+        pm_render_begin();
+        s_lvgl_next_ms = lvgl_port_run();
+        pm_render_end();
+    }
+#endif
+    face_animate(scene);
+}
+
+// Read from the clock task while the render task draws; a torn count only skews one log line.
+static void face_log_stats(void)
+{
+#if CLOCK_FACE_ANALOG
+    analog_face_stats_t st;
+    analog_face_get_stats(&st);
+    if (st.draws == 0) {
+        return;
+    }
+    ESP_LOGI(TAG, "analog face: draws=%u windows=%u avg_bytes=%u padding=%u%%",
+             (unsigned)st.draws, (unsigned)st.windows, (unsigned)(st.pixels * 2 / st.draws),
+             (unsigned)(st.pixels ? (st.pixels - st.span_pixels) * 100 / st.pixels : 0));
+#elif CLOCK_FACE_LVGL
+    if (s_lvgl_ready) {
+        lvgl_port_log_stats();
+    }
+#else
+    clock_anim_stats_t st;
+    clock_face_get_anim_stats(&st);
+    if (st.transitions == 0) {
+        return;
+    }
+    // Frame rate over the animated part of each second, final frames included.
+    uint32_t fps10 = (uint32_t)((uint64_t)st.frames * 10000 / ((uint64_t)st.transitions * CLOCK_ANIM_DURATION_MS));
+    ESP_LOGI(TAG, "digit anim: transitions=%u simplified=%u fps=%u.%u dropped=%u bytes/transition=%u "
+             "cpu avg=%uus max=%uus",
+             (unsigned)st.transitions, (unsigned)st.simplified, (unsigned)(fps10 / 10), (unsigned)(fps10 % 10),
+             (unsigned)st.dropped, (unsigned)(st.bytes / st.transitions),
+             (unsigned)(st.frames ? st.cpu_us / st.frames : 0), (unsigned)st.cpu_us_max);
+#endif
+}
+
+// Moves the touch dot; whatever the old dot covered is cleared and the face repaints it.
+static void touch_overlay_draw(const touch_sample_t *touch, const clock_scene_t *scene)
+{
+    static bool shown = false;
+    static int dot_x = 0;
+    static int dot_y = 0;
+    const uint16_t bg = rgb565_be(0x00, 0x00, 0x00);
+    const uint16_t dot_color = rgb565_be(0x5A, 0xC8, 0xFA);
+
+    if (shown) {
+        lcd_fill_rect(dot_x, dot_y, TOUCH_DOT_SIZE, TOUCH_DOT_SIZE, bg);
+        face_invalidate_rect(dot_x, dot_y, TOUCH_DOT_SIZE, TOUCH_DOT_SIZE);
+        face_draw(&scene->ti, scene->source >= TIME_SOURCE_RETAINED);
+        shown = false;
+    }
+    if (touch->event == CST816_EV_PRESS || touch->event == CST816_EV_MOVE) {
+        dot_x = touch->x - TOUCH_DOT_SIZE / 2;
+        dot_y = touch->y - TOUCH_DOT_SIZE / 2;
+        lcd_fill_rect(dot_x, dot_y, TOUCH_DOT_SIZE, TOUCH_DOT_SIZE, dot_color);
+        shown = true;
+    }
+}
+
+static void render_task(void *arg)
+{
+    (void)arg;
+
+    bool first_frame = true;
+    bool correct_time_logged = false;
+    int64_t last_frame_us = 0;
+    clock_scene_t scene = {0};
+    uint32_t touch_seq = 0;
+
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, face_wait_ticks());
+
+        // Only the newest scene matters; older ones are superseded, not replayed.
+        uint32_t popped = 0;
+        clock_scene_t next;
+        while (spsc_queue_pop(&s_scene_queue, &next)) {
+            scene = next;
+            popped++;
+        }
+
+        // Same for touch: intermediate moves are skipped, only the latest position is drawn.
+        touch_sample_t touch;
+        bool touched = touch_get_latest(&touch) && touch.seq != touch_seq && !first_frame;
+        if (touched) {
+            touch_seq = touch.seq;
+            pm_render_begin();
+            touch_overlay_draw(&touch, &scene);
+            pm_render_end();
+            touch_latency_record(touch.irq_us, touch.read_us, esp_timer_get_time());
+        }
+        if (popped == 0) {
+            face_idle(&scene);
+            continue;
+        }
+
+        bool synced = scene.source >= TIME_SOURCE_RETAINED;
+        int64_t start_us = esp_timer_get_time();
+        pm_render_begin();
+        face_draw(&scene.ti, synced);
+        pm_render_end();
+        int64_t end_us = esp_timer_get_time();
+        face_animate(&scene);
+
+        if (first_frame) {
+            // Time-to-correct-display for warm reset / deep-sleep wake; cold boot logs it at NTP sync.
+            ESP_LOGI(TAG, "first frame at %lld ms: %02d:%02d:%02d (%s, reset=%d)",
+                     (long long)((end_us - s_boot_us) / 1000),
+                     scene.ti.tm_hour, scene.ti.tm_min, scene.ti.tm_sec,
+                     time_source_name((time_source_t)scene.source), esp_reset_reason());
+            first_frame = false;
+            correct_time_logged = synced;
+        } else if (synced && !correct_time_logged) {
+            ESP_LOGI(TAG, "time-to-correct-display: %lld ms",
+                     (long long)((end_us - s_boot_us) / 1000));
+            correct_time_logged = true;
+        }
+
+        // Active time is every render hold since the last tick: this draw, transition frames, touch
+        // overlay and LVGL refreshes between scenes. The first tick only clears the boot benches.
+        int64_t active_us = pm_take_active_us();
+        render_stats_record(start_us - scene.queued_us, popped - 1);
+        if (last_frame_us != 0) {
+            pm_tick_record(active_us, start_us - last_frame_us);
+        }
+        last_frame_us = start_us;
+    }
+}
+
+static void clock_task(void *arg)
+{
+    (void)arg;
+
+    int64_t last_time_save_us = esp_timer_get_time();
+    uint32_t ticks = 0;
+
+    while (1) {
+        int64_t now_us = esp_timer_get_time();
+        clock_scene_t scene = {.queued_us = now_us};
+        time_source_t source = clock_read(&scene.ti);
+        scene.source = (uint8_t)source;
+        scene.next_edge_us = esp_timer_get_time() + clock_us_to_next_second(source);
+
+        if (!spsc_queue_push(&s_scene_queue, &scene)) {
+            s_scene_dropped++;
+        }
+        xTaskNotifyGive(s_render_task);
+
+        // Per-second line goes through the deferred ring; tools/dlog_decode.py formats it.
+        DLOG("displayed: %02d:%02d:%02d (%s)",
+             scene.ti.tm_hour, scene.ti.tm_min, scene.ti.tm_sec,
+             time_source_name(source));
+
+        // Flash snapshot for power loss: on every sync, otherwise at a low rate.
+        if (source != TIME_SOURCE_UPTIME &&
+            (s_time_nvs_dirty || now_us - last_time_save_us >= TIME_NVS_SAVE_INTERVAL_S * 1000000LL)) {
+            s_time_nvs_dirty = false;
+            last_time_save_us = now_us;
+            time_nvs_save();
+        }
+
+        // Hardware fade; the first call brings the backlight up once a frame is queued. Dimming
+        // follows the time of day only when the clock is known to be right, not an NVS estimate.
+        backlight_schedule_tick(&scene.ti, source >= TIME_SOURCE_RETAINED);
+
+        if (++ticks % PM_REPORT_TICKS == 0) {
+            sched_stats_report();
+            dlog_stats_report();
+            mem_telemetry_sample_now();
+            backlight_log_stats();
+            dma_arena_log_report();
+            touch_log_stats();
+            i2c_bus_log_stats();
+            mic_capture_log_stats();
+            face_log_stats();
+        }
+        clock_sleep_until_next_second(source);
+    }
+}
+
+static const asset_t *assets_largest(asset_encoding_t encoding)
+{
+    const asset_t *best = NULL;
+    for (int i = 0; i < assets_count(); i++) {
+        const asset_t *a = assets_at(i);
+        if (a->encoding == encoding &&
+            (!best || (uint32_t)a->width * a->height > (uint32_t)best->width * best->height)) {
+            best = a;
+        }
+    }
+    return best;
+}
+
+// Time to full screen for a Q565 asset: band decode pipelined with the transfers.
+static void assets_bench_q565(const asset_t *asset)
+{
+    pm_render_begin();
+    int64_t t0 = esp_timer_get_time();
+    bool ok = lcd_draw_asset(asset, 0, 0);
+    int64_t t1 = esp_timer_get_time();
+    lcd_wait_idle();
+    int64_t t2 = esp_timer_get_time();
+    pm_render_end();
+
+    uint32_t raw_bytes = (uint32_t)asset->width * asset->height * sizeof(uint16_t);
+    ESP_LOGI(TAG, "assets bench q565 \"%s\" %dx%d: %u B (%u%% of raw), decode+queue %lld us, "
+             "full screen %lld us%s",
+             asset->name, asset->width, asset->height, (unsigned)asset->bytes,
+             (unsigned)((asset->bytes * 100U) / raw_bytes), (long long)(t1 - t0), (long long)(t2 - t0),
+             ok ? "" : " (decode error)");
+}
+
+// Boot-time throughput checks while the backlight is still off. The largest raw asset is drawn as a
+// mapped-flash blit, as solid fills of the same area and as the per-run fills it would take without
+// assets; the largest Q565 asset is timed to full screen.
+static void assets_boot_bench(void)
+{
+    const asset_t *q565 = assets_largest(ASSET_ENCODING_Q565);
+    if (q565) {
+        assets_bench_q565(q565);
+    }
+
+    const asset_t *asset = assets_largest(ASSET_ENCODING_RAW);
+    if (!asset) {
+        return;
+    }
+
+    const int w = asset->width;
+    const int h = asset->height;
+    const uint64_t bytes = (uint64_t)w * h * sizeof(uint16_t) * ASSETS_BENCH_REPS;
+
+    pm_render_begin();
+    int64_t t0 = esp_timer_get_time();
+    for (int i = 0; i < ASSETS_BENCH_REPS; i++) {
+        lcd_blit(0, 0, w, h, asset->pixels, w);
+    }
+    lcd_wait_idle();
+    int64_t t1 = esp_timer_get_time();
+    for (int i = 0; i < ASSETS_BENCH_REPS; i++) {
+        lcd_fill_rect(0, 0, w, h, asset->pixels[0]);
+    }
+    lcd_wait_idle();
+    int64_t t2 = esp_timer_get_time();
+
+    uint32_t runs = 0;
+    for (int r = 0; r < h; r++) {
+        const uint16_t *row = asset->pixels + (size_t)r * w;
+        for (int c = 0; c < w; c++) {
+            runs += (c == 0 || row[c] != row[c - 1]);
+        }
+    }
+    int64_t run_us = 0;
+    if (runs <= ASSETS_BENCH_MAX_RUNS) {
+        int64_t t3 = esp_timer_get_time();
+        for (int r = 0; r < h; r++) {
+            const uint16_t *row = asset->pixels + (size_t)r * w;
+            int start = 0;
+            for (int c = 1; c <= w; c++) {
+                if (c == w || row[c] != row[start]) {
+                    lcd_fill_rect(start, r, c - start, 1, row[start]);
+                    start = c;
+                }
+            }
+        }
+        lcd_wait_idle();
+        run_us = (esp_timer_get_time() - t3) * ASSETS_BENCH_REPS;
+    }
+    pm_render_end();
+
+    // Bytes per microsecond is MB/s; printed with two decimals.
+    uint32_t blit_cmbs = (uint32_t)((bytes * 100) / (uint64_t)(t1 - t0 > 0 ? t1 - t0 : 1));
+    uint32_t fill_cmbs = (uint32_t)((bytes * 100) / (uint64_t)(t2 - t1 > 0 ? t2 - t1 : 1));
+    uint32_t run_cmbs = run_us > 0 ? (uint32_t)((bytes * 100) / (uint64_t)run_us) : 0;
+    ESP_LOGI(TAG, "assets bench \"%s\" %dx%d: blit %u.%02u MB/s, solid fill %u.%02u MB/s, "
+             "run fills %u.%02u MB/s (%u runs%s)",
+             asset->name, w, h,
+             (unsigned)(blit_cmbs / 100), (unsigned)(blit_cmbs % 100),
+             (unsigned)(fill_cmbs / 100), (unsigned)(fill_cmbs % 100),
+             (unsigned)(run_cmbs / 100), (unsigned)(run_cmbs % 100),
+             (unsigned)runs, runs > ASSETS_BENCH_MAX_RUNS ? ", skipped" : "");
+}
+
+static void mic_on_event(audio_event_t ev)
+{
+    atomic_store(&s_alert_event, ev);
+    if (s_net_task) {
+        xTaskNotifyGive(s_net_task);
+    }
+}
+
+static bool reminder_due(const struct tm *ti, reminder_t *out)
+{
+    int count = reminder_store_count();
+    for (int i = 0; i < count; i++) {
+        if (reminder_store_get(i, out) && out->hour == ti->tm_hour && out->minute == ti->tm_min &&
+            (out->days & (1U << ti->tm_wday)) != 0) {
+            return true;
+        }
+    }
     return false;
 }
 
+// Runs on the network task. The mic only captures while an alert is up. Returns true while alerting.
+static bool reminder_alert_poll(void)
+{
+    static bool active = false;
+    static reminder_t current;
+    static int64_t until_us = 0;
+    static int64_t next_chirp_us = 0;
+    static int64_t snooze_until_us = 0;
+    static int last_fired_minute = -1;
+
+    int64_t now_us = esp_timer_get_time();
+    if (!active) {
+        atomic_store(&s_alert_event, AUDIO_EV_NONE);
+        bool start = false;
+        if (snooze_until_us != 0 && now_us >= snooze_until_us) {
+            snooze_until_us = 0;
+            start = true;
+        } else if (s_time_source >= TIME_SOURCE_RETAINED) {
+            // Same trust as the face's synced colons: an NVS estimate may be hours off.
+            struct tm ti;
+            time_t now = (time_t)(time_wall_us() / 1000000LL);
+            localtime_r(&now, &ti);
+            int minute = ti.tm_yday * 1440 + ti.tm_hour * 60 + ti.tm_min;
+            reminder_t due;
+            if (minute != last_fired_minute && reminder_due(&ti, &due)) {
+                last_fired_minute = minute;
+                current = due;
+                snooze_until_us = 0;   // a new reminder replaces a snoozed one
+                start = true;
+            }
+        }
+        if (!start) {
+            return false;
+        }
+        ESP_LOGI(TAG, "alert: reminder %u \"%s\"", (unsigned)current.id, current.text);
+        active = true;
+        until_us = now_us + ALERT_DURATION_S * 1000000LL;
+        next_chirp_us = now_us;
+        audio_amp_set(true);
+        mic_capture_start();
+    }
+
+    audio_event_t ev = (audio_event_t)atomic_exchange(&s_alert_event, AUDIO_EV_NONE);
+    const char *outcome = NULL;
+    if (ev == AUDIO_EV_DOUBLE_CLAP) {
+        outcome = "dismissed";
+    } else if (ev == AUDIO_EV_CLAP || ev == AUDIO_EV_VOICE) {
+        snooze_until_us = now_us + ALERT_SNOOZE_S * 1000000LL;
+        outcome = "snoozed";
+    } else if (now_us >= until_us) {
+        outcome = "timed out";
+    }
+    if (outcome) {
+        mic_capture_stop();
+        audio_amp_set(false);
+        active = false;
+        ESP_LOGI(TAG, "alert: reminder %u %s (%s)", (unsigned)current.id, outcome,
+                 ev != AUDIO_EV_NONE ? audio_event_name(ev) : "no response");
+        return false;
+    }
+
+    if (now_us >= next_chirp_us) {
+        beep_play_tone(ALERT_CHIRP_HZ, ALERT_CHIRP_MS);
+        next_chirp_us = now_us + ALERT_CHIRP_PERIOD_MS * 1000LL;
+    }
+    return true;
+}
+
+static void tasks_start(void)
+{
+    if (!spsc_queue_init(&s_scene_queue, s_scene_slots, sizeof(s_scene_slots[0]), SCENE_QUEUE_LEN) ||
+        xTaskCreatePinnedToCore(render_task, "render", RENDER_TASK_STACK, NULL,
+                                RENDER_TASK_PRIO, &s_render_task, RENDER_TASK_CORE) != pdPASS ||
+        xTaskCreatePinnedToCore(clock_task, "clock", CLOCK_TASK_STACK, NULL,
+                                CLOCK_TASK_PRIO, NULL, CLOCK_TASK_CORE) != pdPASS) {
+        ESP_LOGE(TAG, "failed to start render/clock tasks");
+        abort();
+    }
+    ESP_LOGI(TAG, "render task on core %d (prio %d), clock task on core %d (prio %d)",
+             RENDER_TASK_CORE, RENDER_TASK_PRIO, CLOCK_TASK_CORE, CLOCK_TASK_PRIO);
+}
+
 void app_main(void)
 {
     s_boot_us = esp_timer_get_time();
+    s_net_task = xTaskGetCurrentTaskHandle();
 
+    dlog_init();
+    mem_telemetry_init();
     nvs_init();
+    reminder_store_init();
+    pm_init();
+    time_restore_at_boot();
     exio_init();
     audio_boot_self_test();
+    mic_capture_init(mic_on_event);
     lcd_hw_reset_via_exio();
-    backlight_init();
-    backlight_set_percent(60);
+    touch_init(touch_on_event);  // right after reset, before the controller's auto-sleep
+    backlight_init(LCD_PIN_BACKLIGHT);
     lcd_init();
-    struct tm startup_ti = {0};
-    draw_time(&startup_ti);
+    if (assets_init()) {
+        assets_boot_bench();
+    }
+    face_init();
+    tasks_start();
+    mem_telemetry_sample_now();
 
-    s_time_synced = false;
+    // app_main stays on as the network task; it never touches the panel.
+    bool ntp_attempted = false;
     if (wifi_connect_blocking()) {
-        s_time_synced = sync_time_from_ntp();
+        sync_time_from_ntp();
+        ntp_attempted = true;
     }
 
-    int64_t last_clock_update_us = 0;
+    int64_t next_reminder_sync_us = 0;
     while (1) {
-        int64_t now_us = esp_timer_get_time();
-
-        if (now_us - last_clock_update_us >= 1000000) {
-            last_clock_update_us = now_us;
-            struct tm ti = {0};
-            if (s_time_synced) {
-                time_t now = 0;
-                time(&now);
-                localtime_r(&now, &ti);
-                if (ti.tm_year < (2024 - 1900)) {
-                    s_time_synced = false;
-                }
-            }
-
-            if (!s_time_synced) {
-                uint64_t uptime_s = (esp_timer_get_time() - s_boot_us) / 1000000ULL;
-                ti.tm_hour = (int)((uptime_s / 3600ULL) % 24ULL);
-                ti.tm_min = (int)((uptime_s / 60ULL) % 60ULL);
-                ti.tm_sec = (int)(uptime_s % 60ULL);
-            }
-
-            draw_time(&ti);
-            ESP_LOGI(TAG, "displayed: %02d:%02d:%02d (%s)",
-                     ti.tm_hour, ti.tm_min, ti.tm_sec,
-                     s_time_synced ? "ntp" : "uptime");
+        // Background reconnect succeeded after the boot wait gave up.
+        if (!ntp_attempted && wifi_is_connected()) {
+            sync_time_from_ntp();
+            ntp_attempted = true;
         }
-
-        vTaskDelay(pdMS_TO_TICKS(20));
+        // A sync can block for seconds; it waits until the alert is over.
+        bool alerting = reminder_alert_poll();
+        if (!alerting && reminder_sync_enabled() && wifi_is_connected() &&
+            esp_timer_get_time() >= next_reminder_sync_us) {
+            uint32_t wait_s = (reminder_sync_run(NULL) == REMINDER_SYNC_FAILED)
+                              ? REMINDER_SYNC_RETRY_S : REMINDER_SYNC_PERIOD_S;
+            next_reminder_sync_us = esp_timer_get_time() + (int64_t)wait_s * 1000000LL;
+        }
+        // Mic events cut the wait short.
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(alerting ? ALERT_POLL_MS : 1000));
     }
 }
@@ -0,0 +1,134 @@
+#include "mem_telemetry.h"
+
+#include <stdatomic.h>
+#include <stdbool.h>
+
+#include "dlog.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+
+#define MEM_MAX_TASKS     24
+
+typedef struct {
+    uint32_t free_bytes;
+    uint32_t min_free_bytes;
+    uint32_t largest_block;
+    uint32_t allocated_blocks;
+} mem_heap_sample_t;
+
+static const char *TAG = "mem";
+
+static SemaphoreHandle_t s_sample_lock = NULL;   // boot and periodic samples share the static buffers
+static atomic_uint s_failed_allocs = 0;
+static uint32_t s_last_failed_size = 0;
+static uint32_t s_last_failed_caps = 0;
+static uint32_t s_alarms = 0;
+static bool s_alarm_stack = false;
+static bool s_alarm_dma = false;
+static bool s_alarm_internal = false;
+
+// Runs inside the failing allocator call; only bumps counters.
+static void mem_failed_alloc_cb(size_t size, uint32_t caps, const char *function_name)
+{
+    (void)function_name;
+    atomic_fetch_add_explicit(&s_failed_allocs, 1, memory_order_relaxed);
+    s_last_failed_size = (uint32_t)size;
+    s_last_failed_caps = caps;
+}
+
+static void mem_heap_sample(uint32_t caps, mem_heap_sample_t *out)
+{
+    multi_heap_info_t info;
+    heap_caps_get_info(&info, caps);
+    out->free_bytes = (uint32_t)info.total_free_bytes;
+    out->min_free_bytes = (uint32_t)info.minimum_free_bytes;
+    out->largest_block = (uint32_t)info.largest_free_block;
+    out->allocated_blocks = (uint32_t)info.allocated_blocks;
+}
+
+// Logs on the way into an alarm state and once more on the way out; rare enough for the UART.
+static void mem_alarm_edge(bool *state, bool now, const char *what, uint32_t value, uint32_t limit)
+{
+    if (now && !*state) {
+        s_alarms++;
+        ESP_LOGW(TAG, "ALARM %s=%u below %u", what, (unsigned)value, (unsigned)limit);
+    } else if (!now && *state) {
+        ESP_LOGI(TAG, "recovered %s=%u", what, (unsigned)value);
+    }
+    *state = now;
+}
+
+static void mem_sample(void)
+{
+    static TaskStatus_t tasks[MEM_MAX_TASKS];
+
+    mem_heap_sample_t internal;
+    mem_heap_sample_t dma;
+    mem_heap_sample_t spiram;   // all zero without PSRAM
+    mem_heap_sample(MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT, &internal);
+    mem_heap_sample(MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL, &dma);
+    mem_heap_sample(MALLOC_CAP_SPIRAM, &spiram);
+    uint32_t failed_allocs = atomic_load(&s_failed_allocs);
+
+    // DLOG records carry at most DLOG_MAX_ARGS words, hence two "mem:" records.
+    DLOG("mem: int=%u/%u/%u #%u dma=%u/%u/%u #%u",
+         internal.free_bytes, internal.min_free_bytes, internal.largest_block, internal.allocated_blocks,
+         dma.free_bytes, dma.min_free_bytes, dma.largest_block, dma.allocated_blocks);
+    DLOG("mem: psram=%u/%u/%u #%u fail=%u last=%u bytes caps=0x%x alarms=%u",
+         spiram.free_bytes, spiram.min_free_bytes, spiram.largest_block, spiram.allocated_blocks,
+         failed_allocs, s_last_failed_size, s_last_failed_caps, s_alarms);
+
+    // On ESP-IDF the high-water mark is in bytes: the least free stack each task has ever had.
+    // Task names live in RAM, which DLOG cannot carry; the alarm names the task that crossed.
+    UBaseType_t count = uxTaskGetSystemState(tasks, MEM_MAX_TASKS, NULL);
+    uint32_t min_stack_free = UINT32_MAX;
+    const char *min_stack_task = "";
+    for (UBaseType_t i = 0; i < count; i++) {
+        uint32_t hwm = (uint32_t)tasks[i].usStackHighWaterMark;
+        if (hwm < min_stack_free) {
+            min_stack_free = hwm;
+            min_stack_task = tasks[i].pcTaskName;
+        }
+    }
+    if (count == 0) {
+        // More tasks than MEM_MAX_TASKS: uxTaskGetSystemState returns nothing rather than a prefix.
+        DLOG("stk: more than %d tasks, raise MEM_MAX_TASKS", MEM_MAX_TASKS);
+    } else {
+        DLOG("stk: min=%u over %u tasks", min_stack_free, (unsigned)count);
+    }
+
+    mem_alarm_edge(&s_alarm_stack, count > 0 && min_stack_free < MEM_ALARM_STACK_FREE_BYTES,
+                   min_stack_task, min_stack_free, MEM_ALARM_STACK_FREE_BYTES);
+    mem_alarm_edge(&s_alarm_dma, dma.largest_block < MEM_ALARM_DMA_LARGEST_BYTES,
+                   "dma_largest", dma.largest_block, MEM_ALARM_DMA_LARGEST_BYTES);
+    mem_alarm_edge(&s_alarm_internal, internal.min_free_bytes < MEM_ALARM_INTERNAL_MIN_BYTES,
+                   "int_min_free", internal.min_free_bytes, MEM_ALARM_INTERNAL_MIN_BYTES);
+}
+
+static void mem_sample_locked(void)
+{
+    if (!s_sample_lock) {
+        return;
+    }
+    xSemaphoreTake(s_sample_lock, portMAX_DELAY);
+    mem_sample();
+    xSemaphoreGive(s_sample_lock);
+}
+
+void mem_telemetry_init(void)
+{
+    s_sample_lock = xSemaphoreCreateMutex();
+    if (!s_sample_lock) {
+        ESP_LOGW(TAG, "telemetry disabled: no mutex");
+        return;
+    }
+    heap_caps_register_failed_alloc_callback(mem_failed_alloc_cb);
+}
+
+void mem_telemetry_sample_now(void)
+{
+    mem_sample_locked();
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+// Low-rate memory telemetry: per-task stack high-water marks and per-capability
+// heap free/min/largest/allocated-block counts, sampled by the caller (the
+// clock task's periodic report) and shipped as compact "mem:" and "stk:" DLOG
+// records. Crossing an alarm threshold logs a warning, naming the task for
+// stack alarms, once until the value recovers.
+
+// Alarm when a task has less stack than this left at its deepest point.
+#ifndef MEM_ALARM_STACK_FREE_BYTES
+#define MEM_ALARM_STACK_FREE_BYTES    512
+#endif
+
+// Alarm when the internal DMA-capable heap's largest free block drops below this.
+#ifndef MEM_ALARM_DMA_LARGEST_BYTES
+#define MEM_ALARM_DMA_LARGEST_BYTES   (8 * 1024)
+#endif
+
+// Alarm when internal free heap has ever dipped below this.
+#ifndef MEM_ALARM_INTERNAL_MIN_BYTES
+#define MEM_ALARM_INTERNAL_MIN_BYTES  (16 * 1024)
+#endif
+
+void mem_telemetry_init(void);
+// Takes and logs a snapshot. Task context only; it can block on the sample lock.
+void mem_telemetry_sample_now(void);
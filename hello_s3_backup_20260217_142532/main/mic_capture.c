@@ -0,0 +1,208 @@
+#include "mic_capture.h"
+
+#include <stdatomic.h>
+
+#include "driver/i2s_std.h"
+#include "esp_attr.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#define MIC_READ_TIMEOUT_MS 100
+#define MIC_FRAME_US        (AUDIO_DETECT_FRAME * 1000000LL / AUDIO_DETECT_RATE_HZ)
+
+static const char *TAG = "mic";
+
+static i2s_chan_handle_t s_rx_chan = NULL;
+static TaskHandle_t s_task = NULL;
+static mic_event_cb_t s_on_event = NULL;
+static atomic_bool s_want_run = false;
+static atomic_bool s_playback = false;
+static atomic_uint s_overruns = 0;
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;   // s_stats
+static mic_stats_t s_stats;
+
+static audio_detect_t s_det;
+static int32_t s_raw[AUDIO_DETECT_FRAME];
+static int16_t s_pcm[AUDIO_DETECT_FRAME];
+
+static bool IRAM_ATTR mic_on_recv_q_ovf(i2s_chan_handle_t handle, i2s_event_data_t *event, void *user_ctx)
+{
+    (void)handle;
+    (void)event;
+    (void)user_ctx;
+    atomic_fetch_add(&s_overruns, 1);
+    return false;
+}
+
+static bool mic_read_frame(void)
+{
+    size_t have = 0;
+    while (have < sizeof(s_raw)) {
+        size_t got = 0;
+        esp_err_t err = i2s_channel_read(s_rx_chan, (uint8_t *)s_raw + have, sizeof(s_raw) - have, &got,
+                                         pdMS_TO_TICKS(MIC_READ_TIMEOUT_MS));
+        have += got;
+        if (err != ESP_OK) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void mic_process_frame(void)
+{
+    int64_t t0 = esp_timer_get_time();
+    for (int i = 0; i < AUDIO_DETECT_FRAME; i++) {
+        int32_t s = s_raw[i] >> MIC_SAMPLE_SHIFT;
+        s_pcm[i] = (int16_t)(s > 32767 ? 32767 : (s < -32768 ? -32768 : s));
+    }
+    audio_detect_set_playback(&s_det, atomic_load(&s_playback));
+    audio_event_t ev = audio_detect_frame(&s_det, s_pcm);
+    uint32_t us = (uint32_t)(esp_timer_get_time() - t0);
+
+    portENTER_CRITICAL(&s_lock);
+    s_stats.frames++;
+    s_stats.detect_us_sum += us;
+    if (us > s_stats.detect_us_max) {
+        s_stats.detect_us_max = us;
+    }
+    s_stats.events[ev]++;
+    portEXIT_CRITICAL(&s_lock);
+
+    if (ev != AUDIO_EV_NONE) {
+        ESP_LOGI(TAG, "%s (level %d, floor %d)", audio_event_name(ev), (int)s_det.level, (int)s_det.floor);
+        if (s_on_event) {
+            s_on_event(ev);
+        }
+    }
+}
+
+static void mic_task(void *arg)
+{
+    (void)arg;
+    while (1) {
+        if (!atomic_load(&s_want_run)) {
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            continue;
+        }
+
+        esp_err_t err = i2s_channel_enable(s_rx_chan);
+        if (err != ESP_OK) {
+            ESP_LOGW(TAG, "i2s_channel_enable failed: %s", esp_err_to_name(err));
+            atomic_store(&s_want_run, false);
+            continue;
+        }
+        audio_detect_init(&s_det);
+        int64_t start_us = esp_timer_get_time();
+
+        while (atomic_load(&s_want_run)) {
+            if (!mic_read_frame()) {
+                portENTER_CRITICAL(&s_lock);
+                s_stats.read_errors++;
+                portEXIT_CRITICAL(&s_lock);
+                continue;
+            }
+            mic_process_frame();
+        }
+
+        i2s_channel_disable(s_rx_chan);
+        portENTER_CRITICAL(&s_lock);
+        s_stats.active_s += (uint32_t)((esp_timer_get_time() - start_us) / 1000000LL);
+        portEXIT_CRITICAL(&s_lock);
+    }
+}
+
+bool mic_capture_init(mic_event_cb_t on_event)
+{
+    i2s_chan_config_t chan_cfg = I2S_CHANNEL_DEFAULT_CONFIG(MIC_I2S_PORT, I2S_ROLE_MASTER);
+    chan_cfg.dma_desc_num = MIC_DMA_DESC;
+    chan_cfg.dma_frame_num = AUDIO_DETECT_FRAME;
+
+    esp_err_t err = i2s_new_channel(&chan_cfg, NULL, &s_rx_chan);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "i2s_new_channel failed: %s", esp_err_to_name(err));
+        return false;
+    }
+
+    i2s_std_config_t std_cfg = {
+        .clk_cfg = I2S_STD_CLK_DEFAULT_CONFIG(AUDIO_DETECT_RATE_HZ),
+        .slot_cfg = I2S_STD_PHILIP_SLOT_DEFAULT_CONFIG(I2S_DATA_BIT_WIDTH_32BIT, I2S_SLOT_MODE_MONO),
+        .gpio_cfg = {
+            .mclk = I2S_GPIO_UNUSED,
+            .bclk = MIC_I2S_BCLK,
+            .ws = MIC_I2S_WS,
+            .dout = I2S_GPIO_UNUSED,
+            .din = MIC_I2S_DIN,
+            .invert_flags = {
+                .mclk_inv = false,
+                .bclk_inv = false,
+                .ws_inv = false,
+            },
+        },
+    };
+    err = i2s_channel_init_std_mode(s_rx_chan, &std_cfg);
+    if (err == ESP_OK) {
+        const i2s_event_callbacks_t cbs = {.on_recv_q_ovf = mic_on_recv_q_ovf};
+        err = i2s_channel_register_event_callback(s_rx_chan, &cbs, NULL);
+    }
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "i2s rx setup failed: %s", esp_err_to_name(err));
+        i2s_del_channel(s_rx_chan);
+        s_rx_chan = NULL;
+        return false;
+    }
+
+    s_on_event = on_event;
+    if (xTaskCreatePinnedToCore(mic_task, "mic", MIC_TASK_STACK, NULL, MIC_TASK_PRIO, &s_task, MIC_TASK_CORE) != pdPASS) {
+        ESP_LOGE(TAG, "task create failed");
+        return false;
+    }
+    ESP_LOGI(TAG, "mic i2s ready: %d Hz, %d-sample frames x %d DMA buffers, bclk=%d ws=%d din=%d",
+             AUDIO_DETECT_RATE_HZ, AUDIO_DETECT_FRAME, MIC_DMA_DESC, MIC_I2S_BCLK, MIC_I2S_WS, MIC_I2S_DIN);
+    return true;
+}
+
+void mic_capture_start(void)
+{
+    if (s_task && !atomic_exchange(&s_want_run, true)) {
+        xTaskNotifyGive(s_task);
+    }
+}
+
+void mic_capture_stop(void)
+{
+    atomic_store(&s_want_run, false);
+}
+
+void mic_capture_set_playback(bool active)
+{
+    atomic_store(&s_playback, active);
+}
+
+void mic_capture_get_stats(mic_stats_t *out)
+{
+    portENTER_CRITICAL(&s_lock);
+    *out = s_stats;
+    portEXIT_CRITICAL(&s_lock);
+    out->overruns = atomic_load(&s_overruns);
+}
+
+void mic_capture_log_stats(void)
+{
+    mic_stats_t st;
+    mic_capture_get_stats(&st);
+    if (st.frames == 0) {
+        return;
+    }
+    // Share of one core spent per frame period on conversion and detection.
+    uint32_t cpu_permille = (uint32_t)(st.detect_us_sum * 1000 / ((uint64_t)st.frames * MIC_FRAME_US));
+    ESP_LOGI(TAG, "frames=%u active_s=%u overruns=%u read_err=%u clap=%u double=%u voice=%u "
+             "detect_avg_us=%u detect_max_us=%u cpu=%u.%u%%",
+             (unsigned)st.frames, (unsigned)st.active_s, (unsigned)st.overruns, (unsigned)st.read_errors,
+             (unsigned)st.events[AUDIO_EV_CLAP], (unsigned)st.events[AUDIO_EV_DOUBLE_CLAP],
+             (unsigned)st.events[AUDIO_EV_VOICE],
+             (unsigned)(st.detect_us_sum / st.frames), (unsigned)st.detect_us_max,
+             (unsigned)(cpu_permille / 10), (unsigned)(cpu_permille % 10));
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "audio_detect.h"
+
+// Microphone capture on its own I2S port (the speaker's port runs at the beep
+// rate on other pins). The driver's DMA descriptors form the ring: MIC_DMA_DESC
+// buffers of one detector frame each. The mic task reads one frame at a time,
+// converts it to 16-bit and runs audio_detect on it; events go to a callback.
+//
+// Capture is off until mic_capture_start(): an enabled I2S channel holds a PM
+// lock, so it only runs while something (a reminder alert) is listening.
+
+#ifndef MIC_I2S_PORT
+#define MIC_I2S_PORT  I2S_NUM_1
+#endif
+#ifndef MIC_I2S_BCLK
+#define MIC_I2S_BCLK  15
+#endif
+#ifndef MIC_I2S_WS
+#define MIC_I2S_WS    2
+#endif
+#ifndef MIC_I2S_DIN
+#define MIC_I2S_DIN   39
+#endif
+
+// 24-bit samples arrive MSB-aligned in 32-bit slots; this shift gives +12 dB over a plain >> 16.
+#ifndef MIC_SAMPLE_SHIFT
+#define MIC_SAMPLE_SHIFT 14
+#endif
+
+#ifndef MIC_DMA_DESC
+#define MIC_DMA_DESC 4       // 64 ms of slack before the driver drops a buffer
+#endif
+
+#ifndef MIC_TASK_CORE
+#define MIC_TASK_CORE 0
+#endif
+
+// Below touch, above the clock task: a late frame is an overrun.
+#ifndef MIC_TASK_PRIO
+#define MIC_TASK_PRIO 7
+#endif
+
+#ifndef MIC_TASK_STACK
+#define MIC_TASK_STACK 3072
+#endif
+
+typedef struct {
+    uint32_t frames;
+    uint32_t overruns;        // DMA buffers the driver dropped because the task was late
+    uint32_t read_errors;
+    uint32_t events[AUDIO_EV_VOICE + 1];
+    uint32_t detect_us_max;   // convert + detect for one frame
+    uint64_t detect_us_sum;
+    uint32_t active_s;        // time spent capturing
+} mic_stats_t;
+
+// Called from the mic task.
+typedef void (*mic_event_cb_t)(audio_event_t ev);
+
+bool mic_capture_init(mic_event_cb_t on_event);
+void mic_capture_start(void);
+void mic_capture_stop(void);
+// Bracket speaker output with this so the tone is not taken for voice.
+void mic_capture_set_playback(bool active);
+void mic_capture_get_stats(mic_stats_t *out);
+void mic_capture_log_stats(void);
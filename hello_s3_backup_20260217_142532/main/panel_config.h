@@ -0,0 +1,16 @@
+#pragma once
+
+#include <stdint.h>
+
+#define LCD_H_RES 360
+#define LCD_V_RES 360
+
+// Rows per DMA chunk; bounds the draw buffer and the SPI max transfer size.
+#define DRAW_CHUNK_ROWS      8
+
+// Panel is configured for LCD_RGB_DATA_ENDIAN_BIG, so pixels are stored byte-swapped.
+static inline uint16_t rgb565_be(uint8_t r, uint8_t g, uint8_t b)
+{
+    uint16_t c = ((uint16_t)(r & 0xF8) << 8) | ((uint16_t)(g & 0xFC) << 3) | ((uint16_t)b >> 3);
+    return (uint16_t)((c << 8) | (c >> 8));
+}
@@ -0,0 +1,136 @@
+#include "q565.h"
+
+#include <string.h>
+
+static inline uint16_t q565_swap(uint16_t c)
+{
+    return (uint16_t)((c << 8) | (c >> 8));
+}
+
+static inline uint16_t q565_read_u16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+bool q565_decoder_init(q565_decoder_t *d, const void *data, size_t len)
+{
+    const uint8_t *p = data;
+    if (!d || !p || len < Q565_HEADER_BYTES ||
+        (uint32_t)(p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24)) != Q565_MAGIC) {
+        return false;
+    }
+    memset(d, 0, sizeof(*d));
+    d->width = q565_read_u16(p + 4);
+    d->height = q565_read_u16(p + 6);
+    d->flags = p[8];
+    d->outside_be = q565_swap(q565_read_u16(p + 10));
+    d->src = p + Q565_HEADER_BYTES;
+    d->end = p + len;
+    return d->width > 0 && d->height > 0;
+}
+
+// Decodes pixels [x, x1) of the current row; false on a short or corrupt stream.
+static bool q565_decode_span(q565_decoder_t *d, uint16_t *out, int x, int x1)
+{
+    const uint8_t *src = d->src;
+    const uint8_t *end = d->end;
+    uint16_t px = d->px;
+    unsigned run = d->run;
+    bool ok = true;
+
+    while (x < x1) {
+        if (run > 0) {
+            unsigned n = (unsigned)(x1 - x);
+            if (n > run) {
+                n = run;
+            }
+            uint16_t be = q565_swap(px);
+            for (unsigned i = 0; i < n; i++) {
+                out[x + i] = be;
+            }
+            x += (int)n;
+            run -= n;
+            continue;
+        }
+        if (src >= end) {
+            ok = false;
+            break;
+        }
+
+        uint8_t op = *src++;
+        if (op == Q565_OP_RGB) {
+            if (end - src < 2) {
+                ok = false;
+                break;
+            }
+            px = (uint16_t)((src[0] << 8) | src[1]);
+            src += 2;
+        } else if ((op & Q565_MASK_2) == Q565_OP_INDEX) {
+            px = d->index[op];
+        } else if ((op & Q565_MASK_2) == Q565_OP_DIFF) {
+            unsigned r = ((px >> 11) + ((op >> 4) & 3u) - 2u) & 31u;
+            unsigned g = ((px >> 5) + ((op >> 2) & 3u) - 2u) & 63u;
+            unsigned b = (px + (op & 3u) - 2u) & 31u;
+            px = (uint16_t)((r << 11) | (g << 5) | b);
+        } else if ((op & Q565_MASK_2) == Q565_OP_LUMA) {
+            if (src >= end) {
+                ok = false;
+                break;
+            }
+            int dg = (int)(op & 63u) - 32;
+            int rb = *src++;
+            int half = q565_half(dg);
+            unsigned r = (unsigned)((int)(px >> 11) + half + (rb >> 4) - 8) & 31u;
+            unsigned g = (unsigned)((int)((px >> 5) & 63u) + dg) & 63u;
+            unsigned b = (unsigned)((int)(px & 31u) + half + (rb & 15) - 8) & 31u;
+            px = (uint16_t)((r << 11) | (g << 5) | b);
+        } else {
+            run = (op & 63u) + 1u;
+            if (run > Q565_RUN_MAX) {
+                ok = false;
+                break;
+            }
+            continue;
+        }
+        d->index[q565_hash(px)] = px;
+        out[x++] = q565_swap(px);
+    }
+
+    d->src = src;
+    d->px = px;
+    d->run = (uint8_t)run;
+    return ok;
+}
+
+int q565_decode_rows(q565_decoder_t *d, uint16_t *out, int max_rows)
+{
+    if (!d || !out || max_rows <= 0) {
+        return -1;
+    }
+    int rows = d->height - d->next_row;
+    if (rows > max_rows) {
+        rows = max_rows;
+    }
+    bool round = (d->flags & Q565_FLAG_ROUND) != 0;
+
+    for (int r = 0; r < rows; r++) {
+        uint16_t *line = out + (size_t)r * d->width;
+        int x0;
+        int x1;
+        q565_row_span(d->width, d->height, round, d->next_row, &x0, &x1);
+        if (x1 <= x0) {
+            x0 = x1 = d->width;
+        }
+        for (int x = 0; x < x0; x++) {
+            line[x] = d->outside_be;
+        }
+        for (int x = x1; x < d->width; x++) {
+            line[x] = d->outside_be;
+        }
+        if (x1 > x0 && !q565_decode_span(d, line, x0, x1)) {
+            return -1;
+        }
+        d->next_row++;
+    }
+    return rows;
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Q565: a QOI-style lossless codec for RGB565 images, decoded in row bands so a
+// full-screen image never needs more RAM than one draw block plus this state.
+// Images flagged round only store pixels inside the inscribed circle; the rest
+// of every row is filled with the header's outside colour. Portable C, shared
+// by the firmware and the host benches; tools/png_to_assets.py is the encoder.
+//
+// Stream: "Q565", u16 width, u16 height, u8 flags, u8 reserved, u16 outside
+// (native RGB565), all little-endian, then ops over the stored pixels in row
+// order. Runs may cross row ends. Each op starts with one byte:
+//   00iiiiii  INDEX  pixel = index[i]
+//   01rrggbb  DIFF   r,g,b += field - 2 (wrapping per channel)
+//   10gggggg  LUMA   g += field - 32; next byte rrrrbbbb: r,b += half(dg) + field - 8
+//   11llllll  RUN    previous pixel l + 1 times (l < 62)
+//   11111110  RGB    two bytes, big-endian native RGB565
+// index[] is 64 entries hashed by (3r + 5g + 7b) & 63, updated for every pixel.
+
+#define Q565_MAGIC         0x35363551u   // "Q565"
+#define Q565_HEADER_BYTES  12
+#define Q565_FLAG_ROUND    0x01
+
+#define Q565_OP_INDEX      0x00
+#define Q565_OP_DIFF       0x40
+#define Q565_OP_LUMA       0x80
+#define Q565_OP_RUN        0xC0
+#define Q565_OP_RGB        0xFE
+#define Q565_MASK_2        0xC0
+#define Q565_RUN_MAX       62
+
+typedef struct {
+    const uint8_t *src;
+    const uint8_t *end;
+    uint16_t width;
+    uint16_t height;
+    uint16_t next_row;
+    uint16_t px;          // last pixel, native RGB565
+    uint16_t outside_be;  // panel byte order
+    uint8_t flags;
+    uint8_t run;
+    uint16_t index[64];
+} q565_decoder_t;
+
+static inline unsigned q565_hash(uint16_t c)
+{
+    return (((c >> 11) & 31u) * 3u + ((c >> 5) & 63u) * 5u + (c & 31u) * 7u) & 63u;
+}
+
+// floor(d / 2) for the LUMA red/blue prediction; identical on every platform.
+static inline int q565_half(int d)
+{
+    return (d >= 0) ? d / 2 : -((1 - d) / 2);
+}
+
+static inline uint32_t q565_isqrt(uint32_t v)
+{
+    uint32_t r = 0;
+    uint32_t bit = 1u << 30;
+    while (bit > v) {
+        bit >>= 2;
+    }
+    while (bit) {
+        if (v >= r + bit) {
+            v -= r + bit;
+            r = (r >> 1) + bit;
+        } else {
+            r >>= 1;
+        }
+        bit >>= 2;
+    }
+    return r;
+}
+
+// Stored pixel span [x0, x1) of row y; x1 <= x0 means the row stores nothing.
+static inline void q565_row_span(uint16_t width, uint16_t height, bool round, int y, int *x0, int *x1)
+{
+    *x0 = 0;
+    *x1 = width;
+    if (!round) {
+        return;
+    }
+    // Pixel centres inside the inscribed circle, in doubled coordinates to stay integral.
+    int diameter = (width < height) ? width : height;
+    int dy = 2 * y + 1 - height;
+    int64_t rem = (int64_t)diameter * diameter - (int64_t)dy * dy;
+    if (rem < 0) {
+        *x1 = 0;
+        return;
+    }
+    int s = (int)q565_isqrt((uint32_t)rem);
+    int lo = width - 1 - s;
+    int hi = width - 1 + s;
+    *x0 = (lo <= 0) ? 0 : (lo + 1) / 2;
+    *x1 = hi / 2 + 1;
+    if (*x1 > width) {
+        *x1 = width;
+    }
+}
+
+// Parses the header; false if data is not a Q565 stream.
+bool q565_decoder_init(q565_decoder_t *d, const void *data, size_t len);
+
+// Decodes up to max_rows full rows (width pixels each, panel byte order) into
+// out. Returns the rows written, 0 once the image is complete, -1 on a
+// truncated or corrupt stream.
+int q565_decode_rows(q565_decoder_t *d, uint16_t *out, int max_rows);
@@ -0,0 +1,244 @@
+#include "reminder_feed.h"
+
+#include <string.h>
+
+enum {
+    KEY_OTHER,
+    KEY_CURSOR,
+    KEY_FULL,
+    KEY_REMINDERS,
+};
+
+enum {
+    FIELD_OTHER,
+    FIELD_ID,
+    FIELD_AT,
+    FIELD_DAYS,
+    FIELD_TEXT,
+    FIELD_DELETED,
+};
+
+// Member depths: top-level keys at 1, list entries at 2, record fields at 3.
+#define DEPTH_TOP    1
+#define DEPTH_ENTRY  2
+#define DEPTH_FIELD  3
+
+static bool parse_u32(const char *s, size_t len, uint32_t *out)
+{
+    if (len == 0 || len > 10) {
+        return false;
+    }
+    uint64_t v = 0;
+    for (size_t i = 0; i < len; i++) {
+        if (s[i] < '0' || s[i] > '9') {
+            return false;  // sign, fraction or exponent
+        }
+        v = v * 10 + (uint64_t)(s[i] - '0');
+    }
+    if (v > UINT32_MAX) {
+        return false;
+    }
+    *out = (uint32_t)v;
+    return true;
+}
+
+static bool parse_hhmm(const char *s, size_t len, uint8_t *hour, uint8_t *minute)
+{
+    if (len != 5 || s[2] != ':') {
+        return false;
+    }
+    for (int i = 0; i < 5; i++) {
+        if (i != 2 && (s[i] < '0' || s[i] > '9')) {
+            return false;
+        }
+    }
+    int h = (s[0] - '0') * 10 + (s[1] - '0');
+    int m = (s[3] - '0') * 10 + (s[4] - '0');
+    if (h > 23 || m > 59) {
+        return false;
+    }
+    *hour = (uint8_t)h;
+    *minute = (uint8_t)m;
+    return true;
+}
+
+// Copies at most cap - 1 bytes without splitting a UTF-8 sequence.
+// A cursor cut by the parser must still show up as too long, never as a shorter valid one.
+_Static_assert(JSON_SAX_TOKEN_MAX >= REMINDER_CURSOR_MAX, "json_sax would truncate cursors unnoticed");
+
+static void copy_utf8(char *dst, size_t cap, const char *src, size_t len)
+{
+    if (len >= cap) {
+        len = cap - 1;
+        while (len > 0 && ((uint8_t)src[len] & 0xC0) == 0x80) {
+            len--;
+        }
+    }
+    memcpy(dst, src, len);
+    dst[len] = '\0';
+}
+
+static void record_begin(reminder_feed_t *f)
+{
+    memset(&f->rec, 0, sizeof(f->rec));
+    f->rec.days = REMINDER_DAYS_ALL;
+    f->in_record = true;
+    f->rec_bad = false;
+    f->rec_deleted = false;
+    f->rec_has_time = false;
+    f->field = FIELD_OTHER;
+}
+
+static void record_end(reminder_feed_t *f)
+{
+    f->in_record = false;
+    reminder_feed_result_t *res = &f->result;
+    if (f->rec_bad || f->rec.id == 0) {
+        res->rejected++;
+    } else if (f->rec_deleted) {
+        f->sink.remove(f->sink.ctx, f->rec.id);
+        res->deletes++;
+    } else if (!f->rec_has_time || f->rec.days == 0) {
+        res->rejected++;
+    } else if (f->sink.upsert(f->sink.ctx, &f->rec)) {
+        res->upserts++;
+    } else {
+        res->dropped++;
+    }
+}
+
+static void record_field(reminder_feed_t *f, json_event_t ev, const char *text, size_t len)
+{
+    uint32_t v = 0;
+    switch (f->field) {
+    case FIELD_ID:
+        if (ev != JSON_EV_NUMBER || !parse_u32(text, len, &f->rec.id)) {
+            f->rec_bad = true;
+        }
+        break;
+    case FIELD_AT:
+        if (ev != JSON_EV_STRING || !parse_hhmm(text, len, &f->rec.hour, &f->rec.minute)) {
+            f->rec_bad = true;
+        }
+        f->rec_has_time = true;
+        break;
+    case FIELD_DAYS:
+        if (ev != JSON_EV_NUMBER || !parse_u32(text, len, &v) || v > REMINDER_DAYS_ALL) {
+            f->rec_bad = true;
+        }
+        f->rec.days = (uint8_t)v;
+        break;
+    case FIELD_TEXT:
+        if (ev != JSON_EV_STRING) {
+            f->rec_bad = true;
+            break;
+        }
+        copy_utf8(f->rec.text, sizeof(f->rec.text), text, len);
+        break;
+    case FIELD_DELETED:
+        if (ev != JSON_EV_TRUE && ev != JSON_EV_FALSE) {
+            f->rec_bad = true;
+        }
+        f->rec_deleted = (ev == JSON_EV_TRUE);
+        break;
+    default:
+        break;
+    }
+}
+
+static bool feed_event(void *ctx, json_event_t ev, const char *text, size_t len, int depth)
+{
+    reminder_feed_t *f = (reminder_feed_t *)ctx;
+    bool begin = (ev == JSON_EV_OBJECT_BEGIN || ev == JSON_EV_ARRAY_BEGIN);
+    bool end = (ev == JSON_EV_OBJECT_END || ev == JSON_EV_ARRAY_END);
+
+    if (depth == 0) {
+        return ev == JSON_EV_OBJECT_BEGIN || ev == JSON_EV_OBJECT_END;  // feed must be an object
+    }
+
+    if (depth == DEPTH_TOP) {
+        if (ev == JSON_EV_KEY) {
+            f->top_key = !strcmp(text, "cursor")      ? KEY_CURSOR
+                         : !strcmp(text, "full")      ? KEY_FULL
+                         : !strcmp(text, "reminders") ? KEY_REMINDERS
+                                                      : KEY_OTHER;
+            return true;
+        }
+        switch (f->top_key) {
+        case KEY_CURSOR:
+            // The cursor is opaque: a truncated one would ask for the wrong delta, so an
+            // over-long one is not taken at all.
+            if ((ev == JSON_EV_STRING || ev == JSON_EV_NUMBER) && len >= sizeof(f->result.cursor)) {
+                f->result.has_cursor = false;
+                f->result.cursor_too_long = true;
+            } else if (ev == JSON_EV_STRING || ev == JSON_EV_NUMBER) {
+                memcpy(f->result.cursor, text, len);
+                f->result.cursor[len] = '\0';
+                f->result.has_cursor = true;
+                f->result.cursor_too_long = false;
+            }
+            break;
+        case KEY_FULL:
+            f->result.full = (ev == JSON_EV_TRUE);
+            break;
+        case KEY_REMINDERS:
+            if (ev == JSON_EV_ARRAY_BEGIN) {
+                f->in_list = true;
+            } else if (ev == JSON_EV_ARRAY_END) {
+                f->in_list = false;
+            }
+            break;
+        default:
+            break;
+        }
+        return true;
+    }
+
+    if (!f->in_list) {
+        return true;
+    }
+
+    if (depth == DEPTH_ENTRY) {
+        if (ev == JSON_EV_OBJECT_BEGIN) {
+            record_begin(f);
+        } else if (ev == JSON_EV_OBJECT_END) {
+            record_end(f);
+        } else if (!end) {
+            f->result.rejected++;  // list entry that is not an object
+        }
+        return true;
+    }
+
+    if (depth == DEPTH_FIELD && f->in_record) {
+        if (ev == JSON_EV_KEY) {
+            f->field = !strcmp(text, "id")        ? FIELD_ID
+                       : !strcmp(text, "at")      ? FIELD_AT
+                       : !strcmp(text, "days")    ? FIELD_DAYS
+                       : !strcmp(text, "text")    ? FIELD_TEXT
+                       : !strcmp(text, "deleted") ? FIELD_DELETED
+                                                  : FIELD_OTHER;
+        } else if (begin && f->field != FIELD_OTHER) {
+            f->rec_bad = true;  // a known field holding an object or array
+        } else if (!end) {
+            record_field(f, ev, text, len);
+        }
+    }
+    return true;
+}
+
+void reminder_feed_init(reminder_feed_t *f, const reminder_feed_sink_t *sink)
+{
+    memset(f, 0, sizeof(*f));
+    f->sink = *sink;
+    json_sax_init(&f->sax, feed_event, f);
+}
+
+bool reminder_feed_write(reminder_feed_t *f, const void *data, size_t len)
+{
+    return json_sax_feed(&f->sax, data, len);
+}
+
+bool reminder_feed_finish(reminder_feed_t *f)
+{
+    return json_sax_finish(&f->sax);
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "json_sax.h"
+#include "reminder_store.h"
+
+// Reminder feed schema on top of json_sax: records are handed to the sink one
+// at a time as each object closes, so nothing but the record being parsed is
+// held in RAM. Pure C with no IDF dependencies; the host bench runs it as is.
+//
+//   {
+//     "cursor": "opaque",          // next `since` value
+//     "full": false,               // true: the feed is a snapshot, drop anything not in it
+//     "reminders": [
+//       {"id": 7, "at": "07:30", "days": 62, "text": "Stand-up"},
+//       {"id": 9, "deleted": true}
+//     ]
+//   }
+//
+// Unknown keys are skipped at any depth. A record with a missing or mistyped
+// field is counted in `rejected` and skipped; malformed JSON fails the feed.
+
+typedef struct {
+    bool (*upsert)(void *ctx, const reminder_t *r);  // false: not stored (table full)
+    void (*remove)(void *ctx, uint32_t id);
+    void *ctx;
+} reminder_feed_sink_t;
+
+typedef struct {
+    uint32_t upserts;
+    uint32_t deletes;
+    uint32_t rejected;
+    uint32_t dropped;      // valid but the sink had no room
+    bool full;
+    bool has_cursor;
+    bool cursor_too_long;  // a cursor came that does not fit; has_cursor stays false
+    char cursor[REMINDER_CURSOR_MAX];
+} reminder_feed_result_t;
+
+typedef struct {
+    json_sax_t sax;
+    reminder_feed_sink_t sink;
+    reminder_feed_result_t result;
+    uint8_t top_key;
+    uint8_t field;
+    bool in_list;
+    bool in_record;
+    bool rec_bad;
+    bool rec_deleted;
+    bool rec_has_time;
+    reminder_t rec;
+} reminder_feed_t;
+
+void reminder_feed_init(reminder_feed_t *f, const reminder_feed_sink_t *sink);
+// Feeds the next chunk of the body; false once the document is known to be bad.
+bool reminder_feed_write(reminder_feed_t *f, const void *data, size_t len);
+bool reminder_feed_finish(reminder_feed_t *f);
@@ -0,0 +1,143 @@
+#include "reminder_screen.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "lvgl.h"
+#include "panel_config.h"
+#include "reminder_store.h"
+
+#define RING_SIZE      (LCD_H_RES - 16)
+#define RING_WIDTH     6
+#define NEXT_WIDTH     250
+#define LABEL_TEXT_MAX (REMINDER_TEXT_MAX + 16)
+
+typedef struct {
+    lv_obj_t *obj;
+    char text[LABEL_TEXT_MAX];
+} label_t;
+
+static lv_obj_t *s_ring = NULL;
+static label_t s_time;
+static label_t s_date;
+static label_t s_next;
+static label_t s_status;
+static bool s_synced = true;
+
+static const char *const s_wday[] = {"Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat"};
+static const char *const s_month[] = {"Jan", "Feb", "Mar", "Apr", "May", "Jun",
+                                      "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
+
+static void label_create(label_t *l, lv_obj_t *parent, const lv_font_t *font, lv_color_t color, int y)
+{
+    l->obj = lv_label_create(parent);
+    l->text[0] = '\0';
+    lv_label_set_text_static(l->obj, l->text);
+    lv_obj_set_style_text_font(l->obj, font, 0);
+    lv_obj_set_style_text_color(l->obj, color, 0);
+    lv_obj_set_style_text_align(l->obj, LV_TEXT_ALIGN_CENTER, 0);
+    lv_obj_align(l->obj, LV_ALIGN_CENTER, 0, y);
+}
+
+// Setting a label invalidates it even when the text is the same; skip those.
+static void label_set(label_t *l, const char *text)
+{
+    if (strcmp(l->text, text) == 0) {
+        return;
+    }
+    snprintf(l->text, sizeof(l->text), "%s", text);
+    lv_label_set_text_static(l->obj, l->text);
+}
+
+// Reminders still ahead today (including the current minute); *next gets the earliest.
+static int reminders_left_today(const struct tm *ti, reminder_t *next)
+{
+    int now_min = ti->tm_hour * 60 + ti->tm_min;
+    int best_min = 24 * 60;
+    int left = 0;
+    int count = reminder_store_count();
+    for (int i = 0; i < count; i++) {
+        reminder_t r;
+        if (!reminder_store_get(i, &r) || (r.days & (1U << ti->tm_wday)) == 0) {
+            continue;
+        }
+        int at_min = r.hour * 60 + r.minute;
+        if (at_min < now_min) {
+            continue;
+        }
+        left++;
+        if (at_min < best_min) {
+            best_min = at_min;
+            *next = r;
+        }
+    }
+    return left;
+}
+
+void reminder_screen_create(void)
+{
+    lv_obj_t *scr = lv_scr_act();
+    lv_obj_set_style_bg_color(scr, lv_color_black(), 0);
+    lv_obj_clear_flag(scr, LV_OBJ_FLAG_SCROLLABLE);
+
+    s_ring = lv_arc_create(scr);
+    lv_obj_set_size(s_ring, RING_SIZE, RING_SIZE);
+    lv_obj_center(s_ring);
+    lv_arc_set_rotation(s_ring, 270);
+    lv_arc_set_bg_angles(s_ring, 0, 360);
+    lv_arc_set_range(s_ring, 0, 59);
+    lv_arc_set_value(s_ring, 0);
+    lv_obj_remove_style(s_ring, NULL, LV_PART_KNOB);
+    lv_obj_clear_flag(s_ring, LV_OBJ_FLAG_CLICKABLE);
+    lv_obj_set_style_arc_width(s_ring, RING_WIDTH, LV_PART_MAIN);
+    lv_obj_set_style_arc_width(s_ring, RING_WIDTH, LV_PART_INDICATOR);
+    lv_obj_set_style_arc_color(s_ring, lv_color_hex(0x202020), LV_PART_MAIN);
+    lv_obj_set_style_arc_color(s_ring, lv_color_hex(0x5AC8FA), LV_PART_INDICATOR);
+
+    label_create(&s_time, scr, &lv_font_montserrat_48, lv_color_white(), -40);
+    label_create(&s_date, scr, &lv_font_montserrat_20, lv_color_hex(0x9A9A9A), 8);
+    label_create(&s_next, scr, &lv_font_montserrat_20, lv_color_white(), 60);
+    lv_label_set_long_mode(s_next.obj, LV_LABEL_LONG_DOT);
+    lv_obj_set_width(s_next.obj, NEXT_WIDTH);
+    label_create(&s_status, scr, &lv_font_montserrat_14, lv_color_hex(0x9A9A9A), 100);
+}
+
+void reminder_screen_update(const struct tm *ti, bool synced)
+{
+    if (!s_ring) {
+        return;
+    }
+    char text[LABEL_TEXT_MAX];
+
+    if (lv_arc_get_value(s_ring) != ti->tm_sec) {
+        lv_arc_set_value(s_ring, (int16_t)ti->tm_sec);
+    }
+    if (synced != s_synced) {
+        s_synced = synced;
+        lv_obj_set_style_arc_color(s_ring, synced ? lv_color_hex(0x5AC8FA) : lv_color_hex(0x707070),
+                                   LV_PART_INDICATOR);
+    }
+
+    snprintf(text, sizeof(text), "%02d:%02d", ti->tm_hour, ti->tm_min);
+    label_set(&s_time, text);
+    snprintf(text, sizeof(text), "%s %d %s", s_wday[ti->tm_wday % 7], ti->tm_mday, s_month[ti->tm_mon % 12]);
+    label_set(&s_date, text);
+
+    reminder_t next;
+    int left = reminders_left_today(ti, &next);
+    if (left > 0) {
+        snprintf(text, sizeof(text), "%02u:%02u  %s", (unsigned)next.hour, (unsigned)next.minute, next.text);
+    } else {
+        snprintf(text, sizeof(text), "No more reminders today");
+    }
+    label_set(&s_next, text);
+
+    if (!synced) {
+        snprintf(text, sizeof(text), "Time not synced");
+    } else if (left > 1) {
+        snprintf(text, sizeof(text), "%d more today", left - 1);
+    } else {
+        text[0] = '\0';
+    }
+    label_set(&s_status, text);
+}
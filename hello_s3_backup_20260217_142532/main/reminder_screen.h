@@ -0,0 +1,11 @@
+#pragma once
+
+#include <stdbool.h>
+#include <time.h>
+
+// Reference LVGL screen for the round panel: a seconds ring, the time, the date,
+// the next reminder due today and how many are left. Call from the LVGL task.
+
+void reminder_screen_create(void);
+// Only labels whose text changed are touched, so a plain second tick redraws the ring's new arc.
+void reminder_screen_update(const struct tm *ti, bool synced);
@@ -0,0 +1,231 @@
+#include "reminder_store.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "esp_err.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "nvs.h"
+
+#define REMINDER_NVS_NS      "reminders"
+#define REMINDER_NVS_KEY     "table"
+#define REMINDER_NVS_VERSION 1
+
+// Stored as a prefix: header plus `count` entries.
+typedef struct {
+    uint8_t version;
+    uint8_t count;
+    uint16_t reserved;
+    char since[REMINDER_CURSOR_MAX];
+    char etag[REMINDER_CURSOR_MAX];
+    reminder_t entries[REMINDER_STORE_MAX];
+} reminder_table_t;
+
+_Static_assert(REMINDER_STORE_MAX <= 255, "count is a uint8_t");
+
+static const char *TAG = "reminders";
+
+static reminder_table_t s_table;                 // sorted by id
+static bool s_seen[REMINDER_STORE_MAX];
+static SemaphoreHandle_t s_lock = NULL;
+
+static void store_lock(void)
+{
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+}
+
+static void store_unlock(void)
+{
+    xSemaphoreGive(s_lock);
+}
+
+static size_t table_bytes(uint8_t count)
+{
+    return offsetof(reminder_table_t, entries) + (size_t)count * sizeof(reminder_t);
+}
+
+// Index of id, or of the slot it would be inserted at (found = false).
+static int table_find(uint32_t id, bool *found)
+{
+    int lo = 0;
+    int hi = s_table.count;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (s_table.entries[mid].id < id) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    *found = lo < s_table.count && s_table.entries[lo].id == id;
+    return lo;
+}
+
+static void table_load(void)
+{
+    memset(&s_table, 0, sizeof(s_table));
+
+    nvs_handle_t nvs = 0;
+    if (nvs_open(REMINDER_NVS_NS, NVS_READONLY, &nvs) != ESP_OK) {
+        return;
+    }
+    size_t len = sizeof(s_table);
+    esp_err_t err = nvs_get_blob(nvs, REMINDER_NVS_KEY, &s_table, &len);
+    nvs_close(nvs);
+
+    if (err != ESP_OK || len < table_bytes(0) || s_table.version != REMINDER_NVS_VERSION ||
+        s_table.count > REMINDER_STORE_MAX || len != table_bytes(s_table.count)) {
+        if (err == ESP_OK) {
+            ESP_LOGW(TAG, "stored table invalid, starting empty");
+        }
+        memset(&s_table, 0, sizeof(s_table));
+        return;
+    }
+    s_table.since[REMINDER_CURSOR_MAX - 1] = '\0';
+    s_table.etag[REMINDER_CURSOR_MAX - 1] = '\0';
+}
+
+void reminder_store_init(void)
+{
+    s_lock = xSemaphoreCreateMutex();
+    if (!s_lock) {
+        ESP_LOGE(TAG, "no mutex");
+        abort();
+    }
+    table_load();
+    ESP_LOGI(TAG, "%u reminders, since=\"%s\"", (unsigned)s_table.count, s_table.since);
+}
+
+int reminder_store_count(void)
+{
+    store_lock();
+    int count = s_table.count;
+    store_unlock();
+    return count;
+}
+
+bool reminder_store_get(int i, reminder_t *out)
+{
+    store_lock();
+    bool ok = i >= 0 && i < s_table.count;
+    if (ok) {
+        *out = s_table.entries[i];
+    }
+    store_unlock();
+    return ok;
+}
+
+void reminder_store_begin_sync(void)
+{
+    store_lock();
+    memset(s_seen, 0, sizeof(s_seen));
+    store_unlock();
+}
+
+reminder_apply_t reminder_store_upsert(const reminder_t *r)
+{
+    store_lock();
+    bool found = false;
+    int i = table_find(r->id, &found);
+    reminder_apply_t result;
+    if (found) {
+        result = (memcmp(&s_table.entries[i], r, sizeof(*r)) == 0) ? REMINDER_APPLY_UNCHANGED
+                                                                    : REMINDER_APPLY_UPDATED;
+        s_table.entries[i] = *r;
+        s_seen[i] = true;
+    } else if (s_table.count >= REMINDER_STORE_MAX) {
+        result = REMINDER_APPLY_FULL;
+    } else {
+        memmove(&s_table.entries[i + 1], &s_table.entries[i],
+                (size_t)(s_table.count - i) * sizeof(reminder_t));
+        memmove(&s_seen[i + 1], &s_seen[i], (size_t)(s_table.count - i) * sizeof(bool));
+        s_table.entries[i] = *r;
+        s_seen[i] = true;
+        s_table.count++;
+        result = REMINDER_APPLY_ADDED;
+    }
+    store_unlock();
+    return result;
+}
+
+static void table_remove_at(int i)
+{
+    memmove(&s_table.entries[i], &s_table.entries[i + 1],
+            (size_t)(s_table.count - i - 1) * sizeof(reminder_t));
+    memmove(&s_seen[i], &s_seen[i + 1], (size_t)(s_table.count - i - 1) * sizeof(bool));
+    s_table.count--;
+}
+
+bool reminder_store_remove(uint32_t id)
+{
+    store_lock();
+    bool found = false;
+    int i = table_find(id, &found);
+    if (found) {
+        table_remove_at(i);
+    }
+    store_unlock();
+    return found;
+}
+
+int reminder_store_sweep_unseen(void)
+{
+    store_lock();
+    int removed = 0;
+    for (int i = s_table.count - 1; i >= 0; i--) {
+        if (!s_seen[i]) {
+            table_remove_at(i);
+            removed++;
+        }
+    }
+    store_unlock();
+    return removed;
+}
+
+bool reminder_store_commit(const char *since, const char *etag)
+{
+    store_lock();
+    s_table.version = REMINDER_NVS_VERSION;
+    snprintf(s_table.since, sizeof(s_table.since), "%s", since ? since : "");
+    snprintf(s_table.etag, sizeof(s_table.etag), "%s", etag ? etag : "");
+
+    nvs_handle_t nvs = 0;
+    esp_err_t err = nvs_open(REMINDER_NVS_NS, NVS_READWRITE, &nvs);
+    if (err == ESP_OK) {
+        err = nvs_set_blob(nvs, REMINDER_NVS_KEY, &s_table, table_bytes(s_table.count));
+        if (err == ESP_OK) {
+            err = nvs_commit(nvs);
+        }
+        nvs_close(nvs);
+    }
+    store_unlock();
+
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "table write failed: %s", esp_err_to_name(err));
+        reminder_store_revert();
+        return false;
+    }
+    return true;
+}
+
+void reminder_store_revert(void)
+{
+    store_lock();
+    table_load();
+    store_unlock();
+}
+
+void reminder_store_get_cursors(char *since, char *etag, size_t cap)
+{
+    store_lock();
+    if (since) {
+        snprintf(since, cap, "%s", s_table.since);
+    }
+    if (etag) {
+        snprintf(etag, cap, "%s", s_table.etag);
+    }
+    store_unlock();
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Fixed-size reminder table in RAM, persisted to NVS as one blob together with
+// the feed cursors. Sync edits the table in place and then either commits it or
+// reverts to the stored copy, so a half-applied feed never reaches flash.
+//
+// All functions take the store's mutex; safe to call from any task.
+
+#ifndef REMINDER_STORE_MAX
+#define REMINDER_STORE_MAX 32
+#endif
+
+#define REMINDER_TEXT_MAX   48   // bytes including the NUL, UTF-8
+#define REMINDER_CURSOR_MAX 64   // `since` value and ETag, including the NUL
+
+#define REMINDER_DAYS_ALL 0x7F   // bit n = tm_wday n (bit 0 = Sunday)
+
+typedef struct {
+    uint32_t id;          // assigned by the server, never 0
+    uint8_t hour;
+    uint8_t minute;
+    uint8_t days;
+    uint8_t reserved;
+    char text[REMINDER_TEXT_MAX];
+} reminder_t;
+
+typedef enum {
+    REMINDER_APPLY_ADDED,
+    REMINDER_APPLY_UPDATED,
+    REMINDER_APPLY_UNCHANGED,
+    REMINDER_APPLY_FULL,
+} reminder_apply_t;
+
+void reminder_store_init(void);
+int reminder_store_count(void);
+// Copies entry i (in id order); false when out of range.
+bool reminder_store_get(int i, reminder_t *out);
+
+// Sync session: begin marks every entry unseen; upsert/remove edit the table and
+// mark what the feed touched; sweep drops entries the feed did not mention (for
+// full snapshots); commit persists table + cursors, revert reloads from NVS.
+void reminder_store_begin_sync(void);
+reminder_apply_t reminder_store_upsert(const reminder_t *r);
+bool reminder_store_remove(uint32_t id);
+int reminder_store_sweep_unseen(void);
+bool reminder_store_commit(const char *since, const char *etag);
+void reminder_store_revert(void);
+
+// Cursors of the last committed sync; empty strings before the first one.
+void reminder_store_get_cursors(char *since, char *etag, size_t cap);
@@ -0,0 +1,206 @@
+#include "reminder_sync.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+
+#include "esp_crt_bundle.h"
+#include "esp_http_client.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "reminder_feed.h"
+#include "reminder_store.h"
+
+#define SYNC_RX_CHUNK 512
+#define SYNC_URL_MAX  (sizeof(REMINDER_SYNC_URL) + 8 + 3 * REMINDER_CURSOR_MAX)
+
+static const char *TAG = "remsync";
+
+// Only the network task syncs, so these stay off its stack.
+static char s_rx[SYNC_RX_CHUNK];
+static reminder_feed_t s_feed;
+static char s_new_etag[REMINDER_CURSOR_MAX];
+
+static bool sink_upsert(void *ctx, const reminder_t *r)
+{
+    (void)ctx;
+    return reminder_store_upsert(r) != REMINDER_APPLY_FULL;
+}
+
+static void sink_remove(void *ctx, uint32_t id)
+{
+    (void)ctx;
+    reminder_store_remove(id);
+}
+
+static esp_err_t sync_http_event(esp_http_client_event_t *evt)
+{
+    if (evt->event_id == HTTP_EVENT_ON_HEADER && strcasecmp(evt->header_key, "ETag") == 0) {
+        // A cut-down ETag would never match; without one the next request is simply unconditional.
+        size_t len = strlen(evt->header_value);
+        if (len < sizeof(s_new_etag)) {
+            memcpy(s_new_etag, evt->header_value, len + 1);
+        } else {
+            s_new_etag[0] = '\0';
+            ESP_LOGW(TAG, "ETag of %u bytes dropped", (unsigned)len);
+        }
+    }
+    return ESP_OK;
+}
+
+// The cursor is opaque, so anything outside RFC 3986 unreserved is escaped.
+static void build_url(char *url, size_t cap, const char *since)
+{
+    size_t n = (size_t)snprintf(url, cap, "%s", REMINDER_SYNC_URL);
+    if (since[0] == '\0' || n >= cap) {
+        return;
+    }
+    n += (size_t)snprintf(url + n, cap - n, "%ssince=", strchr(url, '?') ? "&" : "?");
+    for (const char *s = since; *s && n + 4 < cap; s++) {
+        unsigned char c = (unsigned char)*s;
+        if ((c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') ||
+            c == '-' || c == '.' || c == '_' || c == '~') {
+            url[n++] = (char)c;
+        } else {
+            n += (size_t)snprintf(url + n, cap - n, "%%%02X", c);
+        }
+    }
+    url[n] = '\0';
+}
+
+// Streams the body into the store. Returns false if the transfer or the document is bad.
+static bool sync_apply_body(esp_http_client_handle_t client, reminder_sync_report_t *rep)
+{
+    static const reminder_feed_sink_t sink = {
+        .upsert = sink_upsert,
+        .remove = sink_remove,
+    };
+    reminder_feed_init(&s_feed, &sink);
+    reminder_store_begin_sync();
+
+    while (1) {
+        int n = esp_http_client_read(client, s_rx, sizeof(s_rx));
+        if (n < 0) {
+            ESP_LOGW(TAG, "read failed after %u B", (unsigned)rep->body_bytes);
+            return false;
+        }
+        if (n == 0) {
+            break;
+        }
+        rep->body_bytes += (uint32_t)n;
+        if (rep->body_bytes > REMINDER_SYNC_MAX_BODY) {
+            ESP_LOGW(TAG, "body over %u B, giving up", (unsigned)REMINDER_SYNC_MAX_BODY);
+            return false;
+        }
+        if (!reminder_feed_write(&s_feed, s_rx, (size_t)n)) {
+            break;
+        }
+    }
+
+    bool parsed = reminder_feed_finish(&s_feed);
+    const reminder_feed_result_t *res = &s_feed.result;
+    rep->upserts = res->upserts;
+    rep->deletes = res->deletes;
+    rep->rejected = res->rejected;
+    rep->dropped = res->dropped;
+    if (!parsed) {
+        ESP_LOGW(TAG, "feed rejected at byte %u: %s", (unsigned)s_feed.sax.offset,
+                 json_sax_error_name(s_feed.sax.error));
+        return false;
+    }
+    if (!esp_http_client_is_complete_data_received(client)) {
+        ESP_LOGW(TAG, "connection closed before Content-Length");
+        return false;
+    }
+    return true;
+}
+
+bool reminder_sync_enabled(void)
+{
+    return REMINDER_SYNC_URL[0] != '\0';
+}
+
+reminder_sync_status_t reminder_sync_run(reminder_sync_report_t *out)
+{
+    reminder_sync_report_t rep = {.status = REMINDER_SYNC_DISABLED};
+    if (!reminder_sync_enabled()) {
+        if (out) {
+            *out = rep;
+        }
+        return rep.status;
+    }
+
+    char since[REMINDER_CURSOR_MAX];
+    char etag[REMINDER_CURSOR_MAX];
+    char url[SYNC_URL_MAX];
+    reminder_store_get_cursors(since, etag, sizeof(since));
+    build_url(url, sizeof(url), since);
+    s_new_etag[0] = '\0';
+
+    int64_t start_us = esp_timer_get_time();
+    esp_http_client_config_t cfg = {
+        .url = url,
+        .timeout_ms = REMINDER_SYNC_TIMEOUT_MS,
+        .buffer_size = SYNC_RX_CHUNK,
+        .buffer_size_tx = SYNC_RX_CHUNK,
+        .event_handler = sync_http_event,
+        .crt_bundle_attach = esp_crt_bundle_attach,
+    };
+    esp_http_client_handle_t client = esp_http_client_init(&cfg);
+    if (!client) {
+        ESP_LOGW(TAG, "client init failed");
+        rep.status = REMINDER_SYNC_FAILED;
+        if (out) {
+            *out = rep;
+        }
+        return rep.status;
+    }
+    esp_http_client_set_header(client, "Accept", "application/json");
+    if (etag[0] != '\0') {
+        esp_http_client_set_header(client, "If-None-Match", etag);
+    }
+
+    rep.status = REMINDER_SYNC_FAILED;
+    esp_err_t err = esp_http_client_open(client, 0);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "connect failed: %s", esp_err_to_name(err));
+    } else if (esp_http_client_fetch_headers(client) < 0) {
+        ESP_LOGW(TAG, "no response headers");
+    } else {
+        rep.http_status = esp_http_client_get_status_code(client);
+        if (rep.http_status == 304) {
+            rep.status = REMINDER_SYNC_UNCHANGED;
+        } else if (rep.http_status != 200) {
+            ESP_LOGW(TAG, "HTTP %d", rep.http_status);
+        } else if (!sync_apply_body(client, &rep)) {
+            reminder_store_revert();
+        } else {
+            if (s_feed.result.full) {
+                rep.swept = (uint32_t)reminder_store_sweep_unseen();
+            }
+            // Without a usable cursor the stored one stays; the server resends from there.
+            if (s_feed.result.cursor_too_long) {
+                ESP_LOGW(TAG, "cursor longer than %d bytes; keeping the previous one", REMINDER_CURSOR_MAX - 1);
+            }
+            const char *next = s_feed.result.has_cursor ? s_feed.result.cursor : since;
+            if (reminder_store_commit(next, s_new_etag)) {
+                rep.status = REMINDER_SYNC_APPLIED;
+            }
+        }
+    }
+    esp_http_client_cleanup(client);
+    rep.duration_ms = (uint32_t)((esp_timer_get_time() - start_us) / 1000);
+
+    if (rep.status == REMINDER_SYNC_APPLIED) {
+        ESP_LOGI(TAG, "applied %u B in %u ms: +%u -%u swept %u rejected %u dropped %u, %d stored",
+                 (unsigned)rep.body_bytes, (unsigned)rep.duration_ms, (unsigned)rep.upserts,
+                 (unsigned)rep.deletes, (unsigned)rep.swept, (unsigned)rep.rejected,
+                 (unsigned)rep.dropped, reminder_store_count());
+    } else if (rep.status == REMINDER_SYNC_UNCHANGED) {
+        ESP_LOGI(TAG, "unchanged (%u ms)", (unsigned)rep.duration_ms);
+    }
+    if (out) {
+        *out = rep;
+    }
+    return rep.status;
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Pulls reminder changes from an HTTP(S) endpoint into reminder_store.
+//
+// Each request carries the last committed cursor as `since=` and the last
+// ETag as If-None-Match, so an unchanged feed costs one 304 and a changed one
+// only the delta. The body is streamed through reminder_feed in fixed chunks
+// and applied as it arrives; the table is committed (with the new cursor) only
+// when the whole document parsed, otherwise it is reverted from NVS.
+//
+// tools/reminder_feed_server.py is a local stand-in that can serve large,
+// slow and malformed feeds.
+
+// Endpoint, e.g. "http://192.168.1.10:8080/feed". Empty disables sync.
+#ifndef REMINDER_SYNC_URL
+#define REMINDER_SYNC_URL ""
+#endif
+
+#ifndef REMINDER_SYNC_PERIOD_S
+#define REMINDER_SYNC_PERIOD_S 900
+#endif
+
+// After a failed attempt.
+#ifndef REMINDER_SYNC_RETRY_S
+#define REMINDER_SYNC_RETRY_S 60
+#endif
+
+#ifndef REMINDER_SYNC_TIMEOUT_MS
+#define REMINDER_SYNC_TIMEOUT_MS 10000
+#endif
+
+// Bounds transfer time, not memory: RAM use does not depend on body size.
+#ifndef REMINDER_SYNC_MAX_BODY
+#define REMINDER_SYNC_MAX_BODY (4 * 1024 * 1024)
+#endif
+
+typedef enum {
+    REMINDER_SYNC_DISABLED,
+    REMINDER_SYNC_UNCHANGED,   // 304
+    REMINDER_SYNC_APPLIED,
+    REMINDER_SYNC_FAILED,
+} reminder_sync_status_t;
+
+typedef struct {
+    reminder_sync_status_t status;
+    int http_status;
+    uint32_t body_bytes;
+    uint32_t duration_ms;
+    uint32_t upserts;
+    uint32_t deletes;
+    uint32_t swept;       // removed because a full snapshot did not list them
+    uint32_t rejected;
+    uint32_t dropped;
+} reminder_sync_report_t;
+
+bool reminder_sync_enabled(void);
+// Blocking; call from the network task while Wi-Fi is up.
+reminder_sync_status_t reminder_sync_run(reminder_sync_report_t *out);
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// Lock-free single-producer/single-consumer queue of fixed-size slots.
+// Exactly one task may push and exactly one task may pop; neither ever blocks.
+typedef struct {
+    uint8_t *slots;
+    size_t slot_size;
+    uint32_t mask;
+    atomic_uint head;   // next slot to write, owned by the producer
+    atomic_uint tail;   // next slot to read, owned by the consumer
+} spsc_queue_t;
+
+// capacity must be a power of two; storage must hold capacity * slot_size bytes.
+static inline bool spsc_queue_init(spsc_queue_t *q, void *storage, size_t slot_size, uint32_t capacity)
+{
+    if (!q || !storage || slot_size == 0 || capacity == 0 || (capacity & (capacity - 1)) != 0) {
+        return false;
+    }
+    q->slots = (uint8_t *)storage;
+    q->slot_size = slot_size;
+    q->mask = capacity - 1;
+    atomic_init(&q->head, 0);
+    atomic_init(&q->tail, 0);
+    return true;
+}
+
+static inline bool spsc_queue_push(spsc_queue_t *q, const void *item)
+{
+    unsigned head = atomic_load_explicit(&q->head, memory_order_relaxed);
+    unsigned tail = atomic_load_explicit(&q->tail, memory_order_acquire);
+    if (head - tail > q->mask) {
+        return false;
+    }
+    memcpy(q->slots + (size_t)(head & q->mask) * q->slot_size, item, q->slot_size);
+    atomic_store_explicit(&q->head, head + 1, memory_order_release);
+    return true;
+}
+
+static inline bool spsc_queue_pop(spsc_queue_t *q, void *item)
+{
+    unsigned tail = atomic_load_explicit(&q->tail, memory_order_relaxed);
+    unsigned head = atomic_load_explicit(&q->head, memory_order_acquire);
+    if (head == tail) {
+        return false;
+    }
+    memcpy(item, q->slots + (size_t)(tail & q->mask) * q->slot_size, q->slot_size);
+    atomic_store_explicit(&q->tail, tail + 1, memory_order_release);
+    return true;
+}
@@ -0,0 +1,191 @@
+#include "touch.h"
+
+#include "driver/gpio.h"
+#include "esp_log.h"
+#include "esp_sleep.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "i2c_bus.h"
+#include "panel_config.h"
+
+static const char *TAG = "touch";
+
+static cst816_t s_dev;
+static TaskHandle_t s_task = NULL;
+static touch_event_cb_t s_on_event = NULL;
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;   // s_irq_us, s_latest, s_stats
+static int64_t s_irq_us = 0;                                 // first INT since the last read, 0 if none
+static touch_sample_t s_latest;
+static touch_stats_t s_stats;
+
+static bool touch_bus_write_read(void *ctx, uint8_t addr, const uint8_t *wr, size_t wr_len, uint8_t *rd, size_t rd_len)
+{
+    (void)ctx;
+    return i2c_bus_write_read(I2C_BUS_CLIENT_TOUCH, addr, wr, wr_len, rd, rd_len) == ESP_OK;
+}
+
+static bool touch_bus_write(void *ctx, uint8_t addr, const uint8_t *data, size_t len)
+{
+    (void)ctx;
+    return i2c_bus_write(I2C_BUS_CLIENT_TOUCH, addr, data, len) == ESP_OK;
+}
+
+// Not in IRAM: the ISR service is installed without ESP_INTR_FLAG_IRAM. Level
+// interrupts re-fire while INT stays low, so the line is masked until the task
+// has read the controller.
+static void touch_isr(void *arg)
+{
+    (void)arg;
+    gpio_intr_disable(TOUCH_PIN_INT);
+    int64_t now_us = esp_timer_get_time();
+    portENTER_CRITICAL_ISR(&s_lock);
+    if (s_irq_us == 0) {
+        s_irq_us = now_us;
+    }
+    s_stats.irqs++;
+    portEXIT_CRITICAL_ISR(&s_lock);
+
+    BaseType_t woken = pdFALSE;
+    vTaskNotifyGiveFromISR(s_task, &woken);
+    if (woken) {
+        portYIELD_FROM_ISR();
+    }
+}
+
+static void touch_publish(const cst816_report_t *rep, int64_t irq_us, int64_t read_us)
+{
+    portENTER_CRITICAL(&s_lock);
+    s_latest.seq++;
+    s_latest.event = rep->event;
+    s_latest.x = rep->x;
+    s_latest.y = rep->y;
+    s_latest.irq_us = irq_us;
+    s_latest.read_us = read_us;
+    s_stats.events++;
+    portEXIT_CRITICAL(&s_lock);
+    if (s_on_event) {
+        s_on_event();
+    }
+}
+
+static void touch_task(void *arg)
+{
+    (void)arg;
+    while (1) {
+        TickType_t wait = s_dev.down ? pdMS_TO_TICKS(TOUCH_RELEASE_TIMEOUT_MS) : portMAX_DELAY;
+        if (ulTaskNotifyTake(pdTRUE, wait) == 0) {
+            cst816_report_t rep = cst816_force_release(&s_dev);
+            if (rep.event != CST816_EV_NONE) {
+                portENTER_CRITICAL(&s_lock);
+                s_stats.forced_releases++;
+                portEXIT_CRITICAL(&s_lock);
+                touch_publish(&rep, 0, esp_timer_get_time());
+            }
+            continue;
+        }
+
+        portENTER_CRITICAL(&s_lock);
+        int64_t irq_us = s_irq_us;
+        s_irq_us = 0;
+        portEXIT_CRITICAL(&s_lock);
+
+        cst816_report_t rep;
+        bool ok = cst816_read(&s_dev, &rep);
+        int64_t read_us = esp_timer_get_time();
+
+        portENTER_CRITICAL(&s_lock);
+        s_stats.reads = s_dev.reads;
+        s_stats.bus_errors = s_dev.bus_errors;
+        s_stats.out_of_range = s_dev.out_of_range;
+        if (ok && irq_us != 0) {
+            uint32_t lat_us = (uint32_t)(read_us - irq_us);
+            s_stats.irq_to_read_sum_us += lat_us;
+            if (lat_us > s_stats.irq_to_read_max_us) {
+                s_stats.irq_to_read_max_us = lat_us;
+            }
+        }
+        portEXIT_CRITICAL(&s_lock);
+
+        if (ok && rep.event != CST816_EV_NONE) {
+            touch_publish(&rep, irq_us, read_us);
+        }
+
+        // Rate cap before unmasking: a line held low would otherwise re-fire immediately.
+        if (gpio_get_level(TOUCH_PIN_INT) == 0) {
+            TickType_t ticks = pdMS_TO_TICKS(TOUCH_MIN_READ_INTERVAL_MS);
+            vTaskDelay(ticks > 0 ? ticks : 1);
+        }
+        gpio_intr_enable(TOUCH_PIN_INT);
+    }
+}
+
+bool touch_init(touch_event_cb_t on_event)
+{
+    static const cst816_bus_t bus = {
+        .write_read = touch_bus_write_read,
+        .write = touch_bus_write,
+    };
+    if (!cst816_init(&s_dev, &bus, LCD_H_RES, LCD_V_RES)) {
+        ESP_LOGW(TAG, "no controller at 0x%02x, touch disabled", CST816_ADDR);
+        return false;
+    }
+    s_on_event = on_event;
+
+    gpio_config_t io = {
+        .pin_bit_mask = 1ULL << TOUCH_PIN_INT,
+        .mode = GPIO_MODE_INPUT,
+        .pull_up_en = GPIO_PULLUP_ENABLE,
+        .intr_type = GPIO_INTR_LOW_LEVEL,
+    };
+    ESP_ERROR_CHECK(gpio_config(&io));
+
+    if (xTaskCreatePinnedToCore(touch_task, "touch", TOUCH_TASK_STACK, NULL,
+                                TOUCH_TASK_PRIO, &s_task, TOUCH_TASK_CORE) != pdPASS) {
+        ESP_LOGE(TAG, "task create failed");
+        return false;
+    }
+
+    esp_err_t err = gpio_install_isr_service(0);
+    if (err != ESP_OK && err != ESP_ERR_INVALID_STATE) {   // already installed is fine
+        ESP_ERROR_CHECK(err);
+    }
+    ESP_ERROR_CHECK(gpio_isr_handler_add(TOUCH_PIN_INT, touch_isr, NULL));
+
+    // A touch during auto light sleep wakes the chip instead of being missed until the next tick.
+    ESP_ERROR_CHECK(gpio_wakeup_enable(TOUCH_PIN_INT, GPIO_INTR_LOW_LEVEL));
+    ESP_ERROR_CHECK(esp_sleep_enable_gpio_wakeup());
+
+    ESP_LOGI(TAG, "CST816 id=0x%02x fw=%u, INT on GPIO%d", s_dev.chip_id, s_dev.fw_version, TOUCH_PIN_INT);
+    return true;
+}
+
+bool touch_get_latest(touch_sample_t *out)
+{
+    portENTER_CRITICAL(&s_lock);
+    *out = s_latest;
+    portEXIT_CRITICAL(&s_lock);
+    return out->seq != 0;
+}
+
+void touch_get_stats(touch_stats_t *out)
+{
+    portENTER_CRITICAL(&s_lock);
+    *out = s_stats;
+    portEXIT_CRITICAL(&s_lock);
+}
+
+void touch_log_stats(void)
+{
+    touch_stats_t st;
+    touch_get_stats(&st);
+    if (st.irqs == 0) {
+        return;
+    }
+    ESP_LOGI(TAG, "irqs=%u reads=%u events=%u bus_err=%u out_of_range=%u forced_up=%u "
+             "irq_to_read_avg_us=%u irq_to_read_max_us=%u",
+             (unsigned)st.irqs, (unsigned)st.reads, (unsigned)st.events, (unsigned)st.bus_errors,
+             (unsigned)st.out_of_range, (unsigned)st.forced_releases,
+             (unsigned)(st.reads ? st.irq_to_read_sum_us / st.reads : 0),
+             (unsigned)st.irq_to_read_max_us);
+}
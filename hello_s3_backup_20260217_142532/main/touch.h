@@ -0,0 +1,69 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "cst816.h"
+
+// Interrupt-driven touch input. The controller's INT line is a low-level GPIO
+// interrupt (also armed as a light-sleep wake source); the ISR only stamps the
+// time and wakes the touch task, which does one burst read over i2c_bus and
+// publishes the resulting event. While a finger is down INT pulses about every
+// 10 ms; reads are capped at one per TOUCH_MIN_READ_INTERVAL_MS so a stuck-low
+// line cannot crowd EXIO off the shared bus.
+
+#ifndef TOUCH_PIN_INT
+#define TOUCH_PIN_INT 4
+#endif
+
+#ifndef TOUCH_TASK_CORE
+#define TOUCH_TASK_CORE 0
+#endif
+
+// Above the clock task: a touch should be read before the next tick is composed.
+#ifndef TOUCH_TASK_PRIO
+#define TOUCH_TASK_PRIO 8
+#endif
+
+#ifndef TOUCH_TASK_STACK
+#define TOUCH_TASK_STACK 3072
+#endif
+
+#ifndef TOUCH_MIN_READ_INTERVAL_MS
+#define TOUCH_MIN_READ_INTERVAL_MS 10
+#endif
+
+// INT silent this long with a finger down: the lift report was lost.
+#ifndef TOUCH_RELEASE_TIMEOUT_MS
+#define TOUCH_RELEASE_TIMEOUT_MS 150
+#endif
+
+typedef struct {
+    uint32_t seq;            // bumps with every published event
+    cst816_event_t event;
+    uint16_t x;
+    uint16_t y;
+    int64_t irq_us;          // INT edge behind this event; 0 for a forced release
+    int64_t read_us;         // burst read completed
+} touch_sample_t;
+
+typedef struct {
+    uint32_t irqs;
+    uint32_t reads;
+    uint32_t events;
+    uint32_t bus_errors;
+    uint32_t out_of_range;
+    uint32_t forced_releases;
+    uint32_t irq_to_read_max_us;
+    uint64_t irq_to_read_sum_us;
+} touch_stats_t;
+
+// Called from the touch task after each published event.
+typedef void (*touch_event_cb_t)(void);
+
+// The controller must be out of reset; i2c_bus must be up.
+bool touch_init(touch_event_cb_t on_event);
+// Latest event; false before the first one.
+bool touch_get_latest(touch_sample_t *out);
+void touch_get_stats(touch_stats_t *out);
+void touch_log_stats(void);
@@ -0,0 +1,147 @@
+#!/usr/bin/env python3
+"""Decode deferred binary log records from the clock firmware.
+
+The firmware emits `#DL<core> <base64>` lines (see main/dlog.c). Each record is
+little-endian 32-bit words: format string address, timestamp in microseconds,
+argument count, then the raw arguments. Format strings and `%s` arguments are
+read from the application ELF, so it must be the exact image that produced the
+log. All other lines are passed through unchanged.
+
+    idf.py monitor | tee run.log
+    tools/dlog_decode.py build/hello_s3.elf run.log
+"""
+
+import argparse
+import base64
+import re
+import struct
+import sys
+
+SHF_ALLOC = 0x2
+SHT_NOBITS = 8
+
+DL_LINE = re.compile(r'#DL(?P<core>\d+) (?P<payload>[A-Za-z0-9+/=]+)')
+DROP_LINE = re.compile(r'#DLDROP (?P<core>\d+) (?P<count>\d+)')
+CONV = re.compile(r'%(?P<flags>[-+ #0]*)(?P<width>\d+)?(?P<prec>\.\d+)?(?:hh|h|ll|l|j|z|t)?(?P<conv>[diouxXcsp%])')
+
+
+class ElfStrings:
+    """Reads NUL-terminated strings at target addresses from loadable ELF32 sections."""
+
+    def __init__(self, path):
+        with open(path, 'rb') as f:
+            self.data = f.read()
+        if self.data[:4] != b'\x7fELF' or self.data[4] != 1:
+            raise ValueError('%s is not an ELF32 file' % path)
+        shoff, = struct.unpack_from('<I', self.data, 0x20)
+        shentsize, shnum = struct.unpack_from('<HH', self.data, 0x2E)
+        self.sections = []
+        for i in range(shnum):
+            (_, sh_type, sh_flags, sh_addr, sh_offset, sh_size) = struct.unpack_from(
+                '<IIIIII', self.data, shoff + i * shentsize)
+            if sh_flags & SHF_ALLOC and sh_type != SHT_NOBITS and sh_size:
+                self.sections.append((sh_addr, sh_size, sh_offset))
+        self.cache = {}
+
+    def string(self, addr):
+        if addr in self.cache:
+            return self.cache[addr]
+        for base, size, offset in self.sections:
+            if base <= addr < base + size:
+                start = offset + (addr - base)
+                end = self.data.find(b'\0', start, offset + size)
+                text = self.data[start:end if end >= 0 else offset + size].decode('utf-8', 'replace')
+                self.cache[addr] = text
+                return text
+        return None
+
+
+def render(fmt, args, strings):
+    out = []
+    pos = 0
+    it = iter(args)
+    for m in CONV.finditer(fmt):
+        out.append(fmt[pos:m.start()])
+        pos = m.end()
+        conv = m.group('conv')
+        if conv == '%':
+            out.append('%')
+            continue
+        spec = '%' + (m.group('flags') or '') + (m.group('width') or '') + (m.group('prec') or '')
+        value = next(it, None)
+        if value is None:
+            out.append('<missing>')
+            continue
+        if conv in 'di':
+            out.append((spec + 'd') % (value - (1 << 32) if value & 0x80000000 else value))
+        elif conv == 's':
+            text = strings.string(value)
+            out.append((spec + 's') % (text if text is not None else '<0x%08x>' % value))
+        elif conv == 'c':
+            out.append((spec + 'c') % chr(value & 0xFF))
+        elif conv == 'p':
+            out.append('0x%08x' % value)
+        else:
+            out.append((spec + conv) % value)
+    out.append(fmt[pos:])
+    return ''.join(out)
+
+
+def decode_payload(payload, core, strings, clocks):
+    raw = base64.b64decode(payload)
+    words = struct.unpack('<%dI' % (len(raw) // 4), raw[:len(raw) // 4 * 4])
+    i = 0
+    while i + 3 <= len(words):
+        fmt_addr, ts, nargs = words[i:i + 3]
+        args = words[i + 3:i + 3 + nargs]
+        i += 3 + nargs
+
+        # Timestamps are the low 32 bits of esp_timer; unwrap per core.
+        last, epoch = clocks.get(core, (0, 0))
+        if ts < last:
+            epoch += 1 << 32
+        clocks[core] = (ts, epoch)
+        t_ms = (epoch + ts) / 1000.0
+
+        fmt = strings.string(fmt_addr)
+        text = render(fmt, args, strings) if fmt is not None else \
+            '<unknown fmt 0x%08x> %s' % (fmt_addr, ' '.join('0x%x' % a for a in args))
+        yield 'D (%.3f) [core %d] %s' % (t_ms, core, text)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument('elf', help='application ELF that produced the log')
+    parser.add_argument('log', nargs='?', default='-', help='monitor log (default: stdin)')
+    parser.add_argument('--only', action='store_true', help='print decoded records only')
+    args = parser.parse_args()
+
+    strings = ElfStrings(args.elf)
+    stream = sys.stdin if args.log == '-' else open(args.log, encoding='utf-8', errors='replace')
+    clocks = {}
+    records = {}
+    dropped = {}
+    with stream:
+        for line in stream:
+            m = DL_LINE.search(line)
+            if m:
+                core = int(m.group('core'))
+                for text in decode_payload(m.group('payload'), core, strings, clocks):
+                    records[core] = records.get(core, 0) + 1
+                    print(text)
+                continue
+            m = DROP_LINE.search(line)
+            if m:
+                dropped[int(m.group('core'))] = int(m.group('count'))
+                continue
+            if not args.only:
+                sys.stdout.write(line)
+
+    for core in sorted(set(records) | set(dropped)):
+        print('dlog core %d: %d records decoded, %d dropped on device'
+              % (core, records.get(core, 0), dropped.get(core, 0)), file=sys.stderr)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
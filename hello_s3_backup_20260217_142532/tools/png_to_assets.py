@@ -0,0 +1,340 @@
+#!/usr/bin/env python3
+"""Pack PNG images into the clock's "assets" partition image.
+
+Each PNG becomes one asset named after its file stem (at most 15 chars).
+Small images are stored as RGB565 big-endian rows, which is what the panel
+takes with LCD_RGB_DATA_ENDIAN_BIG, and are copied straight to it. Images of
+at least --compress-min bytes are stored as Q565 (main/q565.h) when that is
+smaller and decoded band by band on the device; full-panel images drop the
+corners outside the round glass. All colour work happens here: alpha is
+composited onto --bg and every pixel is rounded to 565 once.
+
+Layout (little-endian, see main/assets.h):
+  header   "CLKA", u16 version, u16 count, u32 image_bytes
+  entries  count x {char name[16], u16 width, u16 height, u32 offset,
+                    u32 bytes, u8 encoding, 3 pad}
+  data     per entry, 4-byte aligned
+
+Uses only the standard library: 8-bit greyscale/RGB/RGBA/grey+alpha and
+1/2/4/8-bit palette PNGs, non-interlaced.
+
+  tools/png_to_assets.py -o build/assets.bin assets/*.png
+  parttool.py write_partition --partition-name assets --input build/assets.bin
+"""
+
+import argparse
+import math
+import os
+import struct
+import sys
+import zlib
+
+MAGIC = b'CLKA'
+VERSION = 2
+NAME_LEN = 16
+HEADER = struct.Struct('<4sHHI')
+ENTRY = struct.Struct('<16sHHIIB3x')
+ENCODING_RAW = 0
+ENCODING_Q565 = 1
+ENCODING_NAMES = {ENCODING_RAW: 'raw', ENCODING_Q565: 'q565'}
+PANEL_SIZE = 360            # LCD_H_RES / LCD_V_RES in main/panel_config.h
+COMPRESS_MIN_BYTES = 16 * 1024
+ALIGN = 4
+PNG_SIGNATURE = b'\x89PNG\r\n\x1a\n'
+# Must match the "assets" row of partitions.csv.
+PARTITION_BYTES = 4 * 1024 * 1024
+
+
+def _paeth(a, b, c):
+    p = a + b - c
+    pa, pb, pc = abs(p - a), abs(p - b), abs(p - c)
+    if pa <= pb and pa <= pc:
+        return a
+    return b if pb <= pc else c
+
+
+def _unfilter(raw, width, height, bpp, stride):
+    rows = []
+    prev = bytearray(stride)
+    pos = 0
+    for _ in range(height):
+        ftype = raw[pos]
+        line = bytearray(raw[pos + 1:pos + 1 + stride])
+        pos += 1 + stride
+        for i in range(stride):
+            left = line[i - bpp] if i >= bpp else 0
+            up = prev[i]
+            if ftype == 1:
+                line[i] = (line[i] + left) & 0xFF
+            elif ftype == 2:
+                line[i] = (line[i] + up) & 0xFF
+            elif ftype == 3:
+                line[i] = (line[i] + ((left + up) >> 1)) & 0xFF
+            elif ftype == 4:
+                upleft = prev[i - bpp] if i >= bpp else 0
+                line[i] = (line[i] + _paeth(left, up, upleft)) & 0xFF
+            elif ftype != 0:
+                raise ValueError('bad filter type %d' % ftype)
+        rows.append(line)
+        prev = line
+    return rows
+
+
+def read_png(path):
+    """Returns (width, height, [(r, g, b, a), ...]) in row-major order."""
+    with open(path, 'rb') as f:
+        data = f.read()
+    if data[:8] != PNG_SIGNATURE:
+        raise ValueError('%s: not a PNG' % path)
+
+    pos = 8
+    idat = bytearray()
+    palette = []
+    trns = b''
+    ihdr = None
+    while pos < len(data):
+        length, ctype = struct.unpack('>I4s', data[pos:pos + 8])
+        body = data[pos + 8:pos + 8 + length]
+        pos += 12 + length
+        if ctype == b'IHDR':
+            ihdr = struct.unpack('>IIBBBBB', body)
+        elif ctype == b'PLTE':
+            palette = [tuple(body[i:i + 3]) for i in range(0, len(body), 3)]
+        elif ctype == b'tRNS':
+            trns = body
+        elif ctype == b'IDAT':
+            idat += body
+        elif ctype == b'IEND':
+            break
+    if ihdr is None:
+        raise ValueError('%s: missing IHDR' % path)
+
+    width, height, depth, color, _, _, interlace = ihdr
+    if interlace:
+        raise ValueError('%s: interlaced PNGs are not supported' % path)
+    channels = {0: 1, 2: 3, 3: 1, 4: 2, 6: 4}.get(color)
+    if channels is None or (color != 3 and depth != 8) or depth not in (1, 2, 4, 8):
+        raise ValueError('%s: unsupported colour type %d / depth %d' % (path, color, depth))
+
+    bits = channels * depth
+    stride = (width * bits + 7) // 8
+    rows = _unfilter(zlib.decompress(bytes(idat)), width, height, max(1, bits // 8), stride)
+
+    pixels = []
+    for line in rows:
+        for x in range(width):
+            if color == 3:
+                per_byte = 8 // depth
+                shift = (per_byte - 1 - x % per_byte) * depth
+                idx = (line[x // per_byte] >> shift) & ((1 << depth) - 1)
+                r, g, b = palette[idx]
+                a = trns[idx] if idx < len(trns) else 255
+            elif color == 0:
+                r = g = b = line[x]
+                a = 255
+            elif color == 4:
+                r = g = b = line[2 * x]
+                a = line[2 * x + 1]
+            elif color == 2:
+                r, g, b = line[3 * x:3 * x + 3]
+                a = 255
+            else:
+                r, g, b, a = line[4 * x:4 * x + 4]
+            pixels.append((r, g, b, a))
+    return width, height, pixels
+
+
+def to_rgb565(pixels, bg):
+    """Native RGB565 values, alpha composited onto bg."""
+    out = []
+    br, bgg, bb = bg
+    for r, g, b, a in pixels:
+        if a != 255:
+            r = (r * a + br * (255 - a) + 127) // 255
+            g = (g * a + bgg * (255 - a) + 127) // 255
+            b = (b * a + bb * (255 - a) + 127) // 255
+        # Same rounding as rgb565_be() in main/panel_config.h: truncate to 5/6/5 bits.
+        out.append(((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3))
+    return out
+
+
+def rgb565_be_bytes(values):
+    return struct.pack('>%dH' % len(values), *values)
+
+
+# --- Q565, see main/q565.h for the format; the C decoder is the reference. ---
+Q565_MAGIC = b'Q565'
+Q565_FLAG_ROUND = 0x01
+Q565_RUN_MAX = 62
+
+
+def q565_hash(c):
+    return (((c >> 11) & 31) * 3 + ((c >> 5) & 63) * 5 + (c & 31) * 7) & 63
+
+
+def q565_row_span(width, height, round_, y):
+    if not round_:
+        return 0, width
+    diameter = min(width, height)
+    dy = 2 * y + 1 - height
+    rem = diameter * diameter - dy * dy
+    if rem < 0:
+        return 0, 0
+    s = math.isqrt(rem)
+    lo = width - 1 - s
+    hi = width - 1 + s
+    return (0 if lo <= 0 else (lo + 1) // 2), min(width, hi // 2 + 1)
+
+
+def _wrap(d, bits):
+    m = 1 << bits
+    d &= m - 1
+    return d - m if d >= m // 2 else d
+
+
+def q565_encode(values, width, height, round_, outside):
+    out = bytearray(Q565_MAGIC)
+    out += struct.pack('<HHBBH', width, height, Q565_FLAG_ROUND if round_ else 0, 0, outside)
+    index = [0] * 64
+    prev = 0
+    run = 0
+    for y in range(height):
+        x0, x1 = q565_row_span(width, height, round_, y)
+        row = y * width
+        for x in range(x0, x1):
+            px = values[row + x]
+            if px == prev:
+                run += 1
+                if run == Q565_RUN_MAX:
+                    out.append(0xC0 | (run - 1))
+                    run = 0
+                continue
+            if run:
+                out.append(0xC0 | (run - 1))
+                run = 0
+            h = q565_hash(px)
+            if index[h] == px:
+                out.append(h)
+            else:
+                index[h] = px
+                dr = _wrap((px >> 11) - (prev >> 11), 5)
+                dg = _wrap(((px >> 5) & 63) - ((prev >> 5) & 63), 6)
+                db = _wrap((px & 31) - (prev & 31), 5)
+                half = dg // 2          # floor, same as q565_half()
+                drg = dr - half
+                dbg = db - half
+                if -2 <= dr <= 1 and -2 <= dg <= 1 and -2 <= db <= 1:
+                    out.append(0x40 | ((dr + 2) << 4) | ((dg + 2) << 2) | (db + 2))
+                elif -8 <= drg <= 7 and -8 <= dbg <= 7:
+                    out.append(0x80 | (dg + 32))
+                    out.append(((drg + 8) << 4) | (dbg + 8))
+                else:
+                    out.append(0xFE)
+                    out += struct.pack('>H', px)
+            prev = px
+    if run:
+        out.append(0xC0 | (run - 1))
+    return bytes(out)
+
+
+def encode_asset(values, w, h, bg565, compress_min, round_ok):
+    """Returns (encoding, data): Q565 when big enough and actually smaller, raw otherwise."""
+    raw = rgb565_be_bytes(values)
+    if compress_min is not None and len(raw) >= compress_min:
+        round_ = round_ok and w == PANEL_SIZE and h == PANEL_SIZE
+        packed = q565_encode(values, w, h, round_, bg565)
+        if len(packed) < len(raw):
+            return ENCODING_Q565, packed
+    return ENCODING_RAW, raw
+
+
+def pack(images):
+    """images: list of (name, width, height, encoding, data)."""
+    dir_end = HEADER.size + ENTRY.size * len(images)
+    offset = (dir_end + ALIGN - 1) // ALIGN * ALIGN
+    entries = bytearray()
+    blob = bytearray()
+    for name, w, h, encoding, data in images:
+        entries += ENTRY.pack(name.encode('ascii'), w, h, offset + len(blob), len(data), encoding)
+        blob += data
+        blob += b'\0' * (-len(blob) % ALIGN)
+    image_bytes = offset + len(blob)
+    return HEADER.pack(MAGIC, VERSION, len(images), image_bytes) + entries + \
+        b'\0' * (offset - dir_end) + blob
+
+
+def describe(path):
+    with open(path, 'rb') as f:
+        data = f.read()
+    magic, version, count, image_bytes = HEADER.unpack_from(data, 0)
+    if magic != MAGIC or version != VERSION:
+        raise ValueError('%s: not a v%d asset image' % (path, VERSION))
+    print('%s: %d assets, %d bytes' % (path, count, image_bytes))
+    for i in range(count):
+        name, w, h, off, size, encoding = ENTRY.unpack_from(data, HEADER.size + i * ENTRY.size)
+        print('  %-15s %4dx%-4d %-4s @0x%06x  %d bytes (%.1f%% of raw)' % (
+            name.rstrip(b'\0').decode(), w, h, ENCODING_NAMES.get(encoding, '?'), off, size,
+            100.0 * size / (w * h * 2)))
+
+
+def parse_bg(text):
+    text = text.lstrip('#')
+    if len(text) != 6:
+        raise argparse.ArgumentTypeError('expected RRGGBB')
+    return tuple(int(text[i:i + 2], 16) for i in (0, 2, 4))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument('png', nargs='*', help='input images; asset name is the file stem')
+    parser.add_argument('-o', '--output', help='partition image to write')
+    parser.add_argument('--bg', type=parse_bg, default=(0, 0, 0),
+                        help='RRGGBB that transparent pixels are composited onto (default 000000)')
+    parser.add_argument('--compress-min', type=int, default=COMPRESS_MIN_BYTES, metavar='BYTES',
+                        help='Q565-encode images of at least this many raw bytes (default %(default)s)')
+    parser.add_argument('--raw', action='store_true', help='store every image uncompressed')
+    parser.add_argument('--square', action='store_true',
+                        help='keep the corners of full-panel images instead of dropping them')
+    parser.add_argument('--describe', metavar='BIN', help='print the directory of an existing image')
+    args = parser.parse_args()
+
+    if args.describe:
+        describe(args.describe)
+        return 0
+    if not args.output or not args.png:
+        parser.error('need -o and at least one PNG')
+
+    images = []
+    seen = set()
+    for path in sorted(args.png):
+        name = os.path.splitext(os.path.basename(path))[0]
+        if len(name) >= NAME_LEN or not name.isascii():
+            parser.error('%s: asset name must be ASCII and under %d chars' % (path, NAME_LEN))
+        if name in seen:
+            parser.error('duplicate asset name %s' % name)
+        seen.add(name)
+        w, h, pixels = read_png(path)
+        if w > 0xFFFF or h > 0xFFFF:
+            parser.error('%s: too large' % path)
+        br, bgg, bb = args.bg
+        bg565 = ((br & 0xF8) << 8) | ((bgg & 0xFC) << 3) | (bb >> 3)
+        encoding, data = encode_asset(to_rgb565(pixels, args.bg), w, h, bg565,
+                                      None if args.raw else args.compress_min, not args.square)
+        images.append((name, w, h, encoding, data))
+
+    image = pack(images)
+    if len(image) > PARTITION_BYTES:
+        print('error: %d bytes does not fit the %d byte partition' % (len(image), PARTITION_BYTES),
+              file=sys.stderr)
+        return 1
+    os.makedirs(os.path.dirname(os.path.abspath(args.output)), exist_ok=True)
+    with open(args.output, 'wb') as f:
+        f.write(image)
+    for name, w, h, encoding, data in images:
+        print('%-15s %4dx%-4d %-4s %7d bytes' % (name, w, h, ENCODING_NAMES[encoding], len(data)))
+    print('%s: %d assets, %d bytes' % (args.output, len(images), len(image)))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,85 @@
+#!/usr/bin/env python3
+"""Average-current model for the clock firmware.
+
+Reads `idf.py monitor` output, picks up the periodic
+`pm: ticks=.. active_avg_us=.. active_max_us=.. duty_ppm=.. est_ua=..` lines
+and re-evaluates the two-state current model (active vs. light sleep) with
+board-specific currents. With --baseline the result is compared against a
+stored JSON summary and the script exits non-zero on a regression.
+"""
+
+import argparse
+import json
+import re
+import sys
+
+PM_LINE = re.compile(
+    r'pm: ticks=(?P<ticks>\d+) active_avg_us=(?P<avg>-?\d+) active_max_us=(?P<max>-?\d+) '
+    r'duty_ppm=(?P<duty>-?\d+) est_ua=(?P<est>-?\d+)')
+
+# Same defaults as PM_EST_ACTIVE_MA / PM_EST_SLEEP_MA in main/main.c.
+DEFAULT_ACTIVE_MA = 45.0
+DEFAULT_SLEEP_MA = 3.0
+
+
+def parse(stream):
+    windows = []
+    for line in stream:
+        m = PM_LINE.search(line)
+        if m:
+            windows.append({k: int(v) for k, v in m.groupdict().items()})
+    return windows
+
+
+def summarize(windows, active_ma, sleep_ma):
+    ticks = sum(w['ticks'] for w in windows)
+    duty = sum(w['duty'] * w['ticks'] for w in windows) / ticks / 1e6
+    return {
+        'windows': len(windows),
+        'ticks': ticks,
+        'duty_pct': round(duty * 100.0, 3),
+        'active_avg_us': round(sum(w['avg'] * w['ticks'] for w in windows) / ticks, 1),
+        'active_max_us': max(w['max'] for w in windows),
+        'avg_current_ma': round(sleep_ma + (active_ma - sleep_ma) * duty, 3),
+    }
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument('log', nargs='?', default='-', help='monitor log file (default: stdin)')
+    parser.add_argument('--active-ma', type=float, default=DEFAULT_ACTIVE_MA)
+    parser.add_argument('--sleep-ma', type=float, default=DEFAULT_SLEEP_MA)
+    parser.add_argument('--baseline', help='JSON summary to compare against')
+    parser.add_argument('--tolerance', type=float, default=0.10,
+                        help='allowed relative increase of avg current (default: 0.10)')
+    parser.add_argument('--write-baseline', help='store the summary as a new baseline')
+    args = parser.parse_args()
+
+    stream = sys.stdin if args.log == '-' else open(args.log, encoding='utf-8', errors='replace')
+    with stream:
+        windows = parse(stream)
+    if not windows:
+        print('no pm lines found', file=sys.stderr)
+        return 2
+
+    summary = summarize(windows, args.active_ma, args.sleep_ma)
+    print(json.dumps(summary, indent=2))
+
+    if args.write_baseline:
+        with open(args.write_baseline, 'w', encoding='utf-8') as f:
+            json.dump(summary, f, indent=2)
+            f.write('\n')
+
+    if args.baseline:
+        with open(args.baseline, encoding='utf-8') as f:
+            base = json.load(f)
+        limit = base['avg_current_ma'] * (1.0 + args.tolerance)
+        if summary['avg_current_ma'] > limit:
+            print('REGRESSION: %.3f mA > %.3f mA (baseline %.3f mA)'
+                  % (summary['avg_current_ma'], limit, base['avg_current_ma']), file=sys.stderr)
+            return 1
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,218 @@
+#!/usr/bin/env python3
+"""Local stand-in for the reminder feed endpoint.
+
+Serves `GET /feed?since=<cursor>` in the format main/reminder_feed.h expects,
+with ETag / If-None-Match, so the firmware's incremental sync can be exercised
+without a real backend. Point REMINDER_SYNC_URL at http://<host>:<port>/feed.
+
+Besides well-formed deltas it can serve large snapshots, slow drips and a range
+of broken responses; the device must keep its last committed table and cursor
+for every broken one. `--mode cycle` rotates through all modes per request.
+
+    tools/reminder_feed_server.py --port 8080 --churn 3
+    tools/reminder_feed_server.py --mode large --large-records 50000
+    tools/reminder_feed_server.py --mode cycle
+"""
+
+import argparse
+import json
+import random
+import sys
+import threading
+import time
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+from urllib.parse import parse_qs, urlparse
+
+MODES = ['ok', 'large', 'slow', 'truncated', 'garbage', 'badjson', 'deep', 'longstring',
+         'notobject', 'error500']
+
+WORDS = ['Stand-up', 'Pills', 'Call "mum"', 'Café', 'Bins out', 'Gym/run', 'Water plants',
+         'Pick up kids', 'Rent', '日本語のメモ', 'Emoji \U0001F600 check']
+
+
+class FeedState:
+    """Reminders plus a change log; the cursor is the log version."""
+
+    def __init__(self, count, seed):
+        self.lock = threading.Lock()
+        self.rng = random.Random(seed)
+        self.version = 0
+        self.next_id = 1
+        self.records = {}
+        self.log = []   # (version, id)
+        for _ in range(count):
+            self._add()
+
+    def _record(self, rid):
+        return {
+            'id': rid,
+            'at': '%02d:%02d' % (self.rng.randrange(24), self.rng.randrange(60)),
+            'days': self.rng.choice([0x7F, 0x3E, 0x41, 1 << self.rng.randrange(7)]),
+            'text': '%s #%d' % (self.rng.choice(WORDS), rid),
+        }
+
+    def _add(self):
+        self.version += 1
+        rid = self.next_id
+        self.next_id += 1
+        self.records[rid] = self._record(rid)
+        self.log.append((self.version, rid))
+
+    def churn(self, n):
+        with self.lock:
+            for _ in range(n):
+                op = self.rng.random()
+                if op < 0.4 or not self.records:
+                    self._add()
+                    continue
+                self.version += 1
+                rid = self.rng.choice(list(self.records))
+                if op < 0.8:
+                    self.records[rid] = self._record(rid)
+                else:
+                    del self.records[rid]
+                self.log.append((self.version, rid))
+
+    def feed(self, since):
+        """Returns (document, etag). Unknown or missing cursors get a full snapshot."""
+        with self.lock:
+            full = since is None or since > self.version or since < 0
+            if full:
+                entries = [self.records[r] for r in sorted(self.records)]
+            else:
+                changed = sorted({rid for v, rid in self.log if v > since})
+                entries = [self.records.get(r, {'id': r, 'deleted': True}) for r in changed]
+            doc = {'cursor': str(self.version), 'full': full, 'reminders': entries}
+            return doc, '"v%d"' % self.version
+
+
+def big_snapshot(state, n):
+    doc, etag = state.feed(None)
+    rng = random.Random(n)
+    extra = [{'id': 1000000 + i, 'at': '%02d:%02d' % (rng.randrange(24), rng.randrange(60)),
+              'text': 'bulk %d %s' % (i, rng.choice(WORDS)),
+              'meta': {'rev': i, 'tags': ['x', i, None, True]}} for i in range(n)]
+    doc['reminders'] = doc['reminders'] + extra
+    return doc, etag
+
+
+class Handler(BaseHTTPRequestHandler):
+    protocol_version = 'HTTP/1.1'
+    server_version = 'reminder-feed-stand-in/1'
+
+    def log_message(self, fmt, *args):
+        sys.stderr.write('%s %s\n' % (time.strftime('%H:%M:%S'), fmt % args))
+
+    def _send(self, status, body, etag=None, content_type='application/json', length=None):
+        self.send_response(status)
+        self.send_header('Content-Type', content_type)
+        self.send_header('Content-Length', str(len(body) if length is None else length))
+        if etag:
+            self.send_header('ETag', etag)
+        self.end_headers()
+
+    def do_GET(self):
+        cfg = self.server.cfg
+        url = urlparse(self.path)
+        if url.path != '/feed':
+            self._send(404, b'')
+            return
+
+        with cfg['lock']:
+            mode = cfg['mode']
+            if mode == 'cycle':
+                mode = MODES[cfg['served'] % len(MODES)]
+            cfg['served'] += 1
+        if cfg['churn']:
+            self.server.state.churn(cfg['churn'])
+
+        since = parse_qs(url.query).get('since', [None])[0]
+        try:
+            since = int(since) if since is not None else None
+        except ValueError:
+            since = None
+
+        if mode == 'large':
+            doc, etag = big_snapshot(self.server.state, cfg['large_records'])
+        else:
+            doc, etag = self.server.state.feed(since)
+        if mode == 'ok' and self.headers.get('If-None-Match') == etag:
+            self._send(304, b'', etag=etag, length=0)
+            self.log_message('304 since=%s', since)
+            return
+
+        body = json.dumps(doc, ensure_ascii=bool(self.server.rng.getrandbits(1))).encode()
+        status = 200
+        if mode == 'garbage':
+            body, etag = b'<html><body>502 Bad Gateway</body></html>', None
+        elif mode == 'badjson':
+            cut = self.server.rng.randrange(1, len(body) - 1)
+            body = body[:cut] + b'\x01' + body[cut + 1:]
+        elif mode == 'deep':
+            body = b'{"reminders":' + b'[' * 64 + b']' * 64 + b'}'
+        elif mode == 'longstring':
+            body = b'{"cursor":"' + b'x' * (1 << 20) + b'","reminders":[{"id":1,"at":"07:00","text":"' + \
+                   b'y' * (1 << 20) + b'"}]'   # missing closing brace
+        elif mode == 'notobject':
+            body = json.dumps(doc['reminders']).encode()
+        elif mode == 'error500':
+            self._send(500, b'boom', content_type='text/plain')
+            self.wfile.write(b'boom')
+            self.log_message('500')
+            return
+
+        if mode == 'truncated':
+            # Promise the whole body, deliver half, then drop the connection.
+            self._send(status, body, etag=etag)
+            self.wfile.write(body[:len(body) // 2])
+            self.wfile.flush()
+            self.close_connection = True
+            self.log_message('200 %s: %d of %d B', mode, len(body) // 2, len(body))
+            return
+
+        self._send(status, body, etag=etag)
+        if mode == 'slow':
+            for i in range(0, len(body), cfg['drip_bytes']):
+                self.wfile.write(body[i:i + cfg['drip_bytes']])
+                self.wfile.flush()
+                time.sleep(cfg['drip_ms'] / 1000.0)
+        else:
+            self.wfile.write(body)
+        self.log_message('200 %s since=%s: %d B, %d records', mode, since, len(body),
+                         len(doc.get('reminders', [])) if isinstance(doc, dict) else 0)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument('--host', default='0.0.0.0')
+    parser.add_argument('--port', type=int, default=8080)
+    parser.add_argument('--mode', choices=MODES + ['cycle'], default='ok')
+    parser.add_argument('--records', type=int, default=12, help='reminders at start')
+    parser.add_argument('--churn', type=int, default=0, help='random edits applied per request')
+    parser.add_argument('--large-records', type=int, default=20000, help='extra records in --mode large')
+    parser.add_argument('--drip-bytes', type=int, default=64)
+    parser.add_argument('--drip-ms', type=int, default=20)
+    parser.add_argument('--seed', type=int, default=1)
+    args = parser.parse_args()
+
+    server = ThreadingHTTPServer((args.host, args.port), Handler)
+    server.state = FeedState(args.records, args.seed)
+    server.rng = random.Random(args.seed)
+    server.cfg = {
+        'lock': threading.Lock(),
+        'mode': args.mode,
+        'served': 0,
+        'churn': args.churn,
+        'large_records': args.large_records,
+        'drip_bytes': args.drip_bytes,
+        'drip_ms': args.drip_ms,
+    }
+    print('serving reminder feed on http://%s:%d/feed (mode %s)' % (args.host, args.port, args.mode))
+    try:
+        server.serve_forever()
+    except KeyboardInterrupt:
+        pass
+
+
+if __name__ == '__main__':
+    main()